@@ -18,8 +18,10 @@ COMMON_CPP := \
 ENGINE_CPP :=  \
     $(ROOT_PATH)/core/src/engine/Engine.cpp                \
     $(ROOT_PATH)/core/src/engine/Entity.cpp                \
+    $(ROOT_PATH)/core/src/engine/LooseOctree.cpp           \
     $(ROOT_PATH)/core/src/engine/Scene.cpp                 \
-    $(ROOT_PATH)/core/src/engine/TransformComponent.cpp
+    $(ROOT_PATH)/core/src/engine/TransformComponent.cpp    \
+    $(ROOT_PATH)/core/src/engine/TransformPool.cpp
 
 GEO_ENGINE_CPP := \
     $(ROOT_PATH)/core/src/engine/geo/GeoEngine.cpp          \
@@ -27,17 +29,28 @@ GEO_ENGINE_CPP := \
     $(ROOT_PATH)/core/src/engine/geo/Poi.cpp				\
     $(ROOT_PATH)/core/src/engine/geo/PoiFactory.cpp         \
     $(ROOT_PATH)/core/src/engine/geo/GeoSceneManager.cpp    \
+    $(ROOT_PATH)/core/src/engine/geo/GroundMesh.cpp         \
     $(ROOT_PATH)/core/src/engine/geo/Tile.cpp               \
-    $(ROOT_PATH)/core/src/engine/geo/TileMap.cpp
+    $(ROOT_PATH)/core/src/engine/geo/TileGrid.cpp           \
+    $(ROOT_PATH)/core/src/engine/geo/TileMap.cpp            \
+    $(ROOT_PATH)/core/src/engine/geo/TilePackProvider.cpp   \
+    $(ROOT_PATH)/core/src/engine/geo/TileRequestManager.cpp \
+    $(ROOT_PATH)/core/src/engine/geo/BackgroundTileProvider.cpp \
+    $(ROOT_PATH)/core/src/engine/geo/DirectoryTileSource.cpp \
+    $(ROOT_PATH)/core/src/engine/geo/PackTileSource.cpp
 
 ASYNC_CPP := \
-    $(ROOT_PATH)/core/src/async/TaskScheduler.cpp
+    $(ROOT_PATH)/core/src/async/TaskScheduler.cpp    \
+    $(ROOT_PATH)/core/src/async/ThreadPool.cpp
 
 RENDERING_CPP := \
+    $(ROOT_PATH)/core/src/rendering/BindingCache.cpp    \
     $(ROOT_PATH)/core/src/rendering/BoundingSphere.cpp  \
     $(ROOT_PATH)/core/src/rendering/Camera.cpp					\
     $(ROOT_PATH)/core/src/rendering/FlyThroughCamera.cpp        \
+    $(ROOT_PATH)/core/src/rendering/FramePacket.cpp             \
     $(ROOT_PATH)/core/src/rendering/Frustum.cpp                 \
+    $(ROOT_PATH)/core/src/rendering/GLStateCache.cpp            \
     $(ROOT_PATH)/core/src/rendering/HUDSystem.cpp               \
     $(ROOT_PATH)/core/src/rendering/HUDElement.cpp              \
     $(ROOT_PATH)/core/src/rendering/IndexBuffer.cpp       		\
@@ -45,6 +58,7 @@ RENDERING_CPP := \
     $(ROOT_PATH)/core/src/rendering/RenderingComponent.cpp    	\
     $(ROOT_PATH)/core/src/rendering/RenderingEngine.cpp   		\
     $(ROOT_PATH)/core/src/rendering/RenderingPackage.cpp  		\
+    $(ROOT_PATH)/core/src/rendering/RenderQueue.cpp       		\
     $(ROOT_PATH)/core/src/rendering/SkyBox.cpp  		        \
     $(ROOT_PATH)/core/src/rendering/Vertex.cpp            		\
     $(ROOT_PATH)/core/src/rendering/VertexBuffer.cpp
@@ -58,6 +72,7 @@ RESOURCE_CPP :=  \
    $(ROOT_PATH)/core/src/resource/Material.cpp        \
    $(ROOT_PATH)/core/src/resource/MaterialManager.cpp \
    $(ROOT_PATH)/core/src/resource/Mesh.cpp            \
+   $(ROOT_PATH)/core/src/resource/MeshFile.cpp        \
    $(ROOT_PATH)/core/src/resource/MeshManager.cpp     \
    $(ROOT_PATH)/core/src/resource/Pass.cpp            \
    $(ROOT_PATH)/core/src/resource/Quad.cpp            \
@@ -67,16 +82,24 @@ RESOURCE_CPP :=  \
    $(ROOT_PATH)/core/src/resource/ShaderProgram.cpp   \
    $(ROOT_PATH)/core/src/resource/Texture.cpp         \
    $(ROOT_PATH)/core/src/resource/MapManager.cpp      \
+   $(ROOT_PATH)/core/src/resource/MapLoader.cpp       \
+   $(ROOT_PATH)/core/src/resource/TileCache.cpp       \
+   $(ROOT_PATH)/core/src/resource/TextureAtlas.cpp    \
+   $(ROOT_PATH)/core/src/resource/RawImage.cpp        \
+   $(ROOT_PATH)/core/src/resource/TilePack.cpp        \
    $(ROOT_PATH)/core/src/resource/Watermark.cpp
 
 
 UTILS_CPP := \
    $(ROOT_PATH)/core/src/utils/GeoUtils.cpp             \
+   $(ROOT_PATH)/core/src/utils/GLExtensions.cpp         \
    $(ROOT_PATH)/core/src/utils/GeoSceneReader.cpp 		\
    $(ROOT_PATH)/core/src/utils/GLUtils.cpp 				\
    $(ROOT_PATH)/core/src/utils/MaterialReader.cpp 		\
    $(ROOT_PATH)/core/src/utils/ObjReader.cpp 			\
+   $(ROOT_PATH)/core/src/utils/ObjParser.cpp 			\
    $(ROOT_PATH)/core/src/utils/Utils.cpp 				\
+   utils/GLProcAddress.cpp 				\
    utils/Log.cpp
 
 
@@ -94,7 +117,7 @@ $(LOCAL_PATH)/$(ROOT_PATH)/third/rapidjson \
 $(LOCAL_PATH)/ndk-modules
 
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_C_INCLUDES)
-LOCAL_LDLIBS    := -llog -lGLESv2 -lz
+LOCAL_LDLIBS    := -llog -lEGL -lGLESv2 -lz
 LOCAL_STATIC_LIBRARIES := png
 
 LOCAL_SRC_FILES :=   \
@@ -109,6 +132,10 @@ LOCAL_SRC_FILES :=   \
     $(UTILS_CPP)
 
 LOCAL_CFLAGS    		:= -std=c++11 -fexceptions -Wall -Wno-comment -Wno-strict-aliasing #-Werror
+
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_ARM_NEON			:= true
+endif
 LOCAL_EXPORT_LDLIBS 	:= $(LOCAL_LDLIBS)
 
 ifeq ($(APP_OPTIM),debug)
@@ -28,11 +28,13 @@ namespace dma {
         //-----------------------------------------------------------------------------------------------
         JniGeoEngineCallbacks::JniGeoEngineCallbacks(JavaVM* javaVM, jobject listener,
                                                      jmethodID onTileRequest,
+                                                     jmethodID onTileCancel,
                                                      jmethodID onPoiSelected,
                                                      jmethodID onPoiDeselected) :
                 mJavaVM(javaVM),
                 mListener(listener),
                 mOnTileRequest(onTileRequest),
+                mOnTileCancel(onTileCancel),
                 mOnPoiSelected(onPoiSelected),
                 mOnPoiDeselected(onPoiDeselected)
         {
@@ -60,6 +62,17 @@ namespace dma {
         }
 
 
+        //-----------------------------------------------------------------------------------------------
+        void JniGeoEngineCallbacks::onTileCancel(int x, int y, int z) {
+
+            JNIEnv* env;
+            mJavaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
+            assert(env != nullptr); // should be called from the already attached OpenGL thread
+
+            env->CallVoidMethod(mListener, mOnTileCancel, x, y, z);
+        }
+
+
         //-----------------------------------------------------------------------------------------------
         void JniGeoEngineCallbacks::onPoiSelected(const std::string &sid) {
 
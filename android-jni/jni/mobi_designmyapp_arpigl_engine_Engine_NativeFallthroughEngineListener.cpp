@@ -43,6 +43,13 @@ JNIEXPORT jlong JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_00024NativeFa
         exit(-1);
     }
 
+    jmethodID onTileCancel = env->GetMethodID(javaclass, "onTileCancel", "(III)V");
+    assert(onTileCancel != 0);
+    if (onTileCancel == 0) {
+        Log::error(TAG, "Cannot get JNI Method with signature onTileCancel((III)V)");
+        exit(-1);
+    }
+
     jmethodID onPoiSelected = env->GetMethodID(javaclass, "onPoiSelected", "(Ljava/lang/String;)V");
     assert(onPoiSelected != 0);
     if (onPoiSelected == 0) {
@@ -59,7 +66,7 @@ JNIEXPORT jlong JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_00024NativeFa
 
     // Convert local to global reference
     caller = env->NewGlobalRef(caller);
-    JniGeoEngineCallbacks* callbacks = new JniGeoEngineCallbacks(jvm, caller, onTileRequest, onPoiSelected, onPoiDeselected);
+    JniGeoEngineCallbacks* callbacks = new JniGeoEngineCallbacks(jvm, caller, onTileRequest, onTileCancel, onPoiSelected, onPoiDeselected);
     return (long)callbacks;
 }
 
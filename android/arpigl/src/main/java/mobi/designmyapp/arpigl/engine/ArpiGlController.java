@@ -43,6 +43,7 @@ import mobi.designmyapp.arpigl.listener.EngineListener;
 import mobi.designmyapp.arpigl.listener.OrientationListener;
 import mobi.designmyapp.arpigl.listener.PoiEventListener;
 import mobi.designmyapp.arpigl.listener.PoiSelectionListener;
+import mobi.designmyapp.arpigl.listener.TileCancelListener;
 import mobi.designmyapp.arpigl.listener.TileEventListener;
 import mobi.designmyapp.arpigl.model.Poi;
 import mobi.designmyapp.arpigl.model.Tile;
@@ -498,7 +499,7 @@ public final class ArpiGlController implements Controller {
      *
      * @author Nicolas THIERION
      */
-    private class ControllerEngineListener implements EngineListener {
+    private class ControllerEngineListener implements EngineListener, TileCancelListener {
 
         @Override
         public void onTileRequest(int x, int y, int z) {
@@ -509,6 +510,15 @@ public final class ArpiGlController implements Controller {
             }
         }
 
+        @Override
+        public void onTileCancel(int x, int y, int z) {
+            synchronized (mLock) {
+                if (mTileProvider != null) {
+                    mTileProvider.cancel(new Tile.Id(x, y, z));
+                }
+            }
+        }
+
         @Override
         public void onPoiSelected(final String sid) {
             synchronized (mLock) {
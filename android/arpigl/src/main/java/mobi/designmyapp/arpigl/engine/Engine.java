@@ -28,6 +28,7 @@ import javax.microedition.khronos.opengles.GL10;
 import mobi.designmyapp.arpigl.ArpiGlInstaller;
 import mobi.designmyapp.arpigl.BuildConfig;
 import mobi.designmyapp.arpigl.listener.EngineListener;
+import mobi.designmyapp.arpigl.listener.TileCancelListener;
 import mobi.designmyapp.arpigl.model.Poi;
 
 /**
@@ -514,6 +515,23 @@ public final class Engine implements Controller {
             mainHandler.post(runnable);
         }
 
+        /**
+         * Called by the native engine. Forwarded if the wrapped listener is a {@link TileCancelListener}.
+         */
+        public void onTileCancel(final int x, final int y, final int z) {
+            // MAY DEADLOCK IF RUN IN THE NATIVE THREAD
+            final Handler mainHandler = new Handler(mContext.getMainLooper());
+            Runnable runnable = new Runnable() {
+                @Override
+                public void run() {
+                    if (mEngineListener instanceof TileCancelListener) {
+                        ((TileCancelListener) mEngineListener).onTileCancel(x, y, z);
+                    }
+                }
+            };
+            mainHandler.post(runnable);
+        }
+
         @Override
         public void onPoiSelected(final String sid) {
             // MAY DEADLOCK IF RUN IN THE NATIVE THREAD
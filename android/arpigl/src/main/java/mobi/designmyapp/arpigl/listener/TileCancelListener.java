@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package mobi.designmyapp.arpigl.listener;
+
+/**
+ * Optional companion of {@link EngineListener}: an EngineListener also
+ * implementing this interface is told of the tile requests the engine drops.
+ */
+public interface TileCancelListener {
+
+    /**
+     * Called when a tile requested through onTileRequest, and not available yet,
+     * is no longer needed: it left the map, or the namespace changed.
+     *
+     * @param x coord of the cancelled tile.
+     * @param y coord of the cancelled tile.
+     * @param z coord of the cancelled tile.
+     */
+    void onTileCancel(int x, int y, int z);
+
+}
@@ -49,6 +49,12 @@ public abstract class TileProvider {
 
     public abstract void fetch(Tile.Id tid);
 
+    /**
+     * Called for a fetched tile no longer needed by the engine. Does nothing by default.
+     */
+    public void cancel(Tile.Id tid) {
+    }
+
     public abstract String getNamespace();
 
     public void register(TileEventListener listener) {
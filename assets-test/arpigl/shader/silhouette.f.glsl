@@ -6,8 +6,14 @@ precision mediump float;
 #endif
 #endif
 
+#ifdef DMA_INSTANCING
+varying vec3 v_diffuse_color;
+#define DIFFUSE_COLOR v_diffuse_color
+#else
 uniform vec3 u_diffuse_color;
+#define DIFFUSE_COLOR u_diffuse_color
+#endif
 
 void main() {
-    gl_FragColor = vec4(u_diffuse_color, 1.0);
+    gl_FragColor = vec4(DIFFUSE_COLOR, 1.0);
 }
\ No newline at end of file
@@ -29,9 +29,16 @@ uniform sampler2D u_diffuse_map;
 uniform bool u_diffuse_map_enabled;
 
 uniform mat4 u_MV;
-uniform vec3 u_diffuse_color;
 uniform LightSource u_light0;
 
+#ifdef DMA_INSTANCING
+varying vec3 v_diffuse_color;
+#define DIFFUSE_COLOR v_diffuse_color
+#else
+uniform vec3 u_diffuse_color;
+#define DIFFUSE_COLOR u_diffuse_color
+#endif
+
 
 varying vec3 v_normal;
 varying vec2 v_uv;
@@ -42,8 +49,8 @@ vec3 scene_ambient = vec3(0.4, 0.4, 0.4);
 void main() {
 
     Material material = Material(
-      u_diffuse_color,
-      u_diffuse_color,
+      DIFFUSE_COLOR,
+      DIFFUSE_COLOR,
       vec3(0.5, 0.5, 0.5),
       32.0
     );
@@ -2,9 +2,22 @@ attribute vec3 a_position;
 attribute vec3 a_normal;
 attribute vec2 a_uv;
 
+#ifdef DMA_INSTANCING
+uniform mat4 u_V, u_P;
+#ifdef DMA_INSTANCE_ARRAYS
+attribute float a_instance_index;
+uniform mat4 u_instance_M[DMA_MAX_INSTANCES];
+uniform vec3 u_instance_color[DMA_MAX_INSTANCES];
+#else
+attribute mat4 a_instance_M;
+attribute vec3 a_instance_color;
+#endif
+varying vec3 v_diffuse_color;
+#else
 uniform mat4 u_MVP, u_MV;
 uniform mat3 u_N;
 uniform vec3 u_diffuse_color;
+#endif
 
 varying vec3 v_normal;
 varying vec2 v_uv;
@@ -14,8 +27,25 @@ varying vec4 v_eyePosition;
 void main() {
 
     vec4 position = vec4(a_position, 1.0);
+#ifdef DMA_INSTANCING
+#ifdef DMA_INSTANCE_ARRAYS
+    int i = int(a_instance_index);
+    mat4 MV = u_V * u_instance_M[i];
+    v_diffuse_color = u_instance_color[i];
+#else
+    mat4 MV = u_V * a_instance_M;
+    v_diffuse_color = a_instance_color;
+#endif
+    // POIs are only rotated, translated & uniformly scaled
+    mat3 N = mat3(MV[0].xyz, MV[1].xyz, MV[2].xyz);
+    v_eyePosition = MV * position;
+    v_normal = normalize(N * a_normal);
+    v_uv = a_uv;
+    gl_Position = u_P * v_eyePosition;
+#else
     v_eyePosition = u_MV * position;
     v_normal = normalize(u_N * a_normal);
     v_uv = a_uv;
     gl_Position = u_MVP * position;
+#endif
 }
\ No newline at end of file
@@ -1,12 +1,38 @@
 attribute vec3 a_position;
 attribute vec3 a_normal;
 
+#ifdef DMA_INSTANCING
+uniform mat4 u_V, u_P;
+#ifdef DMA_INSTANCE_ARRAYS
+attribute float a_instance_index;
+uniform mat4 u_instance_M[DMA_MAX_INSTANCES];
+uniform vec3 u_instance_color[DMA_MAX_INSTANCES];
+#else
+attribute mat4 a_instance_M;
+attribute vec3 a_instance_color;
+#endif
+varying vec3 v_diffuse_color;
+#else
 uniform mat4 u_MVP;
 uniform mat3 u_N;
 uniform vec3 u_diffuse_color;
+#endif
+// model space length of the stored positions' unit
+uniform float u_decode_scale;
 
 void main() {
-    vec3 normal = a_normal * 0.07;
+    vec3 normal = a_normal * (0.07 / u_decode_scale);
     vec4 pos = vec4(a_position + normal, 1.0);
+#ifdef DMA_INSTANCING
+#ifdef DMA_INSTANCE_ARRAYS
+    int i = int(a_instance_index);
+    gl_Position = u_P * u_V * u_instance_M[i] * pos;
+    v_diffuse_color = u_instance_color[i];
+#else
+    gl_Position = u_P * u_V * a_instance_M * pos;
+    v_diffuse_color = a_instance_color;
+#endif
+#else
     gl_Position = u_MVP * pos;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_THREADPOOL_HPP_
+#define _DMA_THREADPOOL_HPP_
+
+#include "common/Types.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Fixed set of worker threads running posted tasks in FIFO order.
+     */
+    class ThreadPool {
+
+    public:
+        /**
+         * Range [begin, end) of a parallelFor, run by the given worker.
+         */
+        typedef std::function<void(U32 worker, U32 begin, U32 end)> RangeTask;
+
+        explicit ThreadPool(U32 threadCount);
+        ThreadPool(const ThreadPool&) = delete;
+        void operator=(const ThreadPool&) = delete;
+
+        /**
+         * Joins the threads, dropping the tasks not started yet.
+         */
+        virtual ~ThreadPool();
+
+        void post(std::function<void()> task);
+
+        /**
+         * Splits [0, count) into getWorkerCount() contiguous ranges, runs them
+         * in parallel (the calling thread taking the first one) and waits for all of them.
+         * Workers are numbered from 0 to getWorkerCount() - 1, so that they can
+         * write to their own shard of the results without synchronization.
+         */
+        void parallelFor(U32 count, const RangeTask& task);
+
+        inline U32 getThreadCount() const { return (U32) mThreads.size(); }
+
+        /**
+         * The threads plus the caller of parallelFor.
+         */
+        inline U32 getWorkerCount() const { return getThreadCount() + 1; }
+
+    private:
+        void mRun();
+
+        std::vector<std::thread> mThreads;
+        std::list<std::function<void()>> mTasks;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        bool mStopped;
+    };
+}
+
+#endif //_DMA_THREADPOOL_HPP_
@@ -41,6 +41,8 @@
 #include "rendering/Camera.hpp"
 #include "Scene.hpp"
 #include "animation/AnimationSystem.hpp"
+#include "async/ThreadPool.hpp"
+#include "rendering/FramePacket.hpp"
 
 
 namespace dma {
@@ -105,6 +107,22 @@ namespace dma {
 
         virtual void setSurfaceSize(U32, U32);
 
+        /**
+         * Runs the entity updates & the culling of each step on threadCount
+         * worker threads besides the calling one, the GL submission staying on it.
+         * 0 (the default) to run everything on the calling thread.
+         */
+        void setUpdateThreadCount(U32 threadCount);
+
+        /**
+         * When enabled, each step simulates the next frame into a frame packet on
+         * a dedicated thread, while the calling thread submits the packet of the
+         * previous step. Frames are then displayed one step later. Disabled by default.
+         */
+        void setFramePacketsEnabled(bool enabled);
+
+        inline bool isFramePacketsEnabled() const { return mSimulationThread != nullptr; }
+
         /* ***
          * PUBLIC GETTERS
          */
@@ -129,6 +147,11 @@ namespace dma {
             return *mScene;
         }
 
+        //--------------------------------------------------------------------------
+        inline RenderingEngine& getRenderingEngine() const {
+            return *mRenderingEngine;
+        }
+
     private:
 
         void mUpdateFPS();
@@ -150,6 +173,13 @@ namespace dma {
         AnimationSystem* mAnimationSystem;
         /** is engine properly initialized. */
         bool mIsInit;
+        /** The workers of the scene update, nullptr if disabled */
+        ThreadPool* mUpdateThreadPool;
+        /** The thread building the frame packets, nullptr if disabled */
+        ThreadPool* mSimulationThread;
+        FramePacket mFramePackets[2];
+        /** The packet built by the previous step, to be submitted by the next one */
+        U32 mFrontPacket;
 
 #ifdef DEBUG
         void mAssertInit(const char* msg) const;
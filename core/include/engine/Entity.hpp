@@ -83,7 +83,7 @@ namespace dma {
              */
 
             virtual inline void translate(const glm::vec3& translation) {
-                mTransformComponent->translate(translation);
+                mTransformComponent.translate(translation);
             }
 
             /**
@@ -109,7 +109,7 @@ namespace dma {
              *               the rotation axis, must be normalized
              */
             virtual inline void rotate(float angle, const glm::vec3& axis) {
-                mTransformComponent->rotate(angle, axis);
+                mTransformComponent.rotate(angle, axis);
             }
 
             /**
@@ -119,7 +119,7 @@ namespace dma {
              *              the pitch angle to add, in degrees
              */
             virtual inline void pitch(float angle) {
-                mTransformComponent->pitch(angle);
+                mTransformComponent.pitch(angle);
             }
 
             /**
@@ -129,7 +129,7 @@ namespace dma {
              *              the yaw angle to add, in degrees
              */
             virtual inline void yaw(float angle) {
-                mTransformComponent->yaw(angle);
+                mTransformComponent.yaw(angle);
             }
 
             /**
@@ -139,12 +139,12 @@ namespace dma {
              *              the roll angle to add, in degrees
              */
             virtual inline void roll(float angle) {
-                mTransformComponent->roll(angle);
+                mTransformComponent.roll(angle);
             }
 
 
             virtual inline void setScale(const glm::vec3& scale) {
-                mTransformComponent->setScale(scale);
+                mTransformComponent.setScale(scale);
             }
 
             /* ***
@@ -157,7 +157,7 @@ namespace dma {
              * @return the transformation matrix.
              */
             inline const glm::mat4* getM() const {
-                return &mTransformComponent->getM();
+                return &mTransformComponent.getM();
             }
 
             /**
@@ -181,7 +181,7 @@ namespace dma {
             }
 
             virtual inline const glm::vec3& getPosition() const {
-                return mTransformComponent->getPosition();
+                return mTransformComponent.getPosition();
             }
 
             /* ***
@@ -207,11 +207,11 @@ namespace dma {
              *              position vector of this entity.
              */
             virtual inline void setPosition(const glm::vec3& position) {
-                mTransformComponent->setPosition(position);
+                mTransformComponent.setPosition(position);
             }
 
             inline void setOrientation(const glm::mat4& rotationMatrix) {
-                mTransformComponent->setOrientation(rotationMatrix);
+                mTransformComponent.setOrientation(rotationMatrix);
             }
 
             /**
@@ -225,17 +225,18 @@ namespace dma {
             void setMaterial(std::shared_ptr<Material>);
 
 
-            TransformComponent& getTransformComponent() { return *mTransformComponent; }
+            TransformComponent& getTransformComponent() { return mTransformComponent; }
             AnimationComponent* getAnimationComponent() { return mAnimationComponent; }
 
             void addAnimationComponent();
             /**
-             * Updates entity components
+             * Updates entity components. The transform itself is updated
+             * by the TransformPool pass of the scene.
              */
             virtual void update(float dt);
 
         protected:
-            TransformComponent* mTransformComponent;
+            TransformComponent mTransformComponent;
             RenderingComponent* mRenderingComponent;
             AnimationComponent* mAnimationComponent;
         };
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_LOOSEOCTREE_HPP_
+#define _DMA_LOOSEOCTREE_HPP_
+
+#include "common/Types.hpp"
+#include "rendering/Frustum.hpp"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+namespace dma {
+
+    class Entity;
+
+    /**
+     * Loose octree over world-space bounding spheres.
+     * Each node's bounds are twice its nominal size, so that an object is
+     * stored in the deepest node whose nominal cube holds its center and
+     * whose size is at least twice its radius, and can move within these
+     * loose bounds without being reinserted.
+     * The root grows (and the tree is rebuilt) when an object falls outside.
+     */
+    class LooseOctree {
+
+    public:
+        typedef U32 Handle;
+        static constexpr Handle INVALID_HANDLE = 0xFFFFFFFF;
+
+        /**
+         * Independent part of a query, see split().
+         */
+        struct QueryTask {
+            I32 node;
+            bool subtree;       // the whole subtree, or only the node's own objects
+            bool inside;        // the node is entirely inside the frustum
+        };
+
+        LooseOctree();
+        LooseOctree(const LooseOctree&) = delete;
+        void operator=(const LooseOctree&) = delete;
+        virtual ~LooseOctree();
+
+        Handle insert(Entity* entity, const glm::vec3& center, F32 radius);
+
+        /**
+         * Moves the object, only touching the tree if it left its node's loose bounds.
+         */
+        void update(Handle handle, const glm::vec3& center, F32 radius);
+
+        void remove(Handle handle);
+
+        void clear();
+
+        /**
+         * Appends the entities whose sphere intersects the frustum. Nodes entirely
+         * outside are skipped, nodes entirely inside are accepted without testing their objects.
+         */
+        void query(const Frustum& frustum, std::vector<Entity*>& result) const;
+
+        /**
+         * Splits a query into tasks: the nodes intersecting the frustum down to the
+         * given depth contribute their own objects, the subtrees below (or entirely
+         * inside) are left whole. Running all the tasks yields the same result as query().
+         */
+        void split(const Frustum& frustum, U32 depth, std::vector<QueryTask>& tasks) const;
+
+        /**
+         * Runs a task of split(). Const and free of shared scratch memory,
+         * so that tasks can run in parallel.
+         * @param visibility scratch memory of the caller
+         */
+        void query(const QueryTask& task, const Frustum& frustum,
+                   std::vector<Entity*>& result, std::vector<U8>& visibility) const;
+
+        inline U32 size() const { return mSize; }
+
+    private:
+        static constexpr U32 MAX_DEPTH = 10;
+        static constexpr F32 INITIAL_HALF_SIZE = 512.0f;
+        static constexpr I32 NO_NODE = -1;
+
+        struct Node {
+            glm::vec3 center;
+            F32 halfSize;       // nominal, the loose bounds being twice as large
+            I32 parent;
+            I32 children[8];
+            U32 depth;
+            U32 count;          // objects in the whole subtree
+            std::vector<Handle> objects;
+            // spheres of the objects, for the batch frustum tests
+            std::vector<F32> x, y, z, radius;
+        };
+
+        struct Object {
+            Entity* entity;     // nullptr once removed
+            glm::vec3 center;
+            F32 radius;
+            I32 node;
+            U32 slot;           // index in the node's objects
+        };
+
+        I32 mCreateNode(const glm::vec3& center, F32 halfSize, I32 parent, U32 depth);
+        void mLink(Handle handle);
+        void mUnlink(Handle handle);
+        bool mFitsRoot(const glm::vec3& center, F32 radius) const;
+        void mGrow(const glm::vec3& center, F32 radius);
+        void mSplit(I32 nodeIndex, const Frustum& frustum, U32 depth, std::vector<QueryTask>& tasks) const;
+        void mQuery(I32 nodeIndex, const Frustum& frustum,
+                    std::vector<Entity*>& result, std::vector<U8>& visibility) const;
+        void mTestObjects(I32 nodeIndex, const Frustum& frustum,
+                          std::vector<Entity*>& result, std::vector<U8>& visibility) const;
+        void mCollect(I32 nodeIndex, std::vector<Entity*>& result) const;
+
+        std::vector<Node> mNodes;
+        std::vector<Object> mObjects;
+        std::vector<Handle> mFreeHandles;
+        U32 mSize;
+        mutable std::vector<U8> mVisibility;
+    };
+}
+
+#endif //_DMA_LOOSEOCTREE_HPP_
@@ -19,7 +19,10 @@
 #define _DMA_SCENEMANAGER_HPP_
 
 #include "utils/ExceptionHandler.hpp"
+#include "async/ThreadPool.hpp"
 #include "engine/Entity.hpp"
+#include "engine/LooseOctree.hpp"
+#include "engine/TransformPool.hpp"
 #include "rendering/SkyBox.hpp"
 #include "rendering/RenderingEngine.hpp"
 #include "animation/AnimationSystem.hpp"
@@ -27,7 +30,8 @@
 #include <rendering/Selectable.hpp>
 #include "glm/glm.hpp"
 
-#include <set>
+#include <map>
+#include <vector>
 
 namespace dma {
 
@@ -73,11 +77,28 @@ namespace dma {
         /**
          * 1. Checks if an origin shift is necessary. (TODO)
          *
-         * 2. Determines whether an entity is potentially displayable
-         *    and if so supplies it's rendering packages to the rendering engine. (TODO)
+         * 2. Updates the entities, and moves those whose transform changed in the octree.
+         *
+         * 3. Supplies the rendering packages of the entities the octree finds
+         *    inside the camera frustum to the rendering engine.
          */
         void step(float dt);
 
+        /**
+         * Runs the entity updates and the culling of step() on the given pool,
+         * each worker subscribing to its own render queue shard.
+         * nullptr (the default) to run them on the calling thread.
+         */
+        void setThreadPool(ThreadPool* threadPool);
+
+        /**
+         * When enabled, removed entities are kept alive until releaseRemovedEntities(),
+         * since a frame packet being submitted may still refer to them.
+         */
+        void setDeferredRelease(bool enabled);
+
+        void releaseRemovedEntities();
+
         /**
          * Adds an Entity to the scene.
          * @return true if entity added, false if it already belongs to the Scene.
@@ -102,6 +123,22 @@ namespace dma {
         bool hasEntity(std::shared_ptr<Entity> entity) ;
 
     private:
+        /**
+         * Where a renderable entity is in the octree, and with which mesh
+         * its bounding sphere has been computed.
+         */
+        struct Placement {
+            LooseOctree::Handle handle;
+            const Mesh* mesh;
+            U32 index;          // in mEntityList
+        };
+
+        /** depth down to which a parallel culling is split into tasks */
+        static constexpr U32 CULLING_SPLIT_DEPTH = 3;
+
+        void mPlace(Entity& entity, Placement& placement);
+        void mParallelFor(U32 count, const ThreadPool::RangeTask& task);
+
         /* ***
          * ATTRIBUTES
          */
@@ -110,7 +147,19 @@ namespace dma {
         ResourceManager* mResourceManager;
         AnimationSystem* mAnimationSystem;
         RenderingEngine* mRenderingEngine;
-        std::set<std::shared_ptr<Entity>> mEntities;
+        std::map<std::shared_ptr<Entity>, Placement> mEntities;
+        /** the entities with their placement, to be split among the workers */
+        std::vector<std::pair<Entity*, Placement*>> mEntityList;
+        LooseOctree mOctree;
+        ThreadPool* mThreadPool;
+        // one per worker
+        std::vector<std::vector<Entity*>> mVisibleEntities;
+        /** entities to (re)place in the octree once the transforms are updated */
+        std::vector<std::vector<std::pair<Entity*, Placement*>>> mMovedEntities;
+        std::vector<std::vector<U8>> mVisibility;
+        std::vector<LooseOctree::QueryTask> mQueryTasks;
+        bool mDeferredRelease;
+        std::vector<std::shared_ptr<Entity>> mRemovedEntities;
         std::string mCurrentSkyboxSid = "default";
         bool mSkyboxEnabled = false;
     };
@@ -23,26 +23,38 @@
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
+#include "engine/TransformPool.hpp"
+
 namespace dma {
 
+        /**
+         * View over a slot of the default TransformPool.
+         */
         class TransformComponent {
 
         public:
-            TransformComponent();
+            /**
+             * @param manual true if the owner updates the transform itself,
+             *        so that the pool's update pass leaves it (and its dirty flag) alone.
+             */
+            explicit TransformComponent(bool manual = false);
             virtual ~TransformComponent();
 
-            inline const glm::mat4& getM() const { return mM; }
+            /**
+             * The reference stays valid as long as the component lives.
+             */
+            inline const glm::mat4& getM() const { return mChunk->M[mIndex]; }
 
-            inline const glm::vec3& getPosition() { return mPosition; }
+            inline const glm::vec3& getPosition() const { return mChunk->positions[mIndex]; }
             void setPosition(const glm::vec3& position);
 
             void translate(const glm::vec3& translation);
 
-            inline const glm::mat4 getOrientationMatrix() {
-                return glm::mat4_cast(mOrientation);
+            inline const glm::mat4 getOrientationMatrix() const {
+                return glm::mat4_cast(mChunk->orientations[mIndex]);
             }
-            inline const glm::quat& getOrientationQuat() {
-                return mOrientation;
+            inline const glm::quat& getOrientationQuat() const {
+                return mChunk->orientations[mIndex];
             }
             void setOrientation(const glm::quat& rotationQuat);
 
@@ -82,26 +94,30 @@ namespace dma {
             void setScale(const glm::vec3& scale);
 
             /**
-             * Updates the M matrix:
+             * Updates the M matrix right away, without waiting for the pool's pass:
              * => T * R * S if reverse is false
              * => S * R * T otherwise
              */
             void update(const bool reverse = false);
 
-            inline bool isDirty() { return mDirty; }
-            inline void setDirty(bool dirty) { mDirty = dirty; }
+            inline bool isDirty() const { return (mChunk->flags[mIndex] & TransformPool::DIRTY) != 0; }
+            inline void setDirty(bool dirty) {
+                if (dirty) {
+                    mChunk->flags[mIndex] |= (U8) TransformPool::DIRTY;
+                } else {
+                    mChunk->flags[mIndex] &= (U8) ~TransformPool::DIRTY;
+                }
+            }
 
         private:
             TransformComponent(const TransformComponent&) = delete;
             void operator=(const TransformComponent&) = delete;
 
             //FIELDS
-            glm::vec3 mPosition;
-            glm::quat mOrientation;
-            glm::vec3 mScale;
-            glm::mat4 mM;
-            /** indicates if we need to recalculate the matrix */
-            bool mDirty;
+            TransformPool::Handle mHandle;
+            /** chunks never move, so the slot is addressed directly */
+            TransformPool::Chunk* mChunk;
+            U32 mIndex;
         };
 }
 
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_TRANSFORMPOOL_HPP_
+#define _DMA_TRANSFORMPOOL_HPP_
+
+#define GLM_FORCE_CXX98
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "common/Types.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Contiguous storage of the transforms: positions, orientations, scales,
+     * cached M matrices and flags are kept in parallel arrays, so that the
+     * matrices of all the dirty transforms are recomputed in one linear pass.
+     * Storage is allocated by fixed-size chunks which never move, so that
+     * slots (and the M references handed to the renderer) stay valid until released.
+     */
+    class TransformPool {
+
+    public:
+        typedef U32 Handle;
+
+        static constexpr U32 CHUNK_SIZE = 256;
+
+        enum Flag {
+            ALLOCATED = 1 << 0,
+            DIRTY = 1 << 1,
+            /** M = S * R * T instead of T * R * S */
+            REVERSE = 1 << 2,
+            /** left out of update(), the owner handling its dirty flag itself */
+            MANUAL = 1 << 3
+        };
+
+        struct Chunk {
+            glm::vec3 positions[CHUNK_SIZE];
+            glm::quat orientations[CHUNK_SIZE];
+            glm::vec3 scales[CHUNK_SIZE];
+            glm::mat4 M[CHUNK_SIZE];
+            U8 flags[CHUNK_SIZE];
+        };
+
+        /**
+         * The pool used by the transform components.
+         */
+        static TransformPool& getDefault();
+
+        TransformPool();
+        TransformPool(const TransformPool&) = delete;
+        void operator=(const TransformPool&) = delete;
+        virtual ~TransformPool();
+
+        /**
+         * Allocates an identity transform, flagged dirty.
+         * Thread-safe.
+         */
+        Handle allocate(U8 flags = 0);
+
+        /**
+         * Thread-safe.
+         */
+        void release(Handle handle);
+
+        /**
+         * @return the chunk holding the slot, at index handle % CHUNK_SIZE.
+         * Valid until the pool is destroyed.
+         */
+        Chunk* getChunk(Handle handle);
+
+        /**
+         * Recomputes M for every dirty, non manual transform, and clears its dirty flag.
+         * @return the number of updated transforms
+         */
+        U32 update();
+
+        /**
+         * Same as above, restricted to the chunks [firstChunk, endChunk),
+         * so that disjoint ranges can be updated in parallel.
+         */
+        U32 update(U32 firstChunk, U32 endChunk);
+
+        U32 getChunkCount() const;
+
+        /**
+         * Recomputes M for a single slot.
+         */
+        static void updateSlot(Chunk& chunk, U32 index);
+
+        inline U32 size() const { return mSize; }
+
+    private:
+        std::vector<std::unique_ptr<Chunk>> mChunks;
+        std::vector<Handle> mFreeHandles;
+        /** first never allocated handle */
+        Handle mNext;
+        U32 mSize;
+        mutable std::mutex mMutex;
+    };
+}
+
+#endif //_DMA_TRANSFORMPOOL_HPP_
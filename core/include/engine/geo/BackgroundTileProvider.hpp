@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_BACKGROUNDTILEPROVIDER_HPP_
+#define _DMA_BACKGROUNDTILEPROVIDER_HPP_
+
+#include "common/Types.hpp"
+#include "engine/geo/ITileProvider.hpp"
+#include "engine/geo/ITileSource.hpp"
+#include "async/ThreadPool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dma {
+    namespace geo {
+
+        class GeoEngine;
+
+        /**
+         * Fetches the tiles of a namespace from a source on worker threads, with no
+         * round trip through the host. Each tile read is written to the map directory,
+         * and decoded into the raw cache if one is set (see ResourceManager::setDecodedTileDir),
+         * before GeoSceneManager::notifyTileAvailable is posted to the GL thread.
+         */
+        class BackgroundTileProvider : public ITileProvider {
+
+        public:
+            static constexpr U32 DEFAULT_THREAD_COUNT = 2;
+
+            struct Stats {
+                U32 fetched;
+                U32 failed;     // not in the source, or not a PNG file
+                U32 cancelled;  // before being written
+            };
+
+            BackgroundTileProvider(GeoEngine& engine, const std::string& ns,
+                                   std::shared_ptr<ITileSource> source,
+                                   U32 threadCount = DEFAULT_THREAD_COUNT);
+            BackgroundTileProvider(const BackgroundTileProvider&) = delete;
+            void operator=(const BackgroundTileProvider&) = delete;
+            virtual ~BackgroundTileProvider();
+
+            inline const std::string& getNamespace() const override {
+                return mNamespace;
+            }
+
+            void attach(ResourceManager& resourceManager) override;
+
+            void detach(ResourceManager& resourceManager) override;
+
+            void fetch(int x, int y, int z) override;
+
+            void cancel(int x, int y, int z) override;
+
+            Stats getStats() const;
+
+        private:
+            void mLoad(int x, int y, int z, U32 generation);
+
+            /**
+             * @return false if the fetch of the tile was cancelled meanwhile.
+             */
+            bool mIsCurrent(U64 key, U32 generation) const;
+
+            static Status mWriteFile(const std::string& filename, const std::vector<BYTE>& data);
+
+            GeoEngine& mEngine;
+            std::string mNamespace;
+            std::shared_ptr<ITileSource> mSource;
+            /** where the tile maps are looked up, set on attach */
+            std::string mMapDir, mDecodedTileDir;
+            /** fetch generation by tile key, as in MapLoader */
+            std::unordered_map<U64, U32> mPending;
+            U32 mGeneration;
+            Stats mStats;
+            mutable std::mutex mMutex;
+            // last, so that the workers are joined first
+            ThreadPool mThreadPool;
+        };
+    }
+}
+
+#endif //_DMA_BACKGROUNDTILEPROVIDER_HPP_
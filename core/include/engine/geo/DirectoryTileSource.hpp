@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_DIRECTORYTILESOURCE_HPP_
+#define _DMA_DIRECTORYTILESOURCE_HPP_
+
+#include "engine/geo/ITileSource.hpp"
+
+#include <string>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Reads the tiles of a directory laid out as <dir>/z/x/y.png.
+         */
+        class DirectoryTileSource : public ITileSource {
+
+        public:
+            explicit DirectoryTileSource(const std::string& dir);
+            virtual ~DirectoryTileSource();
+
+            Status read(int x, int y, int z, std::vector<BYTE>& data) override;
+
+        private:
+            std::string mDir;
+        };
+    }
+}
+
+#endif //_DMA_DIRECTORYTILESOURCE_HPP_
@@ -108,6 +108,87 @@ namespace dma {
 
             virtual void setCallback(GeoEngineCallbacks* callbacks);
 
+            /**
+             * Serves the tiles of the provider's namespace, which becomes the current one,
+             * e.g. a TilePackProvider. nullptr to go back to the callbacks.
+             */
+            inline void setTileProvider(std::shared_ptr<ITileProvider> provider) {
+                mGeoSceneManager.setTileProvider(provider);
+            }
+
+            /**
+             * @return the counts of tile requests issued, deduplicated and cancelled.
+             */
+            inline const TileRequestManager::Stats& getTileRequestStats() {
+                return mGeoSceneManager.getTileMap().getRequestStats();
+            }
+
+            /**
+             * Pipelines the simulation of a frame with the GL submission of the previous one,
+             * see Engine::setFramePacketsEnabled. Disabled by default.
+             */
+            inline void setFramePacketsEnabled(bool enabled) {
+                mEngine.setFramePacketsEnabled(enabled);
+            }
+
+            /**
+             * Tiles are decoded in the background, and uploaded at each step
+             * until maxBytes of pixels or maxMillis have been spent.
+             */
+            inline void setTileUploadBudget(U32 maxBytes, F32 maxMillis) {
+                mEngine.getResourceManager().setMapUploadBudget(maxBytes, maxMillis);
+            }
+
+            /**
+             * Tiles ahead of the moving camera are decoded, or requested through
+             * GeoEngineCallbacks::onTilePrefetch, before entering the map.
+             * Enabled by default.
+             */
+            inline void setTilePrefetchEnabled(bool enabled) {
+                mGeoSceneManager.setTilePrefetchEnabled(enabled);
+            }
+
+            /**
+             * Displays levels-1 rings of coarser tiles around the map, each one zoom
+             * lower than the previous one, e.g. 4 levels see about 2 km away.
+             * The camera's far plane should be raised accordingly.
+             * 1 by default, i.e. only the map around the camera.
+             */
+            inline void setTileLodLevels(int levels) {
+                mGeoSceneManager.setTileLodLevels(levels);
+            }
+
+            /**
+             * Draws all tiles in a single draw call, from a texture atlas.
+             * Disabled by default.
+             */
+            inline void setTileAtlasEnabled(bool enabled) {
+                mGeoSceneManager.setTileAtlasEnabled(enabled);
+            }
+
+            /**
+             * Tiles that left the map stay in memory until this budget,
+             * counting both their image and GL texture, is exceeded.
+             */
+            inline void setTileCacheBudget(U64 bytes) {
+                mEngine.getResourceManager().setTileCacheBudget(bytes);
+            }
+
+            /**
+             * @return the tile cache hit, miss and eviction counters.
+             */
+            inline const TileCache::Stats& getTileCacheStats() {
+                return mEngine.getResourceManager().getTileCacheStats();
+            }
+
+            /**
+             * Tiles decoded once are written to this directory in a GPU-ready
+             * format, then mapped and uploaded as is. Empty to disable (default).
+             */
+            inline void setDecodedTileDir(const std::string& dir) {
+                mEngine.getResourceManager().setDecodedTileDir(dir);
+            }
+
 
         private:
             /* ***
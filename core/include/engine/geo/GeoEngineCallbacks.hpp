@@ -73,6 +73,39 @@ namespace dma {
                 Log::error(TAG, "Not implemented tile request (tile (%d, %d, %d))", x, y, z);
             }
 
+            /**
+             * Called for a tile that is not displayed yet, but soon will be
+             * given the camera's motion. The request can be served with a lower
+             * priority than onTileRequest, calling notifyTileAvailable
+             * once the png is on the storage.
+             * By default, forwards to onTileRequest.
+             *
+             * @param int
+             *          x coord of the requested tile.
+             * @param int
+             *          y coord of the requested tile.
+             * @param int
+             *          z coord of the requested tile.
+             */
+            virtual inline void onTilePrefetch(int x, int y, int z) {
+                onTileRequest(x, y, z);
+            }
+
+            /**
+             * Called when a tile requested through onTileRequest or onTilePrefetch,
+             * and not notified available yet, is no longer needed: it left the map,
+             * or the namespace changed. The request can be dropped.
+             *
+             * @param int
+             *          x coord of the cancelled tile.
+             * @param int
+             *          y coord of the cancelled tile.
+             * @param int
+             *          z coord of the cancelled tile.
+             */
+            virtual inline void onTileCancel(int x, int y, int z) {
+            }
+
             /**
              * Called each time the engine displays a tile.
              * This happens for example each time the position moves on an new area.
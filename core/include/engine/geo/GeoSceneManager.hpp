@@ -62,6 +62,16 @@ namespace dma {
 
             void step();
 
+            /**
+             * Recreates the GL objects of the tile map after a context loss.
+             */
+            void refresh();
+
+            /**
+             * Deletes the GL objects of the tile map.
+             */
+            void wipe();
+
             /**
              * Convert world coordinates to openGL coordinates.
              */
@@ -121,8 +131,32 @@ namespace dma {
 
             void setTileNamespace(const std::string& ns);
 
+            inline TileMap& getTileMap() {
+                return mTileMap;
+            }
+
+            /**
+             * @see TileMap::setTileProvider
+             */
+            void setTileProvider(std::shared_ptr<ITileProvider> provider);
+
             void updateTileDiffuseMaps();
 
+            /**
+             * Prefetches the tiles ahead of the moving camera, see TileMap::track.
+             */
+            void setTilePrefetchEnabled(bool enabled);
+
+            /**
+             * Displays coarser tiles around the map, see TileMap::setLodLevels.
+             */
+            void setTileLodLevels(int levels);
+
+            /**
+             * Draws all tiles at once, see TileMap::setAtlasEnabled.
+             */
+            void setTileAtlasEnabled(bool enabled);
+
         private:
             friend class GeoEngine;
             friend class GeoEngineAsync;
@@ -135,6 +169,13 @@ namespace dma {
              */
             glm::vec3 destinationPoint(double bearing, double distance) const;
 
+            void mRemoveTiles();
+
+            /**
+             * Creates the tiles again, e.g. after a change of level count.
+             */
+            void mResetTileMap();
+
 
             /* ***
              * ATTRIBUTES
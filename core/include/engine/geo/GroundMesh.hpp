@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_GEO_GROUNDMESH_HPP_
+#define _DMA_GEO_GROUNDMESH_HPP_
+
+#include "resource/Mesh.hpp"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * The tiles of a TileMap merged into a single mesh, one quad per tile,
+         * their texture coordinates pointing into a TextureAtlas.
+         */
+        class GroundMesh : public Mesh {
+
+        public:
+            explicit GroundMesh(U32 tileCount);
+            virtual ~GroundMesh();
+
+            /**
+             * Creates the GL buffers, again after a context loss.
+             */
+            void init();
+
+            /**
+             * @param center the center of the tile, in world coordinates
+             * @param width along x
+             * @param height along z
+             */
+            void setTile(U32 index, const glm::vec3& center, F32 width, F32 height);
+
+            /**
+             * @param rect (u0, v0, u1, v1) texture coordinates of the tile
+             */
+            void setTileRect(U32 index, const glm::vec4& rect);
+
+            /**
+             * Writes the vertices to the GL buffer and updates the bounding sphere.
+             * Vertices are in world coordinates, i.e. relative to the scene origin:
+             * it only moves with GeoSceneManager::setOrigin, which places all the
+             * tiles again. The entity stays at the origin, and a tile keeps exactly
+             * the same vertices as long as it is not moved.
+             */
+            void upload();
+
+        private:
+            struct TileQuad {
+                glm::vec3 center;
+                F32 width;
+                F32 height;
+                glm::vec4 rect;
+            };
+
+            std::vector<TileQuad> mTiles;
+            std::vector<F32> mData;
+        };
+    }
+}
+
+#endif //_DMA_GEO_GROUNDMESH_HPP_
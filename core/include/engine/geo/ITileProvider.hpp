@@ -18,13 +18,47 @@
 #ifndef _DMA_ITILEPROVIDER_HPP_
 #define _DMA_ITILEPROVIDER_HPP_
 
+#include <string>
+
 namespace dma {
+
+    class ResourceManager;
+
     namespace geo {
 
+        /**
+         * Serves the tiles of a namespace to the engine, see GeoEngine::setTileProvider.
+         * Tiles are requested from the provider instead of GeoEngineCallbacks::onTileRequest.
+         */
         class ITileProvider {
 
         public:
+            virtual ~ITileProvider() {}
+
+            /**
+             * @return the namespace of the tiles, i.e. their sids tiles/<ns>/z/x/y
+             */
+            virtual const std::string& getNamespace() const = 0;
+
+            /**
+             * Called on the GL thread when set on the engine, e.g. to register
+             * a tile source on the resource manager.
+             */
+            virtual void attach(ResourceManager& resourceManager) {}
+
+            virtual void detach(ResourceManager& resourceManager) {}
+
+            /**
+             * Called on the GL thread for a tile neither in memory nor found by
+             * ResourceManager::hasMap. Once it is, GeoSceneManager::notifyTileAvailable
+             * is to be called on the GL thread, e.g. through GeoEngine::post.
+             */
             virtual void fetch(int x, int y, int z) = 0;
+
+            /**
+             * Called on the GL thread for a fetched tile no longer needed.
+             */
+            virtual void cancel(int x, int y, int z) {}
         };
 
     }
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_ITILESOURCE_HPP_
+#define _DMA_ITILESOURCE_HPP_
+
+#include "common/Types.hpp"
+
+#include <vector>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Where a BackgroundTileProvider reads its tiles from: a directory, a pack,
+         * or e.g. an HTTP client.
+         */
+        class ITileSource {
+
+        public:
+            virtual ~ITileSource() {}
+
+            /**
+             * Reads the PNG file of the tile. Called on the provider's worker threads,
+             * possibly concurrently.
+             * @return STATUS_KO if the source doesn't have the tile
+             */
+            virtual Status read(int x, int y, int z, std::vector<BYTE>& data) = 0;
+        };
+    }
+}
+
+#endif //_DMA_ITILESOURCE_HPP_
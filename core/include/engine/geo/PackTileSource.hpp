@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_PACKTILESOURCE_HPP_
+#define _DMA_PACKTILESOURCE_HPP_
+
+#include "engine/geo/ITileSource.hpp"
+#include "resource/TilePack.hpp"
+
+#include <string>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Reads the tiles of a tile pack, mapped once. Unlike a TilePackProvider,
+         * the pack is not registered on the resource manager: the tiles read
+         * are copied to the map directory.
+         */
+        class PackTileSource : public ITileSource {
+
+        public:
+            explicit PackTileSource(const std::string& filename);
+            virtual ~PackTileSource();
+
+            /**
+             * @return false if the pack couldn't be mapped
+             */
+            inline bool isOpen() const {
+                return !mPack.getFilename().empty();
+            }
+
+            Status read(int x, int y, int z, std::vector<BYTE>& data) override;
+
+        private:
+            TilePack mPack;
+        };
+    }
+}
+
+#endif //_DMA_PACKTILESOURCE_HPP_
@@ -78,7 +78,11 @@ namespace dma {
             int x;
             int y;
             int z;
+            /** index of the tile in its TileMap, e.g. its slot in the atlas */
+            int slot;
             bool mDirty;
+            /** diffuse map changed since last put in the atlas */
+            bool mAtlasDirty;
             std::shared_ptr<Quad> mQuad;
         };
     }
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_GEO_TILEGRID_HPP_
+#define _DMA_GEO_TILEGRID_HPP_
+
+#include <functional>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * The cells of a TileMap level, on a toroidal grid: tile (x, y) is on cell
+         * (x mod width, y mod width), so that moving only touches the cells
+         * of the rows and columns entering or leaving the level.
+         * Only keeps track of the bounds, the cells being stored by the caller.
+         */
+        class TileGrid {
+
+        public:
+            /**
+             * Inclusive bounds, in tiles of a level.
+             */
+            struct Bounds {
+                int x0, y0, x1, y1;
+
+                inline bool contains(int x, int y) const {
+                    return x >= x0 && x <= x1 && y >= y0 && y <= y1;
+                }
+
+                inline bool overlaps(const Bounds& other) const {
+                    return x0 <= other.x1 && other.x0 <= x1 && y0 <= other.y1 && other.y0 <= y1;
+                }
+            };
+
+            typedef std::function<void(int x, int y)> CellFunc;
+
+            TileGrid();
+            virtual ~TileGrid();
+
+            /**
+             * Empties the grid, any previous cell being forgotten.
+             */
+            void reset(int width);
+
+            inline int getWidth() const { return mWidth; }
+            inline const Bounds& getOuter() const { return mOuter; }
+            inline const Bounds& getHole() const { return mHole; }
+
+            /**
+             * @return true if the tile is within the outer bounds but not within the hole.
+             */
+            inline bool contains(int x, int y) const {
+                return mOuter.contains(x, y) && !mHole.contains(x, y);
+            }
+
+            /**
+             * @return the index of the cell of tile (x, y), in [0, width * width).
+             */
+            inline int cellIndex(int x, int y) const {
+                return wrap(x, mWidth) + wrap(y, mWidth) * mWidth;
+            }
+
+            /**
+             * Moves the grid to the new bounds, at most width tiles wide. Calls
+             * release on each tile leaving the grid, all before calling assign on
+             * each tile entering it. Only those tiles are visited, unless the
+             * bounds don't overlap the previous ones.
+             */
+            void move(const Bounds& outer, const Bounds& hole, const CellFunc& release, const CellFunc& assign);
+
+            static inline int wrap(int v, int n) {
+                int m = v % n;
+                return m < 0 ? m + n : m;
+            }
+
+        private:
+            int mWidth;
+            /** the tiles of the grid are within outer but not within hole */
+            Bounds mOuter, mHole;
+        };
+    }
+}
+
+#endif //_DMA_GEO_TILEGRID_HPP_
@@ -19,11 +19,20 @@
 #define _DMA_GEO_TILEMAP_HPP_
 
 #include "engine/geo/Tile.hpp"
+#include "engine/geo/GroundMesh.hpp"
 #include "engine/geo/GeoEngineCallbacks.hpp"
+#include "engine/geo/TileGrid.hpp"
+#include "engine/geo/ITileProvider.hpp"
+#include "engine/geo/TileRequestManager.hpp"
 #include "resource/ResourceManager.hpp"
+#include "resource/TextureAtlas.hpp"
 
+#include <deque>
 #include <list>
 #include <queue>
+#include <set>
+#include <utility>
+#include <vector>
 
 namespace dma {
     namespace geo {
@@ -38,6 +47,20 @@ namespace dma {
             static constexpr int        SIZE       = 7;
             static constexpr int        OFFSET     = SIZE / 2;
             static constexpr int        ZOOM     = 19;
+            static constexpr int        MAX_LOD_LEVELS      = 4;
+            /** width of the coarser levels, in their own tiles */
+            static constexpr int        LOD_SIZE            = 8;
+            /** in pixels, the size of a tile image */
+            static constexpr U32        ATLAS_SLOT_SIZE     = 256;
+            /** camera placements the velocity is computed over */
+            static constexpr U32        HISTORY_SIZE        = 5;
+            static constexpr double     HISTORY_MIN_SECONDS = 0.2;
+            /** in tiles per second, about 1 m/s at ZOOM */
+            static constexpr double     PREFETCH_MIN_SPEED  = 0.02;
+            /** the ring tiles within this angle of the heading are prefetched */
+            static constexpr double     PREFETCH_HALF_ANGLE = 50.0;
+            /** heading change after which the prefetch is renewed */
+            static constexpr double     PREFETCH_TOLERANCE  = 30.0;
 
             friend class GeoSceneManager;
 
@@ -67,14 +90,75 @@ namespace dma {
              */
             void update(int x0, int y0);
 
+            /**
+             * Records the camera position, in tiles at ZOOM including the position
+             * within the tile. Once the camera moves, the tiles of the ring just
+             * beyond the map, ahead of the camera, are decoded in the background or
+             * requested through onTilePrefetch. A heading change cancels the decoding
+             * of those no longer ahead.
+             */
+            void track(double x, double y);
+
+            /**
+             * Enabled by default.
+             */
+            void setPrefetchEnabled(bool enabled);
+
             /**
              * Notify that a tmp png provided is available
              * @return Status::OK if tile could be loaded.
              */
             Status notifyTileAvailable(int x, int y, int z);
 
+            /**
+             * Puts the tile maps decoded in the background on their tiles,
+             * within the upload budget of the ResourceManager.
+             * Called at each frame from the GL thread.
+             */
+            void step();
+
             void setNamespace(const std::string& ns);
 
+            /**
+             * Sets the number of zoom levels displayed. The first level is the
+             * SIZE x SIZE map at ZOOM. Each coarser level, one zoom lower, is a hollow
+             * square of LOD_SIZE x LOD_SIZE tiles around the previous one, the levels
+             * being aligned so that they don't overlap. With more than one level,
+             * tiles have skirts hiding the cracks between levels, and the first level
+             * is widened by a row and a column to align it on the second one.
+             * 1 by default. Takes effect at the next init().
+             */
+            void setLodLevels(int levels);
+
+            inline int getLodLevels() const {
+                return mLodLevels;
+            }
+
+            /**
+             * Draws all tiles at once: their images are copied into the slots of a
+             * single atlas, and their quads merged into a single ground entity.
+             * Falls back to a draw per tile if the atlas exceeds the max texture size.
+             * Disabled by default. Takes effect at the next init().
+             */
+            void setAtlasEnabled(bool enabled);
+
+            /**
+             * @return the entity drawing all tiles in atlas mode, nullptr otherwise.
+             */
+            inline std::shared_ptr<Entity> getGround() const {
+                return mGround;
+            }
+
+            /**
+             * Recreates the atlas after a context loss.
+             */
+            void refresh();
+
+            /**
+             * Deletes the GL objects of the atlas.
+             */
+            void wipe();
+
             void setCallbacks(GeoEngineCallbacks* callbacks) {
                 if(!callbacks) {
                     mCallbacks = mNullCallbacks;
@@ -83,6 +167,19 @@ namespace dma {
                 }
             }
 
+            /**
+             * Missing tiles of the provider's namespace, now the current one,
+             * are fetched from it instead of the callbacks. nullptr to unset.
+             */
+            void setTileProvider(std::shared_ptr<ITileProvider> provider);
+
+            /**
+             * @return the counts of the tiles requested to the provider or the callbacks.
+             */
+            inline const TileRequestManager::Stats& getRequestStats() const {
+                return mRequests.getStats();
+            }
+
         private:
             TileMap(ResourceManager&);
             TileMap(const TileMap&) = delete;
@@ -99,17 +196,137 @@ namespace dma {
 
             void updateDiffuseMaps();
 
+            /**
+             * Shows the tile's map if in memory. Otherwise shows the default map,
+             * and has the tile's map decoded if available, or requested if not.
+             */
+            void mAssignDiffuseMap(Tile& tile);
+
             void mRemoveAllTiles();
 
             std::shared_ptr<Tile> findTile(int x, int y, int z);
 
+            typedef TileGrid::Bounds Bounds;
+
+            /**
+             * The size of the tiles of a row, depending on its latitude only.
+             */
+            struct Row {
+                int y;
+                double lat;
+                float width, height;
+            };
+
+            /**
+             * The tiles of a zoom level, on the cells of its grid.
+             */
+            struct Level {
+                TileGrid grid;
+                std::vector<std::shared_ptr<Tile>> cells;
+                /** rows by y mod width */
+                std::vector<Row> rows;
+                /** tiles on no cell */
+                std::vector<std::shared_ptr<Tile>> spare;
+
+                inline std::shared_ptr<Tile>& cell(int x, int y) {
+                    return cells[grid.cellIndex(x, y)];
+                }
+            };
+
+            /**
+             * Puts the tiles of the level on the cells within outer but not within hole.
+             * Only the cells entering or leaving the level are touched, unless it jumped.
+             */
+            void mUpdateLevel(int level, const Bounds& outer, const Bounds& hole);
+
+            /**
+             * Moves the tile off cell (x, y) of the level, if any, to the spare tiles.
+             */
+            void mReleaseCell(Level& level, int x, int y);
+
+            /**
+             * Puts a spare tile on cell (x, y) of the level.
+             */
+            void mAssignCell(int level, int x, int y);
+
+            const Row& mGetRow(Level& level, int y, int z);
+
+            /**
+             * @return true for a tile sid of the current namespace, parsing its coordinates.
+             */
+            bool mParseSid(const std::string& sid, int& x, int& y, int& z) const;
+
+            void mInitAtlas();
+
+            /**
+             * Copies the changed tile maps into the atlas.
+             */
+            void mUpdateAtlas();
+
+            /**
+             * Moves the tile's quad in the ground mesh, once placed by the GeoSceneManager.
+             */
+            void mPlaceTile(const Tile& tile);
+
+            /**
+             * Uploads the ground mesh if changed.
+             */
+            void mUpdateGround();
+
+            void mPrefetchTile(int x, int y);
+
+            /**
+             * Requests a tile missing from the storage, to the provider or the callbacks,
+             * at the next step() unless already requested.
+             */
+            void mFetchTile(int x, int y, int z, bool prefetch);
+
+            /**
+             * Sends the request issued by mRequests.
+             */
+            void mIssueTile(int x, int y, int z, bool prefetch);
+
+            /**
+             * Cancels the decoding of the tile's map, and its request if in flight.
+             */
+            void mCancelTile(int x, int y, int z);
+
+            void mCancelPrefetch();
+
             //Fields
             ResourceManager& mResourceManager;
             /** the last known center position. */
             int mLastX, mLastY;
+            /** the tiles of all levels */
             std::list<std::shared_ptr<Tile>> mTiles;
+            Level mLevels[MAX_LOD_LEVELS];
+            int mLodLevels;
             std::string mNamespace;
+            /** tiles/<ns>/ */
+            std::string mSidPrefix;
             GeoEngineCallbacks* mNullCallbacks, * mCallbacks;
+            std::shared_ptr<ITileProvider> mTileProvider;
+            TileRequestManager mRequests;
+            std::vector<std::string> mUploadedMaps;
+
+            bool mAtlasEnabled;
+            std::shared_ptr<TextureAtlas> mAtlas;
+            std::shared_ptr<GroundMesh> mGroundMesh;
+            std::shared_ptr<Entity> mGround;
+            /** the default tile map, in the first slot of the atlas */
+            std::shared_ptr<Map> mFallbackMap;
+            bool mGroundDirty;
+
+            struct Sample {
+                double x, y;
+                double time; // seconds
+            };
+            std::deque<Sample> mHistory;
+            /** tiles prefetched, around (mPrefetchX, mPrefetchY) towards mPrefetchHeading */
+            std::set<std::pair<int, int>> mPrefetched;
+            int mPrefetchX, mPrefetchY;
+            double mPrefetchHeading;
+            bool mPrefetchEnabled;
         };
     }
 }
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_TILEPACKPROVIDER_HPP_
+#define _DMA_TILEPACKPROVIDER_HPP_
+
+#include "engine/geo/ITileProvider.hpp"
+#include "resource/TilePack.hpp"
+
+#include <memory>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Serves the tiles of a namespace from a tile pack, mapped once.
+         * The pack holds all the tiles there are: missing ones are not fetched.
+         */
+        class TilePackProvider : public ITileProvider {
+
+        public:
+            TilePackProvider(const std::string& filename, const std::string& ns);
+            TilePackProvider(const TilePackProvider&) = delete;
+            void operator=(const TilePackProvider&) = delete;
+            virtual ~TilePackProvider();
+
+            /**
+             * @return false if the pack couldn't be mapped
+             */
+            inline bool isOpen() const {
+                return !mPack->getFilename().empty();
+            }
+
+            inline const std::string& getNamespace() const override {
+                return mNamespace;
+            }
+
+            void attach(ResourceManager& resourceManager) override;
+
+            void detach(ResourceManager& resourceManager) override;
+
+            void fetch(int x, int y, int z) override;
+
+        private:
+            std::shared_ptr<TilePack> mPack;
+            std::string mNamespace;
+        };
+    }
+}
+
+#endif //_DMA_TILEPACKPROVIDER_HPP_
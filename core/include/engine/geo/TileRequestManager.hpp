@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_GEO_TILEREQUESTMANAGER_HPP_
+#define _DMA_GEO_TILEREQUESTMANAGER_HPP_
+
+#include "common/Types.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Tracks the tiles requested to the host or provider: a tile is requested once
+         * until available or cancelled, the requests of a frame being issued nearest
+         * to the camera first, and a request leaving the map being cancelled.
+         */
+        class TileRequestManager {
+
+        public:
+            struct Stats {
+                U32 issued;
+                U32 deduped;    // already queued or in flight
+                U32 cancelled;  // in flight, then no longer needed
+            };
+
+            typedef std::function<void(int x, int y, int z, bool prefetch)> FetchFunction;
+            typedef std::function<void(int x, int y, int z)> CancelFunction;
+
+            TileRequestManager(const FetchFunction& fetch, const CancelFunction& cancel);
+            TileRequestManager(const TileRequestManager&) = delete;
+            void operator=(const TileRequestManager&) = delete;
+            virtual ~TileRequestManager();
+
+            /**
+             * Queues the request until the next flush(), unless the tile is already
+             * queued or in flight. A request upgrades a queued prefetch.
+             */
+            void request(int x, int y, int z, bool prefetch);
+
+            /**
+             * Issues the queued requests, nearest to (x, y) first, prefetches last.
+             * @param x, y the camera position, in tiles at zoom
+             */
+            void flush(double x, double y, int zoom);
+
+            /**
+             * The tile is available, no longer in flight.
+             */
+            void complete(int x, int y, int z);
+
+            /**
+             * Drops the request of the tile, a cancellation being emitted if in flight.
+             */
+            void cancel(int x, int y, int z);
+
+            void cancelAll();
+
+            /**
+             * Forgets all requests, without emitting cancellations.
+             */
+            void clear();
+
+            bool isPending(int x, int y, int z) const;
+
+            inline const Stats& getStats() const {
+                return mStats;
+            }
+
+        private:
+            struct Request {
+                int x, y, z;
+                bool prefetch;
+            };
+
+            FetchFunction mFetch;
+            CancelFunction mCancel;
+            std::unordered_map<U64, Request> mQueued;
+            std::unordered_map<U64, Request> mInFlight;
+            std::vector<std::pair<double, Request>> mOrder;
+            Stats mStats;
+        };
+    }
+}
+
+#endif //_DMA_GEO_TILEREQUESTMANAGER_HPP_
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_BINDINGCACHE_HPP_
+#define _DMA_BINDINGCACHE_HPP_
+
+#include "common/Types.hpp"
+#include "resource/Mesh.hpp"
+#include "resource/Pass.hpp"
+#include "resource/ShaderProgram.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Everything needed to bind a mesh for a given pass:
+     * the vertex attribute pointers and the uniform locations
+     * the pass has to upload.
+     */
+    struct BindingRecord {
+        struct Attrib {
+            GLuint location;
+            GLint count;
+            GLenum type;
+            GLboolean normalized;
+            GLsizei stride;
+            const GLvoid* offset;
+        };
+
+        Attrib attribs[ShaderProgram::AttribSem::AS_size];
+        U8 attribCount;
+        U32 attribMask;
+        bool diffuseMap;
+        // -1 when the pass does not upload the uniform
+        GLint uniforms[ShaderProgram::UniformSem::US_size];
+        // 0 until created by the rendering engine, when supported
+        GLuint vertexArray;
+    };
+
+
+    /**
+     * Binding records computed once per (Mesh, ShaderProgram, pass functionalities).
+     * Must be cleared whenever meshes or shaders are refreshed or reloaded,
+     * since vertex layouts & locations may then change.
+     */
+    class BindingCache {
+
+    public:
+        BindingCache();
+        BindingCache(const BindingCache&) = delete;
+        void operator=(const BindingCache&) = delete;
+        virtual ~BindingCache();
+
+        BindingRecord& get(const Mesh& mesh, const Pass& pass);
+
+        /**
+         * Same as above, but with another program than the pass' one
+         * (e.g. an instanced variant of it).
+         */
+        BindingRecord& get(const Mesh& mesh, const Pass& pass, const ShaderProgram& program);
+
+        /**
+         * @param releaseVertexArrays false if the GL context has been lost,
+         *        vertex array objects then being already gone.
+         */
+        void clear(bool releaseVertexArrays);
+
+        /**
+         * Drops the records of a mesh that is no longer used.
+         * @param releaseVertexArrays true to delete their vertex array objects,
+         *        none of them being bound
+         */
+        void forget(U32 meshId, bool releaseVertexArrays);
+
+        inline size_t size() const { return mRecords.size(); }
+
+    private:
+        static U64 mComputeKey(const Mesh& mesh, const Pass& pass, const ShaderProgram& program);
+        static void mBuild(const Mesh& mesh, const Pass& pass, const ShaderProgram& program, BindingRecord& record);
+
+        std::unordered_map<U64, BindingRecord> mRecords;
+        // keys of the records of each mesh
+        std::unordered_map<U32, std::vector<U64>> mMeshKeys;
+    };
+}
+
+#endif //_DMA_BINDINGCACHE_HPP_
@@ -112,6 +112,8 @@ namespace dma {
             return mFrustum.containsSphere(center, radius);
         }
 
+        inline const Frustum& getFrustum() const { return mFrustum; }
+
 
         virtual void setPosition(const glm::vec3& position);
         virtual void setPosition(const glm::vec3& position, float duration);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_FRAMEPACKET_HPP_
+#define _DMA_FRAMEPACKET_HPP_
+
+#include "common/Types.hpp"
+#include "rendering/RenderQueue.hpp"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Sorted draw items of a frame and those of the HUD, with their model
+     * matrices and the view & projection copied by value, so that the next
+     * frame can be simulated while this one is submitted.
+     */
+    class FramePacket {
+
+    public:
+        FramePacket();
+        FramePacket(const FramePacket&) = delete;
+        void operator=(const FramePacket&) = delete;
+        virtual ~FramePacket();
+
+        /**
+         * Copies the items of a sorted queue, then those of the HUD.
+         */
+        void build(const RenderQueue& queue, const glm::mat4& V, const glm::mat4& P,
+                   const std::vector<RenderQueue::Item>& hud, const glm::mat4& hudV, const glm::mat4& hudP);
+
+        void clear();
+
+        /**
+         * @return true once built, until cleared.
+         */
+        inline bool isReady() const { return mReady; }
+
+        inline const std::vector<RenderQueue::Item>& getOpaqueItems() const { return mOpaque; }
+        inline const std::vector<RenderQueue::Item>& getBackToFrontItems() const { return mBackToFront; }
+        inline const glm::mat4& getV() const { return mV; }
+        inline const glm::mat4& getP() const { return mP; }
+        inline const std::vector<RenderQueue::Item>& getHUDItems() const { return mHUD; }
+        inline const glm::mat4& getHUDV() const { return mHUDV; }
+        inline const glm::mat4& getHUDP() const { return mHUDP; }
+
+    private:
+        void mCopy(const std::vector<RenderQueue::Item>& src, std::vector<RenderQueue::Item>& dst);
+
+        std::vector<RenderQueue::Item> mOpaque;
+        std::vector<RenderQueue::Item> mBackToFront;
+        std::vector<RenderQueue::Item> mHUD;
+        std::vector<glm::mat4> mMatrices;
+        glm::mat4 mV;
+        glm::mat4 mP;
+        glm::mat4 mHUDV;
+        glm::mat4 mHUDP;
+        bool mReady;
+    };
+}
+
+#endif //_DMA_FRAMEPACKET_HPP_
@@ -18,6 +18,7 @@
 #ifndef ARPIGL_FRUSTUM_HPP
 #define ARPIGL_FRUSTUM_HPP
 
+#include "common/Types.hpp"
 #include "rendering/Plane.hpp"
 #include "rendering/BoundingSphere.hpp"
 
@@ -28,11 +29,18 @@ namespace dma {
         enum { NEAR = 0, FAR = 1, TOP = 2, BOTTOM = 3, LEFT = 4, RIGHT = 5};
 
         Plane mPlanes[6];
+        // planes as n.p + d, one array per coefficient, for the batch tests
+        F32 mPlaneX[6], mPlaneY[6], mPlaneZ[6], mPlaneD[6];
         float mNear, mFar, mAspectRatio, mFovY;
         float nw, nh, fw, fh;
         glm::mat4 mProjection;
 
     public:
+        enum Intersection {
+            OUTSIDE = 0,
+            INTERSECTS = 1,
+            INSIDE = 2
+        };
 
         Frustum();
         virtual ~Frustum();
@@ -69,6 +77,26 @@ namespace dma {
 
         bool containsSphere(const glm::vec3& center, float radius);
 
+        /**
+         * Like containsSphere, but also tells whether the sphere is entirely inside,
+         * which allows to accept everything it bounds without further tests.
+         */
+        Intersection intersectSphere(const glm::vec3& center, float radius) const;
+
+        /**
+         * Batch version of containsSphere, over arrays of sphere coordinates & radii.
+         * Uses SSE or NEON when available, 4 spheres at a time.
+         * @param out receives 1 for each sphere inside or intersecting the frustum, 0 otherwise.
+         */
+        void containsSpheres(const F32* cx, const F32* cy, const F32* cz, const F32* r,
+                             U32 count, U8* out) const;
+
+        /**
+         * Scalar implementation of containsSpheres, kept as a reference.
+         */
+        void containsSpheresScalar(const F32* cx, const F32* cy, const F32* cz, const F32* r,
+                                   U32 count, U8* out) const;
+
     };
 }
 
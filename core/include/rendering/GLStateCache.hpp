@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_GLSTATECACHE_HPP_
+#define _DMA_GLSTATECACHE_HPP_
+
+#include "common/Types.hpp"
+
+#include <GLES2/gl2.h>
+
+namespace dma {
+
+    /**
+     * Shadow copy of the GL state touched by the rendering engine.
+     * Every state change goes through this object, which only forwards
+     * the calls that would actually change the current GL state.
+     */
+    class GLStateCache {
+
+    public:
+        static constexpr U32 MAX_TEXTURE_UNITS = 8;
+        static constexpr U32 MAX_VERTEX_ATTRIBS = 32;
+
+        struct Stats {
+            U32 issued;     // calls forwarded to GL
+            U32 filtered;   // calls skipped as redundant
+        };
+
+        GLStateCache();
+        GLStateCache(const GLStateCache&) = delete;
+        void operator=(const GLStateCache&) = delete;
+        virtual ~GLStateCache();
+
+        /**
+         * Forgets everything and puts the attrib arrays back in a known
+         * (disabled) state. Must be called whenever the GL context is (re)created.
+         */
+        void reset();
+
+        /**
+         * Starts a new frame: stats are rolled over, and program, buffer
+         * & texture bindings are forgotten since resource loading binds
+         * them behind our back.
+         */
+        void beginFrame();
+
+        void useProgram(GLuint program);
+
+        /**
+         * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+         */
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        void activeTexture(U32 unit);
+
+        /**
+         * Binds a texture on the active unit.
+         * @param target GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+         */
+        void bindTexture(GLenum target, GLuint texture);
+
+        /**
+         * @param capability GL_CULL_FACE, GL_DEPTH_TEST or GL_BLEND
+         */
+        void setCapability(GLenum capability, bool enabled);
+
+        void cullFace(GLenum mode);
+
+        void depthMask(bool enabled);
+
+        void depthFunc(GLenum func);
+
+        void blendFunc(GLenum sfactor, GLenum dfactor);
+
+        /**
+         * Enables exactly the vertex attrib arrays set in the mask,
+         * disabling the others. Only tracks the default vertex array object.
+         */
+        void setEnabledAttribs(U32 mask);
+
+        /**
+         * Requires GLExtensions::hasVertexArrayObject.
+         * Binding a vertex array object also changes the bound element array buffer.
+         */
+        void bindVertexArray(GLuint vertexArray);
+
+        /**
+         * Stats of the last complete frame.
+         */
+        inline const Stats& getFrameStats() const { return mLastFrameStats; }
+
+    private:
+        enum Capability {
+            CULL_FACE = 0,
+            DEPTH_TEST = 1,
+            BLEND = 2,
+            CAPABILITY_COUNT = 3
+        };
+
+        static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+        void mForgetBindings();
+        void mForgetRenderStates();
+
+        inline bool mFilter(bool redundant) {
+            if (redundant) {
+                ++mStats.filtered;
+            } else {
+                ++mStats.issued;
+            }
+            return redundant;
+        }
+
+        GLuint mProgram;
+        GLuint mArrayBuffer;
+        GLuint mElementArrayBuffer;
+        U32 mActiveUnit;
+        GLuint mTextures2D[MAX_TEXTURE_UNITS];
+        GLuint mTexturesCube[MAX_TEXTURE_UNITS];
+        I32 mCapabilities[CAPABILITY_COUNT]; // -1 unknown, 0 disabled, 1 enabled
+        GLenum mCullFace;
+        I32 mDepthMask;
+        GLenum mDepthFunc;
+        GLenum mBlendSrc;
+        GLenum mBlendDst;
+        U32 mAttribMask;
+        GLuint mVertexArray;
+        U32 mMaxAttribs;
+        Stats mStats;
+        Stats mLastFrameStats;
+    };
+}
+
+#endif //_DMA_GLSTATECACHE_HPP_
@@ -20,7 +20,9 @@
 
 #include "common/Types.hpp"
 
+#include <GLES2/gl2.h>
 #include <string>
+#include <vector>
 
 
 namespace dma {
@@ -31,12 +33,30 @@ namespace dma {
     class IndexBuffer {
 
     public:
+        /**
+         * Part of the buffer drawn with 16-bit indices relative to its
+         * first vertex, for meshes too large to be drawn at once without
+         * 32-bit indices.
+         */
+        struct Range {
+            U32 first;      // index
+            U32 count;
+            U32 baseVertex;
+        };
+
+        /**
+         * Returns the size in byte of an index of the given type
+         */
+        static inline U32 getTypeSize(GLenum type) {
+            return type == GL_UNSIGNED_INT ? 4 : 2;
+        }
+
         IndexBuffer();
         //IndexBuffer(const IndexBuffer&) = delete;
-        IndexBuffer(U32 elementCount);
+        IndexBuffer(U32 elementCount, GLenum type = GL_UNSIGNED_SHORT);
         virtual ~IndexBuffer();
 
-        void generateBuffer(U32 elementCount);
+        void generateBuffer(U32 elementCount, GLenum type = GL_UNSIGNED_SHORT);
 
         /**
          * Returns the OpenGL handle
@@ -58,6 +78,26 @@ namespace dma {
             return mElementCount;
         }
 
+        /**
+         * Returns GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         */
+        inline GLenum getType() const {
+            return mType;
+        }
+
+        /**
+         * Returns the ranges to draw one by one, empty if drawn at once
+         */
+        inline const std::vector<Range>& getRanges() const {
+            return mRanges;
+        }
+        inline bool isSplit() const {
+            return !mRanges.empty();
+        }
+        inline void setRanges(const std::vector<Range>& ranges) {
+            mRanges = ranges;
+        }
+
         /**
          * Writes mSizeInByte bytes of data to the IBO GPU side
          * data must be mSizeInByte long
@@ -76,6 +116,8 @@ namespace dma {
     GLuint mHandle;
         U64 mSizeInByte;
         U32 mElementCount;
+        GLenum mType;
+        std::vector<Range> mRanges;
     };
 }
 
@@ -47,7 +47,7 @@ namespace dma {
             Plane::mPoint = mPoint;
         }
 
-        float distance(const glm::vec3& p);
+        float distance(const glm::vec3& p) const;
     };
 }
 
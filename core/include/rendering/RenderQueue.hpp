@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_RENDERQUEUE_HPP_
+#define _DMA_RENDERQUEUE_HPP_
+
+#include "common/Types.hpp"
+#include "rendering/RenderingPackage.hpp"
+
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Flat list of (package, pass) draw items, sorted on a 64-bit key.
+     *
+     * Opaque items are sorted to minimize GL state changes:
+     *  | pass (4) | program (10) | texture (14) | vertex buffer (12) | depth (24) |
+     * Back-to-front items keep a strict farthest-first order, the pass index
+     * only breaking ties so that the passes of a package stay in order.
+     * With batching, all the back-to-front packages are drawn pass after
+     * pass, still farthest first within a pass: only consecutive packages
+     * sharing a state can be batched, blending stays correct.
+     */
+    class RenderQueue {
+
+    public:
+        enum class SortMode {
+            DISTANCE,   // opaque items front to back first, then by state
+            STATE       // opaque items by state first, then front to back
+        };
+
+        struct Item {
+            U64 key;
+            RenderingPackage* package;
+            const glm::mat4* M;     // the package's, or a copy of it
+            U8 pass;
+        };
+
+        RenderQueue();
+        RenderQueue(const RenderQueue&) = delete;
+        void operator=(const RenderQueue&) = delete;
+        virtual ~RenderQueue();
+
+        inline void setSortMode(SortMode sortMode) { mSortMode = sortMode; }
+        inline SortMode getSortMode() const { return mSortMode; }
+
+        inline void setBatching(bool batching) { mBatching = batching; }
+        inline bool isBatching() const { return mBatching; }
+
+        /**
+         * Adds one item per pass of the package's material.
+         */
+        void push(RenderingPackage* package, bool backToFront, F32 distanceFromCamera);
+
+        /**
+         * Sorts both lists. Must be called once all the packages
+         * of the frame have been pushed.
+         */
+        void sort();
+
+        /**
+         * Moves the items of another queue (e.g. filled by a worker thread)
+         * into this one. Both must use the same sort mode & batching.
+         */
+        void append(RenderQueue& other);
+
+        void clear();
+
+        inline const std::vector<Item>& getOpaqueItems() const { return mOpaque; }
+        inline const std::vector<Item>& getBackToFrontItems() const { return mBackToFront; }
+
+    private:
+        U64 mComputeStateKey(RenderingPackage* package, U8 pass, U32 depth) const;
+        static U64 mComputeState(RenderingPackage* package, U8 pass);
+        static void mRadixSort(std::vector<Item>& items, std::vector<Item>& scratch);
+
+        SortMode mSortMode;
+        bool mBatching;
+        std::vector<Item> mOpaque;
+        std::vector<Item> mBackToFront;
+        std::vector<Item> mScratch;
+    };
+}
+
+#endif //_DMA_RENDERQUEUE_HPP_
@@ -22,27 +22,23 @@
 #include "rendering/Camera.hpp"
 #include "rendering/RenderingPackage.hpp"
 #include "rendering/RenderingComponent.hpp"
+#include "rendering/RenderQueue.hpp"
+#include "rendering/FramePacket.hpp"
+#include "rendering/GLStateCache.hpp"
+#include "rendering/BindingCache.hpp"
 #include "rendering/SkyBox.hpp"
 #include "rendering/Light.hpp"
 #include "HUDSystem.hpp"
 
 #include <list>
-#include <queue>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace dma {
 
     class RenderingEngine {
 
-    private:
-
-        struct Entry {
-            F32 distance;
-            RenderingPackage* renderingPackage;
-            bool operator<(const Entry & other) const {
-                return (distance < other.distance);
-            }
-        };
-
     public:
 
         RenderingEngine(ResourceManager& resourceManager);
@@ -67,10 +63,51 @@ namespace dma {
 
         inline void setLight(const Light& light) { mLight = light; }
 
+        /**
+         * Drops the cached vertex & uniform bindings.
+         * Must be called once meshes and shaders have been refreshed or reloaded.
+         * @param releaseGlObjects false if the GL context has been lost,
+         *        the vertex array objects then being already gone.
+         */
+        void invalidateBindings(bool releaseGlObjects);
+
+        /**
+         * @return true if meshes are drawn through vertex array objects.
+         * Selected at init, according to the context capabilities.
+         */
+        inline bool usesVertexArrays() const { return mUseVertexArrays; }
+
+        /**
+         * Sets how opaque packages are ordered. Back-to-front packages
+         * are always drawn strictly from the farthest to the closest.
+         */
+        void setSortMode(RenderQueue::SortMode sortMode);
+
+        /**
+         * Draws the packages sharing a mesh & a pass setup in a single call,
+         * when the pass' shader has instanced variants (e.g. poi, silhouette).
+         * Back-to-front packages are then drawn pass after pass instead of
+         * package after package. Disabled by default.
+         */
+        void setInstancingEnabled(bool enabled);
+        inline bool isInstancingEnabled() const { return mInstancingEnabled; }
+
         void subscribe(RenderingPackage* package, bool front2back, float distanceFromCamera);
 
         void subscribe(const RenderingComponent* component, float distanceFromCamera);
 
+        /**
+         * Sets the number of render queue shards, merged into the main queue
+         * at the beginning of drawFrame().
+         */
+        void setShardCount(U32 count);
+
+        /**
+         * Same as above, into the given shard. Shards being independent,
+         * each of them can be filled from its own thread.
+         */
+        void subscribe(U32 shard, const RenderingComponent* component, float distanceFromCamera);
+
         void subscribeHUDElement(std::shared_ptr<HUDElement> hudElement);
 
         /**
@@ -79,6 +116,18 @@ namespace dma {
          */
         void drawFrame();
 
+        /**
+         * Sorts the packages subscribed so far into the packet instead of drawing them.
+         * Does not issue any GL call, so that it can run on another thread
+         * than the GL one, provided that drawFramePacket() is not given the same packet meanwhile.
+         */
+        void buildFramePacket(FramePacket& packet);
+
+        /**
+         * Renders a frame built by buildFramePacket().
+         */
+        void drawFramePacket(const FramePacket& packet);
+
         /**
          * Sets the View and the Projection matrices
          */
@@ -90,10 +139,61 @@ namespace dma {
 
         inline F32 getAspectRatio() const { return mAspectRatio; }
 
+        /**
+         * Number of GL state calls issued & filtered out during the last frame.
+         */
+        inline const GLStateCache::Stats& getGLStateStats() const { return mStateCache.getFrameStats(); }
+
     private:
-        void mDraw(RenderingPackage* package, const glm::mat4& V, const glm::mat4& P);
-        void mDrawSkyBox();
+        enum class InstancingMode {
+            NONE,
+            INSTANCED_ARRAYS,   // per-instance attributes (ES3, EXT/ANGLE_instanced_arrays)
+            UNIFORM_ARRAYS      // per-instance uniforms indexed from replicated geometry (ES2)
+        };
+
+        /**
+         * Mesh geometry replicated for pseudo-instancing,
+         * each copy carrying its instance index.
+         */
+        struct InstanceBatch {
+            GLuint vertexBuffer;
+            GLuint instanceIndexBuffer;
+            GLuint indexBuffer;
+            U32 capacity;       // 0 if the mesh cannot be replicated
+            U32 indexCount;     // per instance
+        };
+
+        void mMergeShards();
+        void mCollectHUDItems();
+        void mDrawFrame(const std::vector<RenderQueue::Item>& opaque, const std::vector<RenderQueue::Item>& backToFront,
+                        const glm::mat4& V, const glm::mat4& P,
+                        const std::vector<RenderQueue::Item>& hud, const glm::mat4& hudV, const glm::mat4& hudP);
+        void mDrawItems(const std::vector<RenderQueue::Item>& items, const glm::mat4& V, const glm::mat4& P);
+        void mDraw(RenderingPackage* package, U8 passIndex, const glm::mat4& M, const glm::mat4& V, const glm::mat4& P);
+        size_t mFindInstances(const std::vector<RenderQueue::Item>& items, size_t first) const;
+        bool mDrawInstanced(const RenderQueue::Item* items, U32 count, const glm::mat4& V, const glm::mat4& P);
+        void mDrawInstancedArrays(const BindingRecord& binding, const Mesh& mesh,
+                                  const ShaderProgram& program, U32 count);
+        void mDrawUniformArrays(const BindingRecord& binding, const InstanceBatch& batch,
+                                const ShaderProgram& program, U32 count);
+        void mSetupPass(const Pass& pass);
+        void mSetupPassUniforms(const BindingRecord& binding, Pass& pass, const glm::mat4& V);
+        /**
+         * @param baseOffset added to the offset of each attribute, in bytes
+         */
+        void mSetupAttribs(const BindingRecord& binding, GLuint vertexBuffer, U32 baseOffset = 0);
+        const ShaderProgram* mGetInstancedProgram(const ShaderProgram& program);
+        const InstanceBatch* mGetInstanceBatch(const Mesh& mesh, U32 maxInstances);
+        void mReleaseInstancing(bool releaseGlObjects);
+        /**
+         * Releases what was cached for a mesh dropped by the MeshManager.
+         */
+        void mForgetMesh(U32 meshId);
+        void mDrawSkyBox(const glm::mat4& V, const glm::mat4& P);
+        void mCreateVertexArray(BindingRecord& binding, const Mesh& mesh);
+        void mReleaseSkyBoxVertexArray(bool releaseGlObject);
 
+        ResourceManager& mResourceManager;
         HUDSystem mHUDSystem;
         SkyBox* mSkyBox;
         Light mLight;
@@ -102,9 +202,24 @@ namespace dma {
         U32 mViewportWidth;
         U32 mViewportHeight;
         F32 mAspectRatio;
-        std::priority_queue<Entry> mFrontToBack;
-        std::priority_queue<Entry> mBackToFront;
-        GLuint mAttribIndices[ShaderProgram::AttribSem::AS_size];
+        RenderQueue mRenderQueue;
+        std::vector<std::unique_ptr<RenderQueue>> mShards;
+        std::vector<RenderQueue::Item> mHUDItems;  // rebuilt each frame
+        GLStateCache mStateCache;
+        BindingCache mBindingCache;
+        bool mUseVertexArrays;
+        GLuint mSkyBoxVertexArray;
+        const SkyBox* mSkyBoxVertexArrayOwner;
+        GLuint mSkyBoxVertexArrayBuffer;
+        bool mInstancingEnabled;
+        InstancingMode mInstancingMode;
+        // instanced variants by base program id, nullptr if none
+        std::unordered_map<U32, std::shared_ptr<ShaderProgram>> mInstancedPrograms;
+        // by mesh id
+        std::unordered_map<U32, InstanceBatch> mInstanceBatches;
+        std::vector<glm::mat4> mInstanceMatrices;
+        std::vector<glm::vec3> mInstanceColors;
+        GLuint mInstanceBuffer;
     };
 }
 
@@ -50,6 +50,7 @@ namespace dma {
     private:
         //FIELDS
         friend class RenderingEngine;
+        friend class RenderQueue;
         const glm::mat4& M;
         std::shared_ptr<Mesh> mMesh;
         std::shared_ptr<Material> mMaterial;
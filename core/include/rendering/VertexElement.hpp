@@ -40,6 +40,9 @@ namespace dma {
      * - its offset in the vbo, for example:
      *        if normal is after position and position has
      *        3 GL_FLOAT, offset of normal will be 3 * sizeof(GLfloat)
+     *
+     * Integer types are packed values, read as normalized ([-1, 1] or [0, 1]).
+     * Elements are padded to 4 bytes.
      */
     class VertexElement {
 
@@ -67,12 +70,25 @@ namespace dma {
             mType(type),
             mOffset(offset)
         {
+            assert(getTypeSize(type) != 0);
+            mSizeInByte = (count * getTypeSize(type) + 3) & ~3u;
+        }
+
+        /**
+         * @return the size of a component of the type, 0 if not supported
+         */
+        static inline U32 getTypeSize(GLenum type) {
             switch (type) {
             case GL_FLOAT:
-                mSizeInByte = (U32)(count * sizeof(GLfloat));
-                break;
+                return sizeof(GLfloat);
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+                return sizeof(GLshort);
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return sizeof(GLbyte);
             default:
-                assert(false);
+                return 0;
             }
         }
 
@@ -93,6 +109,9 @@ namespace dma {
         inline U32 getSizeInByte() const {
             return mSizeInByte;
         }
+        inline bool isNormalized() const {
+            return mType != GL_FLOAT;
+        }
 
         const std::string toString() const {
             std::ostringstream oss;
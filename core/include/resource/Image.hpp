@@ -40,13 +40,22 @@ namespace dma {
         Status loadAsPNG(const std::string& filename);
         Status loadAsPNG(const std::string&filename, bool reverse);
         Status loadAsPNG(BYTE* data);
+        /**
+         * Decodes the PNG file content, as loadAsPNG(filename) does.
+         */
+        Status loadAsPNG(const BYTE* data, U32 size, bool reverse = true);
 
         U32 getWidth();
         U32 getHeight();
         GLint getFormat();
         BYTE* getPixels();
+        /**
+         * @return the size of the pixels, in bytes.
+         */
+        U32 getSize() const;
 
     private:
+        Status mReadPng(png_struct* png_ptr, png_info* info_ptr, const std::string& name, bool reverse);
         void mReadPngData(png_struct* png_ptr, GLubyte* data, bool reverse);
 
     private:
@@ -19,6 +19,7 @@
 #define _DMA_MAP_HPP_
 
 #include "resource/Texture.hpp"
+#include "resource/RawImage.hpp"
 #include "utils/GLES2Logger.hpp"
 
 namespace dma {
@@ -34,7 +35,24 @@ namespace dma {
          * /!\ The Map is now responsible for the image life span. (ie: do not delete the pointer yourself)
          */
         inline void setImage(Image* image) {
-            mImage = image;
+            if (mImage != image) {
+                delete mImage;
+                mImage = image;
+            }
+        }
+
+        /**
+         * @return the Image cache, nullptr if none.
+         */
+        inline Image* getImage() const {
+            return mImage;
+        }
+
+        /**
+         * @return false for a map only holding its Image, see setImage.
+         */
+        inline bool isUploaded() const {
+            return mHandle != 0;
         }
 
         Status load(const std::string& filename);
@@ -43,14 +61,34 @@ namespace dma {
          * A copy will be kept in cache.
          */
         Status load(const Image& image);
+
+        /**
+         * Same as above, without copy: the Map takes ownership of the image.
+         */
+        Status load(Image* image);
+
+        /**
+         * Uploads all the levels of the raw image, straight from its mapped pages.
+         * The Map takes ownership of the raw image, kept mapped for refresh().
+         */
+        Status load(RawImage* raw);
         Status refresh(const std::string &filename);
         Status refresh();
 
+        /**
+         * @return the bytes held by the map: its image copy, plus the GL texture
+         *         and its mipmaps (a third more) if uploaded, estimated from the image.
+         *         The mapped pages of a raw image are not counted, only its GL texture.
+         */
+        U32 getMemorySize() const;
+
     private:
 
         Status mLoadFromImage();
+        Status mLoadFromRaw();
 
         Image* mImage;
+        RawImage* mRaw;
 
     };
 }
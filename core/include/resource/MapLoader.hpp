@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_MAPLOADER_HPP_
+#define _DMA_MAPLOADER_HPP_
+
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+#include "resource/RawImage.hpp"
+#include "async/ThreadPool.hpp"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dma {
+
+    /**
+     * Decodes PNG files into Images on worker threads, or maps their raw
+     * decoded copy if up to date. Results wait in a queue until the GL thread pops them.
+     */
+    class MapLoader {
+
+    public:
+        static constexpr U32 DEFAULT_THREAD_COUNT = 2;
+
+        /** decodes the map into the image, on a worker thread */
+        typedef std::function<Status(Image& image)> Decoder;
+
+        struct Result {
+            std::string sid;
+            std::unique_ptr<Image> image;
+            /** instead of the image, if mapped from the decoded cache */
+            std::unique_ptr<RawImage> raw;
+        };
+
+        explicit MapLoader(U32 threadCount = DEFAULT_THREAD_COUNT);
+        MapLoader(const MapLoader&) = delete;
+        void operator=(const MapLoader&) = delete;
+        virtual ~MapLoader();
+
+        /**
+         * Decodes the file in the background, unless the sid is already pending.
+         * @param rawFilename if not empty, the decoded copy of the file: mapped
+         *        if up to date, written after decoding otherwise
+         */
+        void request(const std::string& sid, const std::string& filename,
+                     const std::string& rawFilename = "");
+
+        /**
+         * Same as above, decoding with the given function.
+         * @param source the file the map is read from, its raw copy being up to date if not older
+         */
+        void requestDecode(const std::string& sid, const std::string& source, const Decoder& decode,
+                           const std::string& rawFilename = "");
+
+        /**
+         * Drops the pending request, its image being discarded once decoded.
+         */
+        void cancel(const std::string& sid);
+
+        void cancelAll();
+
+        bool isPending(const std::string& sid) const;
+
+        /**
+         * Pops the oldest decoded image.
+         * @return false if none is ready
+         */
+        bool pop(Result& result);
+
+    private:
+        void mDecode(const std::string& sid, const std::string& source, const Decoder& decode,
+                     const std::string& rawFilename, U32 generation);
+
+        // request generation by pending sid, so that a cancelled then
+        // requested again sid does not take the result of the first request
+        std::map<std::string, U32> mPending;
+        std::list<Result> mReady;
+        U32 mGeneration;
+        mutable std::mutex mMutex;
+        // last, so that the workers are joined first
+        ThreadPool mThreadPool;
+    };
+}
+
+#endif //_DMA_MAPLOADER_HPP_
@@ -18,17 +18,25 @@
 #ifndef ARPIGL_MAPMANAGER_HPP
 #define ARPIGL_MAPMANAGER_HPP
 
+#include <functional>
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 
 #include "resource/Map.hpp"
+#include "resource/MapLoader.hpp"
+#include "resource/TileCache.hpp"
+#include "resource/TilePack.hpp"
 
 namespace dma {
 
     class MapManager {
 
     public:
+        /** @return a time in milliseconds */
+        typedef std::function<F64()> Clock;
+
         MapManager(const std::string& dir);
         virtual ~MapManager();
 
@@ -45,12 +53,112 @@ namespace dma {
         void unload();
         void update();
 
+        /**
+         * @return true if the map is in memory, i.e. acquire() won't hit the disk.
+         */
+        bool isLoaded(const std::string& sid) const;
+
+        /**
+         * Decodes the map on a worker thread. It is then uploaded by uploadDecoded().
+         */
+        void requestAsync(const std::string& sid);
+
+        void cancelAsync(const std::string& sid);
+
+        /**
+         * Uploads the maps decoded so far, until the budget is spent.
+         * At least one map is uploaded if any is ready, whatever its size.
+         * @param uploaded the sids of the maps uploaded, now in memory
+         */
+        void uploadDecoded(std::vector<std::string>& uploaded);
+
+        /**
+         * @param maxBytes the decoded bytes uploaded per call of uploadDecoded()
+         * @param maxMillis the time spent per call of uploadDecoded()
+         */
+        void setUploadBudget(U32 maxBytes, F32 maxMillis);
+
+        /**
+         * The clock the time budget of uploadDecoded() is measured with,
+         * std::chrono::steady_clock by default.
+         */
+        inline void setUploadClock(Clock clock) {
+            mUploadClock = clock;
+        }
+
+        /**
+         * Tile maps no longer displayed are kept in memory until their
+         * bytes (image copy and GL texture) exceed this budget, the least
+         * recently displayed ones being unloaded first by update().
+         */
+        inline void setTileCacheBudget(U64 bytes) {
+            mTileCache.setBudget(bytes);
+        }
+
+        inline const TileCache::Stats& getTileCacheStats() const {
+            return mTileCache.getStats();
+        }
+
+        /**
+         * When disabled, tile maps only hold their Image, without GL texture,
+         * for them to be drawn from a texture atlas. Enabled by default.
+         */
+        void setTileTexturesEnabled(bool enabled);
+
+        /**
+         * Tile maps decoded from PNG are written to this directory as raw images
+         * with their mipmaps, mapped and uploaded as is on later loads
+         * as long as not older than their PNG. Empty to disable (default).
+         */
+        void setDecodedTileDir(const std::string& dir);
+
+        inline const std::string& getDecodedTileDir() const {
+            return mDecodedTileDir;
+        }
+
+        /**
+         * The tiles of the namespace are looked up and read in the pack
+         * before the map directory.
+         */
+        void addTilePack(const std::string& ns, std::shared_ptr<TilePack> pack);
+
+        void removeTilePack(const std::string& ns);
+
     private:
+        static constexpr U32 DEFAULT_UPLOAD_BYTES = 512 * 1024;
+        static constexpr F32 DEFAULT_UPLOAD_MILLIS = 4.0f;
+
         void mLoadMap(std::shared_ptr<Map>, const std::string& sid);
+        void mInsert(const std::string& sid, std::shared_ptr<Map> map, bool requested);
+
+        /**
+         * @return the PNG file of the tile in its namespace pack, nullptr if not packed.
+         */
+        const BYTE* mFindPacked(const std::string& sid, U32& size, std::shared_ptr<TilePack>& pack) const;
+
+        inline bool mIsImageOnly(const std::string& sid) const {
+            return !mTileTextures && TileCache::isTileSid(sid);
+        }
+
+        /**
+         * @return the decoded copy of the map, empty if none is kept.
+         */
+        inline std::string mRawFilename(const std::string& sid) const {
+            return mDecodedTileDir.empty() || !TileCache::isTileSid(sid) ? "" : mDecodedTileDir + sid + ".raw";
+        }
 
         std::map<std::string, std::shared_ptr<Map>> mMaps;
         std::shared_ptr<Map> mFallbackMap;
         std::string mMapDir;
+        std::string mDecodedTileDir;
+        std::map<std::string, std::shared_ptr<TilePack>> mTilePacks;
+        /** created on the first asynchronous request */
+        std::unique_ptr<MapLoader> mLoader;
+        U32 mUploadBytes;
+        F32 mUploadMillis;
+        Clock mUploadClock;
+        TileCache mTileCache;
+        bool mTileTextures;
     };
 }
 
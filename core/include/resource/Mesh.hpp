@@ -37,6 +37,7 @@ namespace dma {
 
     protected:
         friend class MeshManager;
+        friend class MeshFile;
 
         Mesh(const Mesh&) = delete;
         void operator=(const Mesh&) = delete;
@@ -45,6 +46,12 @@ namespace dma {
         inline const std::string& getSID() const {
             return mSID;
         }
+        /**
+         * Process-wide unique id, never reused (unlike addresses & GL names).
+         */
+        inline U32 getId() const {
+            return mId;
+        }
         inline bool hasFlatNormals() const {
             return hasVertexElement(VertexElement::Semantic::FLAT_NORMAL);
         }
@@ -72,6 +79,35 @@ namespace dma {
 
         inline const BoundingSphere& getBoundingSphere() const { return mBoundingSphere; }
 
+        /**
+         * Maps the stored positions to model space: identity, unless they
+         * are packed, i.e. quantized to the bounding sphere.
+         */
+        inline const glm::mat4& getDecodeMatrix() const { return mDecodeMatrix; }
+
+        /**
+         * The uniform scale of the decode matrix, to express model space
+         * lengths in the stored positions' units.
+         */
+        inline F32 getDecodeScale() const { return mDecodeMatrix[0][0]; }
+
+        /**
+         * Copies of the vertex & index buffers content, kept to build
+         * replicated geometry (pseudo-instancing). Empty once the cache is cleared.
+         */
+        inline const std::vector<BYTE>& getVertexData() const { return vertexData; }
+        inline const std::vector<BYTE>& getIndexData() const { return indexData; }
+
+        /**
+         * GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT for more than 65536 vertices.
+         */
+        inline GLenum getIndexType() const {
+            return mIndexType;
+        }
+        inline U32 getIndexCount() const {
+            return (U32) (indexData.size() / IndexBuffer::getTypeSize(mIndexType));
+        }
+
         /**
          * Clear OpenGL resources
          */
@@ -82,26 +118,38 @@ namespace dma {
         void addVertexElement(const VertexElement& vertexElement);
 
         inline const bool hasCache() {
-            return !positions.empty();
+            return !vertexData.empty();
         }
 
         void clearCache();
 
+        /**
+         * Stores the indices with the narrowest type addressing all the vertices.
+         * The vertex count must be set.
+         */
+        void setIndexData(const std::vector<U32>& indices);
+
+        /**
+         * To be called once the vertex elements & the bounding sphere are set.
+         */
+        void updateDecodeMatrix();
+
         //FIELDS
+        const U32 mId;
         std::string mSID;
         VertexElement mVertexElements[VertexElement::Semantic::SIZE];
         U32 mVertexSemFlags;
         U32 mVertexSize;
         U32 mVertexCount;
+        GLenum mIndexType;
         std::shared_ptr<VertexBuffer> mVertexBuffer;
         std::shared_ptr<IndexBuffer> mIndexBuffer;
         BoundingSphere mBoundingSphere;
+        glm::mat4 mDecodeMatrix;
 
-        //Cache variables
-        std::vector<glm::vec3> positions;
-        std::vector<glm::vec2> uvs;
-        std::vector<glm::vec3> flatNormals;
-        std::vector<VertexIndices> vertexIndices;
+        //Cache variables, uploaded again on refresh
+        std::vector<BYTE> vertexData;
+        std::vector<BYTE> indexData;
     };
 }
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_MESHFILE_HPP_
+#define _DMA_MESHFILE_HPP_
+
+#include "common/Types.hpp"
+
+#include <string>
+
+namespace dma {
+
+    class Mesh;
+
+    /**
+     * A mesh file in a GPU-ready layout: the interleaved vertices and the indices
+     * as uploaded to the vertex and index buffers, read with no parsing.
+     * Written from OBJ files by the arpigl-convert-meshes tool.
+     *
+     * Layout, native endianness:
+     * "DMAM", version, vertex size, vertex count, index count, index size (2 or 4),
+     * element count (U32 each), then a (semantic, count, GL type, offset) quadruplet
+     * of U32 per vertex element, then the bounding sphere center & radius (F32 each),
+     * then the vertices and the indices, 4-byte aligned. Packed positions
+     * are quantized to that bounding sphere.
+     */
+    class MeshFile {
+
+    public:
+        static constexpr U32 VERSION = 1;
+
+        /**
+         * Writes the vertices and indices of the mesh, as built by MeshManager::buildFromObj.
+         * The file is written aside then renamed, never being seen incomplete.
+         */
+        static Status write(const std::string& filename, const Mesh& mesh);
+
+        /**
+         * Reads the file into the vertex & index data of the mesh, to be uploaded.
+         */
+        static Status read(const std::string& filename, Mesh& mesh);
+
+        /**
+         * @return true if the mesh file exists and is not older than its source,
+         *         or if the source doesn't exist.
+         */
+        static bool isUpToDate(const std::string& filename, const std::string& source);
+
+    private:
+        MeshFile() = delete;
+    };
+}
+
+#endif //_DMA_MESHFILE_HPP_
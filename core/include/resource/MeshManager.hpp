@@ -18,6 +18,7 @@
 #ifndef _DMA_MESHMANAGER_HPP_
 #define _DMA_MESHMANAGER_HPP_
 
+#include <functional>
 #include <string>
 #include <map>
 #include <vector>
@@ -41,6 +42,11 @@ namespace dma {
 
 
     public:
+        static constexpr F32 DEFAULT_SMOOTHING_ANGLE = 180.0f;
+
+        /** called with each unused mesh dropped by update(), before it is wiped */
+        typedef std::function<void(const Mesh& mesh)> DropListener;
+
         virtual ~MeshManager();
 
         /**
@@ -85,6 +91,41 @@ namespace dma {
 
         bool hasResource(const std::string &) const;
 
+        /**
+         * Builds the interleaved vertices and the indices of an OBJ file into
+         * the mesh's data, without uploading them. Used by the mesh converter.
+         * @param smoothingAngle see setSmoothingAngle
+         * @param packed see setPackedVertices
+         */
+        static Status buildFromObj(const std::string& filename, Mesh& mesh,
+                                   F32 smoothingAngle = DEFAULT_SMOOTHING_ANGLE,
+                                   bool packed = false);
+
+        /**
+         * Smooth normals average the flat normals around a vertex, across the
+         * edges whose faces are within this angle, in degrees: below 180, sharp
+         * edges stay sharp. Applies to the OBJ files loaded afterwards, mesh files
+         * holding the normals they were converted with. 180 by default.
+         */
+        inline void setSmoothingAngle(F32 degrees) {
+            mSmoothingAngle = degrees;
+        }
+
+        /**
+         * Packed vertices store positions as 16-bit integers quantized to the
+         * bounding sphere, normals as 8-bit integers and UVs within [0, 1] as
+         * 16-bit integers, about half the size of floats. Applies to the OBJ
+         * files loaded afterwards, mesh files keeping the layout they were
+         * converted with. Off by default.
+         */
+        inline void setPackedVertices(bool packed) {
+            mPackedVertices = packed;
+        }
+
+        inline void setDropListener(const DropListener& listener) {
+            mDropListener = listener;
+        }
+
     private:
         MeshManager(const std::string& rootDir);
         MeshManager(const MeshManager&) = delete;
@@ -93,17 +134,32 @@ namespace dma {
         //METHODS
         //Mesh* mLoad(const std::string& sid, bool* result) const;
         //Mesh* mLoad(Mesh* mesh, const std::string& sid, bool* result) const;
+        /**
+         * Reads <sid>.mesh if not older than <sid>.obj, parses <sid>.obj otherwise,
+         * unless the mesh's data is cached. Then uploads it.
+         */
         Status mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid) const;
-        Status mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid,
-                     std::vector<glm::vec3> &positions,
-                     std::vector<glm::vec2>& uvs,
-                     std::vector<glm::vec3>& flatNormals,
-                     std::vector<VertexIndices>& vertexIndices) const;
+
+        static Status mBuild(Mesh& mesh,
+                             std::vector<glm::vec3> &positions,
+                             std::vector<glm::vec2>& uvs,
+                             std::vector<glm::vec3>& flatNormals,
+                             std::vector<VertexIndices>& vertexIndices,
+                             F32 smoothingAngle,
+                             bool packed);
+
+        /**
+         * Creates the GL buffers out of the mesh's data.
+         */
+        static void mUpload(Mesh& mesh);
 
         // FIELDS
         std::map<std::string, std::shared_ptr<Mesh>> mMeshes;
         std::shared_ptr<Mesh> mFallbackMesh;
         std::string mLocalDir;
+        F32 mSmoothingAngle;
+        bool mPackedVertices;
+        DropListener mDropListener;
     };
 }
 
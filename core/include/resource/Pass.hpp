@@ -111,6 +111,10 @@ namespace dma {
             return (mFuncFlags & (1L << func)) != 0;
         }
 
+        inline U32 getFuncFlags() const {
+            return mFuncFlags;
+        }
+
     private:
         void addFunc(Func func);
         void removeFunc(Func func);
@@ -31,8 +31,17 @@ namespace dma {
         friend class ResourceManager;
 
     public:
+        /** in the quad's unscaled units, i.e. meters for tiles */
+        static constexpr F32 SKIRT_DEPTH = 2.0f;
+
         std::shared_ptr<Quad> createQuad(F32 width, F32 height);
 
+        /**
+         * Same as createQuad, with a skirt hanging SKIRT_DEPTH below its edges,
+         * hiding the cracks between adjacent quads.
+         */
+        std::shared_ptr<Quad> createSkirtedQuad(F32 width, F32 height);
+
     private:
         QuadFactory();
         virtual ~QuadFactory();
@@ -67,8 +76,11 @@ namespace dma {
         //FIELDS
         U32 mVertexSize;
         U32 mVertexCount;
+        U32 mSkirtVertexCount;
         std::shared_ptr<VertexBuffer> mVertexBuffer;
         std::shared_ptr<IndexBuffer> mIndexBuffer;
+        std::shared_ptr<VertexBuffer> mSkirtVertexBuffer;
+        std::shared_ptr<IndexBuffer> mSkirtIndexBuffer;
     };
 }
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_RAWIMAGE_HPP_
+#define _DMA_RAWIMAGE_HPP_
+
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+
+#include <string>
+
+namespace dma {
+
+    /**
+     * An image file in a GPU-ready layout: the pixels of each mipmap level,
+     * uncompressed, as expected by glTexImage2D. The file is memory-mapped,
+     * so that the levels are uploaded straight from the mapped pages.
+     *
+     * Layout, native endianness:
+     * "DMAR", version, width, height, GL format, level count (U32 each),
+     * then an (offset, size) pair of U32 per level, then the levels, 4-byte aligned.
+     * All the levels down to 1x1 are stored.
+     */
+    class RawImage {
+
+    public:
+        static constexpr U32 VERSION = 1;
+
+        RawImage();
+        RawImage(const RawImage&) = delete;
+        void operator=(const RawImage&) = delete;
+        ~RawImage();
+
+        /**
+         * Writes the image with its full mipmap chain, computed with a box filter.
+         * The file is written aside then renamed, never being seen incomplete.
+         */
+        static Status write(const std::string& filename, Image& image);
+
+        /**
+         * @return true if the raw file exists and is not older than its source,
+         *         or if the source doesn't exist.
+         */
+        static bool isUpToDate(const std::string& filename, const std::string& source);
+
+        /**
+         * Maps the file in memory.
+         */
+        Status map(const std::string& filename);
+
+        void unmap();
+
+        inline U32 getWidth() const { return mWidth; }
+        inline U32 getHeight() const { return mHeight; }
+        inline GLint getFormat() const { return mFormat; }
+        inline U32 getLevelCount() const { return mLevelCount; }
+
+        /**
+         * @return the pixels of the level, in the mapped pages.
+         */
+        const BYTE* getLevel(U32 level, U32& width, U32& height) const;
+
+        /**
+         * @return the bytes of all levels.
+         */
+        U32 getSize() const;
+
+        /**
+         * @return a copy of the first level.
+         */
+        Image* toImage() const;
+
+    private:
+        BYTE* mData;
+        size_t mMappedSize;
+        U32 mWidth;
+        U32 mHeight;
+        GLint mFormat;
+        U32 mLevelCount;
+        const U32* mLevels; // (offset, size) pairs
+    };
+}
+
+#endif //_DMA_RAWIMAGE_HPP_
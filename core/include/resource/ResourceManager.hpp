@@ -170,6 +170,17 @@ namespace dma {
         }
 
 
+        //--------------------------------------------------------------------------
+        /**
+         * @return the variant of the ShaderProgram, or nullptr if it has none
+         * @see ShaderManager::acquireVariant
+         */
+        inline std::shared_ptr<ShaderProgram> acquireShaderProgramVariant(const std::string& sid,
+                                                                          const std::string& variant) {
+            return mShaderManager.acquireVariant(sid, variant);
+        }
+
+
         //--------------------------------------------------------------------------
         /**
          * @return true if the corresponding mesh exists.
@@ -179,6 +190,29 @@ namespace dma {
         }
 
 
+        //--------------------------------------------------------------------------
+        /**
+         * @see MeshManager::setSmoothingAngle
+         */
+        inline void setMeshSmoothingAngle(F32 degrees) {
+            mMeshManager.setSmoothingAngle(degrees);
+        }
+
+        /**
+         * @see MeshManager::setPackedVertices
+         */
+        inline void setPackedMeshVertices(bool packed) {
+            mMeshManager.setPackedVertices(packed);
+        }
+
+        /**
+         * @see MeshManager::setDropListener
+         */
+        inline void setMeshDropListener(const MeshManager::DropListener& listener) {
+            mMeshManager.setDropListener(listener);
+        }
+
+
         //--------------------------------------------------------------------------
         /**
          * @param const std::string& -
@@ -215,6 +249,103 @@ namespace dma {
         }
 
 
+        //--------------------------------------------------------------------------
+        /**
+         * @return true if the map is in memory, acquireMap() then being immediate.
+         */
+        inline bool isMapLoaded(const std::string& sid) const {
+            return mMapManager.isLoaded(sid);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * Decodes the map in the background. Once decoded, it is uploaded by
+         * uploadMaps(), and can then be acquired without hitting the disk.
+         */
+        inline void requestMap(const std::string& sid) {
+            mMapManager.requestAsync(sid);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline void cancelMapRequest(const std::string& sid) {
+            mMapManager.cancelAsync(sid);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * Uploads the maps decoded in the background, within the upload budget.
+         * Must be called from the GL thread.
+         * @param uploaded the sids of the maps uploaded
+         */
+        inline void uploadMaps(std::vector<std::string>& uploaded) {
+            mMapManager.uploadDecoded(uploaded);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline void setMapUploadBudget(U32 maxBytes, F32 maxMillis) {
+            mMapManager.setUploadBudget(maxBytes, maxMillis);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline void setMapUploadClock(MapManager::Clock clock) {
+            mMapManager.setUploadClock(clock);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline void setTileCacheBudget(U64 bytes) {
+            mMapManager.setTileCacheBudget(bytes);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline const TileCache::Stats& getTileCacheStats() const {
+            return mMapManager.getTileCacheStats();
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @see MapManager::setTileTexturesEnabled
+         */
+        inline void setTileTexturesEnabled(bool enabled) {
+            mMapManager.setTileTexturesEnabled(enabled);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @see MapManager::setDecodedTileDir
+         */
+        inline void setDecodedTileDir(const std::string& dir) {
+            mMapManager.setDecodedTileDir(dir);
+        }
+
+        inline const std::string& getDecodedTileDir() const {
+            return mMapManager.getDecodedTileDir();
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @see MapManager::addTilePack
+         */
+        inline void addTilePack(const std::string& ns, std::shared_ptr<TilePack> pack) {
+            mMapManager.addTilePack(ns, pack);
+        }
+
+
+        //--------------------------------------------------------------------------
+        inline void removeTilePack(const std::string& ns) {
+            mMapManager.removeTilePack(ns);
+        }
+
+
         //--------------------------------------------------------------------------
         /**
          * @param const std::string&
@@ -280,6 +411,15 @@ namespace dma {
             return mQuadFactory.createQuad(width, height);
         }
 
+
+        //--------------------------------------------------------------------------
+        /**
+         * Same as createQuad, with a skirt below its edges, see QuadFactory::createSkirtedQuad.
+         */
+        inline std::shared_ptr<Quad> createSkirtedQuad(F32 width, F32 height) {
+            return mQuadFactory.createSkirtedQuad(width, height);
+        }
+
         //--------------------------------------------------------------------------
         /**
          * Updates all resources: ie unload unused resources
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <map>
+#include <set>
 
 #include "resource/IResourceManager.hpp"
 #include "resource/ShaderProgram.hpp"
@@ -34,6 +35,13 @@ namespace dma {
         friend class ResourceManager;
 
     public:
+        /**
+         * Variants of the shaders that support instancing, that is
+         * whose vertex source checks for DMA_INSTANCING.
+         */
+        static const std::string INSTANCED_VARIANT;        // per-instance attributes
+        static const std::string INSTANCE_ARRAYS_VARIANT;  // per-instance uniform arrays
+
         virtual ~ShaderManager();
 
         /**
@@ -50,6 +58,13 @@ namespace dma {
          */
         std::shared_ptr<ShaderProgram> acquire(const std::string& sid, Status* result);
 
+        /**
+         * @param sid SID of the base shader.
+         * @param variant INSTANCED_VARIANT or INSTANCE_ARRAYS_VARIANT.
+         * @return the variant of the shader, or nullptr if the shader has no such variant.
+         */
+        std::shared_ptr<ShaderProgram> acquireVariant(const std::string& sid, const std::string& variant);
+
         /**
          * From disk
          */
@@ -110,11 +125,20 @@ namespace dma {
          **/
         GLuint mCompile(const std::string &source, GLenum type) const;
 
+        /**
+         * Returns the #define lines to prepend to the sources of a variant,
+         * empty if the variant is unknown.
+         */
+        std::string mVariantHeader(const std::string& variant, U32* maxInstances) const;
+
     private:
         static const std::string FALLBACK_SHADER_SID;
+        static constexpr char VARIANT_SEPARATOR = '#';
+        static constexpr U32 MAX_UNIFORM_INSTANCES = 64;
 
         std::map<std::string, std::shared_ptr<ShaderProgram>> mShaderPrograms;
         std::shared_ptr<ShaderProgram> mFallbackShaderProgram;
+        std::set<std::string> mMissingVariants;
         std::string mLocalDir;
     };
 
@@ -35,7 +35,10 @@ namespace dma {
             POS = 0,
             NORMAL = 1,
             UV = 2,
-            AS_size = 3
+            INSTANCE_M = 3,      // mat4, spans 4 consecutive locations
+            INSTANCE_COLOR = 4,
+            INSTANCE_INDEX = 5,
+            AS_size = 6
         };
         enum UniformSem
         {
@@ -51,7 +54,12 @@ namespace dma {
             LIGHT0_AMBIENT = 9,
             LIGHT0_DIFFUSE = 10,
             LIGHT0_SPECULAR = 11,
-            US_size = 12
+            V = 12,
+            P = 13,
+            INSTANCE_M_ARRAY = 14,      // arrays of getMaxInstances() elements
+            INSTANCE_COLOR_ARRAY = 15,
+            DECODE_SCALE = 16,
+            US_size = 17
         };
 
         ShaderProgram();
@@ -69,6 +77,22 @@ namespace dma {
     public:
         inline GLuint getHandle() const {return mHandle;}
 
+        /**
+         * Process-wide unique id, never reused (unlike addresses & GL names).
+         */
+        inline U32 getId() const {return mId;}
+
+        /**
+         * SID the program was loaded from, variant suffix included.
+         */
+        inline const std::string& getSID() const {return mSID;}
+
+        /**
+         * Size of the per-instance uniform arrays, 0 if the program
+         * does not read its instances from uniforms.
+         */
+        inline U32 getMaxInstances() const {return mMaxInstances;}
+
         inline U32 getAttributeFlags() const {
             return mAttributeFlags;
         }
@@ -120,6 +144,9 @@ namespace dma {
     private:
         static const std::string attributeNames[AS_size];
         static const std::string uniformNames[US_size];
+        const U32 mId;
+        std::string mSID;
+        U32 mMaxInstances;
         GLuint mHandle;
         //The attribute flags
         U32 mAttributeFlags;
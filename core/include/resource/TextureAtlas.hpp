@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_TEXTUREATLAS_HPP_
+#define _DMA_TEXTUREATLAS_HPP_
+
+#include "resource/Map.hpp"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+namespace dma {
+
+    /**
+     * A square RGBA texture divided into fixed square slots, filled with
+     * glTexSubImage2D. Slots are reused as they are, without allocating GL objects.
+     * No mipmaps, so that slots don't bleed into each other.
+     */
+    class TextureAtlas : public Map {
+
+    public:
+        TextureAtlas(U32 slotSize, U32 slotsPerRow);
+        virtual ~TextureAtlas();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        void operator=(const TextureAtlas&) = delete;
+
+        /**
+         * Creates the GL texture, its content being undefined until uploaded.
+         * After a context loss, the slots must be uploaded again.
+         * @return STATUS_KO if larger than GL_MAX_TEXTURE_SIZE
+         */
+        Status create();
+
+        /**
+         * Copies the image into the slot. Images of another size or format are
+         * converted, sampling the nearest pixels.
+         */
+        Status upload(U32 slot, Image& image);
+
+        /**
+         * @return the slot's (u0, v0, u1, v1) texture coordinates, inset by half a
+         *         texel so that linear filtering stays within the slot.
+         */
+        glm::vec4 getSlotRect(U32 slot) const;
+
+        inline U32 getSlotCount() const {
+            return mSlotsPerRow * mSlotsPerRow;
+        }
+
+        /**
+         * @return the width and height of the texture, in pixels.
+         */
+        inline U32 getSize() const {
+            return mSlotSize * mSlotsPerRow;
+        }
+
+    private:
+        U32 mSlotSize;
+        U32 mSlotsPerRow;
+        /** converted pixels */
+        std::vector<BYTE> mScratch;
+    };
+}
+
+#endif //_DMA_TEXTUREATLAS_HPP_
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_TILECACHE_HPP_
+#define _DMA_TILECACHE_HPP_
+
+#include "common/Types.hpp"
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace dma {
+
+    /**
+     * Least-recently-used bookkeeping of the tile maps kept in memory,
+     * under a byte budget. The maps themselves stay in the MapManager,
+     * which evicts the ones this cache designates.
+     */
+    class TileCache {
+
+    public:
+        static constexpr U64 DEFAULT_BUDGET = 48 * 1024 * 1024;
+
+        struct Stats {
+            U32 hits;
+            U32 misses;
+            U32 evictions;
+            U64 bytes;      // currently cached
+        };
+
+        /**
+         * @return true for the SIDs of tile maps, i.e. tiles/<ns>/z/x/y
+         */
+        static bool isTileSid(const std::string& sid);
+
+        TileCache();
+        TileCache(const TileCache&) = delete;
+        void operator=(const TileCache&) = delete;
+        virtual ~TileCache();
+
+        /**
+         * Adds the entry as the most recently used one.
+         * @param requested true if loaded for a request already counted as a miss,
+         *        its next touch() then not being counted as a hit.
+         */
+        void add(const std::string& sid, U64 bytes, bool requested = false);
+
+        /**
+         * Marks the entry as the most recently used one, counting a hit.
+         * @return false if not cached
+         */
+        bool touch(const std::string& sid);
+
+        void remove(const std::string& sid);
+
+        void clear();
+
+        /**
+         * Evicts least recently used entries until within the budget.
+         * @param evict called for each candidate, from the least recently used one;
+         *        returns false if the entry cannot be evicted (e.g. still displayed)
+         */
+        void shrink(const std::function<bool(const std::string& sid)>& evict);
+
+        inline void miss() { ++mStats.misses; }
+
+        inline void setBudget(U64 bytes) { mBudget = bytes; }
+        inline U64 getBudget() const { return mBudget; }
+
+        inline const Stats& getStats() const { return mStats; }
+
+    private:
+        struct Entry {
+            std::list<std::string>::iterator position;
+            U64 bytes;
+            bool requested;
+        };
+
+        /** most recently used first */
+        std::list<std::string> mLru;
+        std::unordered_map<std::string, Entry> mEntries;
+        U64 mBudget;
+        Stats mStats;
+    };
+}
+
+#endif //_DMA_TILECACHE_HPP_
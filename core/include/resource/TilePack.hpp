@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_TILEPACK_HPP_
+#define _DMA_TILEPACK_HPP_
+
+#include "common/Types.hpp"
+
+#include <string>
+
+namespace dma {
+
+    /**
+     * A single file holding the PNG files of a tile namespace, memory-mapped
+     * once: looking up and reading a tile then costs no system call.
+     *
+     * Layout, native endianness:
+     * "DMAT", version, tile count, 0 (U32 each),
+     * then the index entries sorted by key, then the PNG files.
+     */
+    class TilePack {
+
+    public:
+        static constexpr U32 VERSION = 1;
+
+        /**
+         * @return the index key of the tile, zoom levels up to 29.
+         */
+        static inline U64 key(int x, int y, int z) {
+            return ((U64) z << 58) | ((U64) x << 29) | (U64) y;
+        }
+
+        /**
+         * Packs the tiles of a directory laid out as <dir>/z/x/y.png.
+         */
+        static Status write(const std::string& dir, const std::string& filename);
+
+        TilePack();
+        TilePack(const TilePack&) = delete;
+        void operator=(const TilePack&) = delete;
+        ~TilePack();
+
+        /**
+         * Maps the file in memory.
+         */
+        Status open(const std::string& filename);
+
+        void close();
+
+        inline bool contains(int x, int y, int z) const {
+            return mFind(key(x, y, z)) != nullptr;
+        }
+
+        /**
+         * @return the PNG file of the tile, in the mapped pages, nullptr if not packed.
+         */
+        const BYTE* find(int x, int y, int z, U32& size) const;
+
+        inline U32 getTileCount() const { return mCount; }
+        inline const std::string& getFilename() const { return mFilename; }
+
+    private:
+        struct Entry {
+            U64 key;
+            U64 offset;
+            U32 size;
+            U32 reserved;
+        };
+
+        const Entry* mFind(U64 key) const;
+
+        BYTE* mData;
+        size_t mMappedSize;
+        const Entry* mEntries;
+        U32 mCount;
+        std::string mFilename;
+    };
+}
+
+#endif //_DMA_TILEPACK_HPP_
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_GLEXTENSIONS_HPP_
+#define _DMA_GLEXTENSIONS_HPP_
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+namespace dma {
+
+    /**
+     * Entry points of the optional GL extensions used by the engine.
+     * Pointers are null when the extension is not available.
+     */
+    class GLExtensions {
+
+    public:
+        /**
+         * Resolves the entry points for the current context.
+         * Must be called again whenever the context is recreated.
+         */
+        static void load();
+
+        static inline bool hasVertexArrayObject() {
+            return genVertexArrays && bindVertexArray && deleteVertexArrays;
+        }
+
+        static inline bool hasInstancedArrays() {
+            return drawElementsInstanced && vertexAttribDivisor;
+        }
+
+        /**
+         * GL_UNSIGNED_INT indices
+         */
+        static inline bool hasElementIndexUint() {
+            return elementIndexUint;
+        }
+
+        /**
+         * Platform specific (eglGetProcAddress, glfwGetProcAddress...)
+         */
+        static void* getProcAddress(const char* name);
+
+        // OES_vertex_array_object, or core in ES3 / desktop GL
+        static PFNGLGENVERTEXARRAYSOESPROC genVertexArrays;
+        static PFNGLBINDVERTEXARRAYOESPROC bindVertexArray;
+        static PFNGLDELETEVERTEXARRAYSOESPROC deleteVertexArrays;
+
+        // EXT_instanced_arrays, ANGLE_instanced_arrays, or core in ES3
+        static PFNGLDRAWELEMENTSINSTANCEDEXTPROC drawElementsInstanced;
+        static PFNGLVERTEXATTRIBDIVISOREXTPROC vertexAttribDivisor;
+
+        // OES_element_index_uint, or core in ES3 / desktop GL
+        static bool elementIndexUint;
+    };
+}
+
+#endif //_DMA_GLEXTENSIONS_HPP_
@@ -19,6 +19,7 @@
 #define _DMA_GEOUTILS_HPP_
 
 #include <cmath>
+#include <stdint.h>
 #include <engine/geo/LatLng.hpp>
 
 namespace dma {
@@ -40,6 +41,24 @@ namespace dma {
             }
 
 
+            //---------------------------------------------------------------------------
+            /**
+             * Same as lng2tilex, keeping the position within the tile.
+             */
+            static inline double lng2tilexf(double lon, int z) {
+                return (lon + 180.0) / 360.0 * (double)(1 << z);
+            }
+
+
+            //---------------------------------------------------------------------------
+            /**
+             * Same as lat2tiley, keeping the position within the tile.
+             */
+            static inline double lat2tileyf(double lat, int z) {
+                return (1.0 - log( tan(lat * M_PI/180.0) + 1.0 / cos(lat * M_PI/180.0)) / M_PI) / 2.0 * (double)(1 << z);
+            }
+
+
             //---------------------------------------------------------------------------
             static inline double tilex2long(int x, int z) {
                 return x / (double)(1 << z) * 360.0 - 180;
@@ -52,6 +71,14 @@ namespace dma {
                 return 180.0 / M_PI * atan(0.5 * (exp(n) - exp(-n)));
             }
 
+            //---------------------------------------------------------------------------
+            /**
+             * @return the tile coordinates packed in an integer, zoom levels up to 29.
+             */
+            static inline uint64_t tileKey(int x, int y, int z) {
+                return ((uint64_t) z << 58) | ((uint64_t) x << 29) | (uint64_t) y;
+            }
+
             //------------------------------------------------------------------------------
             /**
             * Spherical Law of Cosines
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _DMA_OBJPARSER_HPP_
+#define _DMA_OBJPARSER_HPP_
+
+#include "common/Types.hpp"
+#include "utils/VertexIndices.hpp"
+#include "glm/glm.hpp"
+
+#include <string>
+#include <vector>
+
+namespace dma {
+
+    /**
+     * Parses an OBJ file in a single pass over its memory-mapped content,
+     * with no allocation per line. Polygons are triangulated as fans, and
+     * negative (relative) indices are resolved. Unlike ObjReader, the
+     * sections need not be contiguous.
+     */
+    class ObjParser {
+
+    public:
+        /**
+         * Appends the content of the file to the vectors, reserved up front.
+         * Indices are 0-based, VertexIndices::NONE for a missing uv or normal.
+         */
+        static Status parseFile(const std::string& filename,
+                                std::vector<glm::vec3>& positions,
+                                std::vector<glm::vec2>& uvs,
+                                std::vector<glm::vec3>& normals,
+                                std::vector<VertexIndices>& vertexIndices);
+
+        static Status parse(const char* data, size_t size,
+                            std::vector<glm::vec3>& positions,
+                            std::vector<glm::vec2>& uvs,
+                            std::vector<glm::vec3>& normals,
+                            std::vector<VertexIndices>& vertexIndices);
+
+    private:
+        ObjParser() = delete;
+    };
+}
+
+#endif //_DMA_OBJPARSER_HPP_
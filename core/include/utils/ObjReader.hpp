@@ -46,7 +46,7 @@ namespace dma {
             bool nextPosition(glm::vec3& position);
             bool nextNormal(glm::vec3& normal);
             bool nextUV(glm::vec2& );
-            bool nextFace(U16 face[3][3]);
+            bool nextFace(U32 face[3][3]);
 
         private:
             std::ifstream mInputStream;
@@ -62,6 +62,18 @@ namespace dma {
 
         static bool dirExists(const char *path);
 
+        /**
+         * Creates the directory and its missing parents, like mkdir -p.
+         * @return true if the directory exists afterwards.
+         */
+        static bool makeDirs(const std::string& path);
+
+        /**
+         * @return the last modification time of the file, in seconds since epoch,
+         *         or -1 if it doesn't exist.
+         */
+        static I64 getModificationTime(const std::string& path);
+
         /**
          * @return true if the given file exists.
          */
@@ -23,14 +23,29 @@
 namespace dma {
 
     struct VertexIndices {
-        U16 p, uv, fn, sn;
+        /** a missing uv or normal */
+        static constexpr U32 NONE = 0xFFFFFFFF;
 
-        VertexIndices() : p(0xFFFF), uv(0xFFFF), fn(0xFFFF), sn(0xFFFF)
+        U32 p, uv, fn, sn;
+
+        VertexIndices() : p(NONE), uv(NONE), fn(NONE), sn(NONE)
         {}
 
-        VertexIndices(U16 p, U16 uv, U16 fn) : p(p), uv(uv), fn(fn), sn(0xFFFF)
+        VertexIndices(U32 p, U32 uv, U32 fn) : p(p), uv(uv), fn(fn), sn(NONE)
         {}
 
+        inline bool operator==(const VertexIndices& other) const {
+            return p == other.p && uv == other.uv && fn == other.fn && sn == other.sn;
+        }
+
+        /**
+         * @return a hash of the four indices.
+         */
+        inline U64 hash() const {
+            U64 h = ((U64) p << 32 | uv) * 0x9E3779B97F4A7C15ull;
+            return (h ^ ((U64) fn << 32 | sn)) * 0xC2B2AE3D27D4EB4Full;
+        }
+
         bool operator<(const VertexIndices& other) const {
             if(p < other.p) {
                 return true;
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "async/ThreadPool.hpp"
+#include "utils/Log.hpp"
+
+
+constexpr auto TAG = "ThreadPool";
+
+namespace dma {
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    ThreadPool::ThreadPool(U32 threadCount) :
+            mStopped(false)
+    {
+        Log::trace(TAG, "Starting %u threads", threadCount);
+        for (U32 i = 0; i < threadCount; ++i) {
+            mThreads.push_back(std::thread(&ThreadPool::mRun, this));
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopped = true;
+            mTasks.clear();
+        }
+        mCondition.notify_all();
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void ThreadPool::post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push_back(task);
+        }
+        mCondition.notify_one();
+    }
+
+
+    //------------------------------------------------------------------------
+    void ThreadPool::parallelFor(U32 count, const RangeTask& task) {
+        U32 workers = getWorkerCount();
+        if (count < 2 || workers == 1) {
+            task(0, 0, count);
+            return;
+        }
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        U32 pending = workers - 1;
+        for (U32 worker = 1; worker < workers; ++worker) {
+            U32 begin = (U32) ((U64) count * worker / workers);
+            U32 end = (U32) ((U64) count * (worker + 1) / workers);
+            post([&, worker, begin, end]() {
+                if (begin < end) {
+                    task(worker, begin, end);
+                }
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--pending == 0) {
+                    doneCondition.notify_one();
+                }
+            });
+        }
+        if (count / workers > 0) {
+            task(0, 0, count / workers);
+        }
+
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCondition.wait(lock, [&]() { return pending == 0; });
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void ThreadPool::mRun() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() { return mStopped || !mTasks.empty(); });
+                if (mStopped) {
+                    return;
+                }
+                task = mTasks.front();
+                mTasks.pop_front();
+            }
+            task();
+        }
+    }
+}
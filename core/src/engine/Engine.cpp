@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <sstream>
 #include <algorithm>
+#include <future>
 // Dma
 #include "engine/Engine.hpp"
 #include "engine/geo/Poi.hpp"
@@ -38,7 +39,10 @@ namespace dma {
     //---------------------------------------------------------------------------------
     Engine::Engine(const std::string& rootDir) :
             mRootDir(rootDir),
-            mIsInit(false) {
+            mIsInit(false),
+            mUpdateThreadPool(nullptr),
+            mSimulationThread(nullptr),
+            mFrontPacket(0) {
         Log::trace(TAG, "Creating Engine...");
 
         mRootDir = Utils::addTrailingSlash(mRootDir);
@@ -58,7 +62,9 @@ namespace dma {
 
     Engine::~Engine() {
         Log::trace(TAG, "Destroying Engine...");
+        delete mSimulationThread;
         delete mScene;
+        delete mUpdateThreadPool;
         delete mAnimationSystem;
         delete mResourceManager;
         delete mGlobalTimer;
@@ -91,6 +97,31 @@ namespace dma {
     }
 
 
+    //---------------------------------------------------------------------------------
+    void Engine::setUpdateThreadCount(U32 threadCount) {
+        mScene->setThreadPool(nullptr);
+        delete mUpdateThreadPool;
+        mUpdateThreadPool = nullptr;
+        if (threadCount > 0) {
+            mUpdateThreadPool = new ThreadPool(threadCount);
+            mScene->setThreadPool(mUpdateThreadPool);
+        }
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::setFramePacketsEnabled(bool enabled) {
+        if (enabled == isFramePacketsEnabled()) {
+            return;
+        }
+        delete mSimulationThread;
+        mSimulationThread = enabled ? new ThreadPool(1) : nullptr;
+        mFramePackets[0].clear();
+        mFramePackets[1].clear();
+        mScene->setDeferredRelease(enabled);
+    }
+
+
     //---------------------------------------------------------------------------------
     bool Engine::init() {
         // an openGL context must be opened for this operation.
@@ -135,6 +166,7 @@ namespace dma {
         mAssertInit("Engine::refresh");
 
         mResourceManager->refresh();
+        mRenderingEngine->invalidateBindings(false); // context lost: vertex arrays already gone
         mScene->refresh();
         mRenderingEngine->init();
     }
@@ -144,6 +176,7 @@ namespace dma {
         mAssertInit("Engine::reload");
 
         mResourceManager->reload();
+        mRenderingEngine->invalidateBindings(true);
         mScene->refresh(); //refresh skybox
         mRenderingEngine->init();
     }
@@ -158,6 +191,8 @@ namespace dma {
         }
 
         // if an openGL context is opened, try to clean up OGL resources.
+        mFramePackets[0].clear();
+        mFramePackets[1].clear();
         mScene->unload();
         mRenderingEngine->unload();
         mResourceManager->unload();
@@ -171,6 +206,7 @@ namespace dma {
         mAssertInit("Engine::wipe");
 
         Log::trace(TAG, "Wiping Engine...");
+        mRenderingEngine->invalidateBindings(true);
         mResourceManager->wipe();
         mScene->wipe(); //wipe skybox
         Log::trace(TAG, "Engine wiped");
@@ -184,8 +220,32 @@ namespace dma {
 #ifdef FPS_PRINT_RATE
         mUpdateFPS();
 #endif
-        mScene->step(mGlobalTimer->dt());
-        mRenderingEngine->drawFrame();
+        if (mSimulationThread == nullptr) {
+            mScene->step(mGlobalTimer->dt());
+            mRenderingEngine->drawFrame();
+            return;
+        }
+
+        // simulate the next frame while submitting the previous one
+        FramePacket& front = mFramePackets[mFrontPacket];
+        FramePacket& back = mFramePackets[1 - mFrontPacket];
+        float dt = mGlobalTimer->dt();
+        std::promise<void> simulated;
+        mSimulationThread->post([this, &back, &simulated, dt]() {
+            try {
+                mScene->step(dt);
+                mRenderingEngine->buildFramePacket(back);
+                simulated.set_value();
+            } catch (...) {
+                simulated.set_exception(std::current_exception());
+            }
+        });
+        mRenderingEngine->drawFramePacket(front);
+        simulated.get_future().get();
+
+        mFrontPacket = 1 - mFrontPacket;
+        // the entities removed before this step are no longer referenced by any packet
+        mScene->releaseRemovedEntities();
     }
 
 
@@ -205,6 +265,8 @@ namespace dma {
 
         if (elapsedTime >= FPS_PRINT_RATE && FPS_PRINT_RATE > 0) {
             Log::info(TAG, "FPS = %f", (float)frameCount / elapsedTime);
+            const GLStateCache::Stats& stats = mRenderingEngine->getGLStateStats();
+            Log::info(TAG, "GL state calls per frame: %u issued, %u filtered", stats.issued, stats.filtered);
             frameCount = 0;
             elapsedTime = 0.0f;
         }
@@ -24,11 +24,11 @@ namespace dma {
 
     //---------------------------------------------------------------------------
     Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::vec3& pos) :
-            mTransformComponent(new TransformComponent()),
-            mRenderingComponent(new RenderingComponent(mTransformComponent->getM(), mesh, material)),
+            mTransformComponent(),
+            mRenderingComponent(new RenderingComponent(mTransformComponent.getM(), mesh, material)),
             mAnimationComponent(NULL)
     {
-        mTransformComponent->setPosition(glm::vec3(pos));
+        mTransformComponent.setPosition(glm::vec3(pos));
     }
 
 
@@ -48,7 +48,6 @@ namespace dma {
     Entity::~Entity() {
         delete mAnimationComponent;
         delete mRenderingComponent;
-        delete mTransformComponent;
     }
 
 
@@ -66,8 +65,6 @@ namespace dma {
 
     //---------------------------------------------------------------------------
     void Entity::update(float dt) {
-        assert(mTransformComponent != NULL);
-        mTransformComponent->update();
         if (mAnimationComponent != nullptr) {
             mAnimationComponent->update(dt);
         }
@@ -77,7 +74,7 @@ namespace dma {
     //---------------------------------------------------------------------------
     void Entity::addAnimationComponent() {
         delete mAnimationComponent;
-        mAnimationComponent = new AnimationComponent(*mTransformComponent);
+        mAnimationComponent = new AnimationComponent(mTransformComponent);
     }
 
 } /* namespace dma */
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "engine/LooseOctree.hpp"
+#include "utils/Log.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+constexpr auto TAG = "LooseOctree";
+
+namespace dma {
+
+    constexpr LooseOctree::Handle LooseOctree::INVALID_HANDLE;
+    constexpr U32 LooseOctree::MAX_DEPTH;
+    constexpr F32 LooseOctree::INITIAL_HALF_SIZE;
+    constexpr I32 LooseOctree::NO_NODE;
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    /**
+     * Chebyshev distance, i.e. half the side of the smallest cube
+     * centered on a and holding b.
+     */
+    static inline F32 cubeDistance(const glm::vec3& a, const glm::vec3& b) {
+        glm::vec3 d = glm::abs(b - a);
+        return std::max(d.x, std::max(d.y, d.z));
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    LooseOctree::LooseOctree() :
+            mSize(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    LooseOctree::~LooseOctree() {}
+
+
+    //------------------------------------------------------------------------
+    LooseOctree::Handle LooseOctree::insert(Entity* entity, const glm::vec3& center, F32 radius) {
+        assert(entity != nullptr);
+        Handle handle;
+        if (!mFreeHandles.empty()) {
+            handle = mFreeHandles.back();
+            mFreeHandles.pop_back();
+        } else {
+            handle = (Handle) mObjects.size();
+            mObjects.push_back(Object());
+        }
+        Object& object = mObjects[handle];
+        object.entity = entity;
+        object.center = center;
+        object.radius = radius;
+        object.node = NO_NODE;
+        object.slot = 0;
+        ++mSize;
+
+        if (mNodes.empty()) {
+            mCreateNode(center, std::max(INITIAL_HALF_SIZE, radius), NO_NODE, 0);
+        } else if (!mFitsRoot(center, radius)) {
+            mGrow(center, radius);
+        }
+        mLink(handle);
+        return handle;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::update(Handle handle, const glm::vec3& center, F32 radius) {
+        assert(handle < mObjects.size() && mObjects[handle].entity != nullptr);
+        Object& object = mObjects[handle];
+        object.center = center;
+        object.radius = radius;
+
+        Node& node = mNodes[object.node];
+        if (cubeDistance(node.center, center) + radius <= 2.0f * node.halfSize) {
+            // still within the loose bounds
+            node.x[object.slot] = center.x;
+            node.y[object.slot] = center.y;
+            node.z[object.slot] = center.z;
+            node.radius[object.slot] = radius;
+            return;
+        }
+        mUnlink(handle);
+        if (!mFitsRoot(center, radius)) {
+            mGrow(center, radius);
+        }
+        mLink(handle);
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::remove(Handle handle) {
+        assert(handle < mObjects.size() && mObjects[handle].entity != nullptr);
+        mUnlink(handle);
+        mObjects[handle].entity = nullptr;
+        mFreeHandles.push_back(handle);
+        --mSize;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::clear() {
+        mNodes.clear();
+        mObjects.clear();
+        mFreeHandles.clear();
+        mSize = 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::query(const Frustum& frustum, std::vector<Entity*>& result) const {
+        if (!mNodes.empty()) {
+            mQuery(0, frustum, result, mVisibility);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::split(const Frustum& frustum, U32 depth, std::vector<QueryTask>& tasks) const {
+        if (!mNodes.empty()) {
+            mSplit(0, frustum, depth, tasks);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::query(const QueryTask& task, const Frustum& frustum,
+                            std::vector<Entity*>& result, std::vector<U8>& visibility) const {
+        if (task.inside) {
+            mCollect(task.node, result);
+        } else if (task.subtree) {
+            mQuery(task.node, frustum, result, visibility);
+        } else {
+            mTestObjects(task.node, frustum, result, visibility);
+        }
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    I32 LooseOctree::mCreateNode(const glm::vec3& center, F32 halfSize, I32 parent, U32 depth) {
+        Node node;
+        node.center = center;
+        node.halfSize = halfSize;
+        node.parent = parent;
+        std::fill(node.children, node.children + 8, NO_NODE);
+        node.depth = depth;
+        node.count = 0;
+        mNodes.push_back(node);
+        return (I32) mNodes.size() - 1;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mLink(Handle handle) {
+        Object& object = mObjects[handle];
+        I32 n = 0;
+        for (;;) {
+            ++mNodes[n].count;
+            F32 halfSize = mNodes[n].halfSize;
+            if (mNodes[n].depth >= MAX_DEPTH || object.radius > 0.5f * halfSize) {
+                break;
+            }
+            const glm::vec3 center = mNodes[n].center;
+            U32 octant = (object.center.x >= center.x ? 1 : 0)
+                         | (object.center.y >= center.y ? 2 : 0)
+                         | (object.center.z >= center.z ? 4 : 0);
+            I32 child = mNodes[n].children[octant];
+            if (child == NO_NODE) {
+                F32 offset = 0.5f * halfSize;
+                glm::vec3 childCenter(center.x + ((octant & 1) ? offset : -offset),
+                                      center.y + ((octant & 2) ? offset : -offset),
+                                      center.z + ((octant & 4) ? offset : -offset));
+                // may reallocate mNodes, hence the indices
+                child = mCreateNode(childCenter, offset, n, mNodes[n].depth + 1);
+                mNodes[n].children[octant] = child;
+            }
+            n = child;
+        }
+        Node& node = mNodes[n];
+        object.node = n;
+        object.slot = (U32) node.objects.size();
+        node.objects.push_back(handle);
+        node.x.push_back(object.center.x);
+        node.y.push_back(object.center.y);
+        node.z.push_back(object.center.z);
+        node.radius.push_back(object.radius);
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mUnlink(Handle handle) {
+        Object& object = mObjects[handle];
+        assert(object.node != NO_NODE);
+        Node& node = mNodes[object.node];
+        Handle last = node.objects.back();
+        node.objects[object.slot] = last;
+        node.x[object.slot] = node.x.back();
+        node.y[object.slot] = node.y.back();
+        node.z[object.slot] = node.z.back();
+        node.radius[object.slot] = node.radius.back();
+        mObjects[last].slot = object.slot;
+        node.objects.pop_back();
+        node.x.pop_back();
+        node.y.pop_back();
+        node.z.pop_back();
+        node.radius.pop_back();
+
+        for (I32 n = object.node; n != NO_NODE; n = mNodes[n].parent) {
+            --mNodes[n].count;
+        }
+        object.node = NO_NODE;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool LooseOctree::mFitsRoot(const glm::vec3& center, F32 radius) const {
+        const Node& root = mNodes[0];
+        return cubeDistance(root.center, center) <= root.halfSize && radius <= root.halfSize;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mGrow(const glm::vec3& center, F32 radius) {
+        glm::vec3 rootCenter = mNodes[0].center;
+        F32 halfSize = mNodes[0].halfSize;
+        while (cubeDistance(rootCenter, center) > halfSize || radius > halfSize) {
+            halfSize *= 2.0f;
+        }
+        Log::trace(TAG, "Growing root to %.0f, rebuilding %u objects", 2.0f * halfSize, mSize);
+
+        mNodes.clear();
+        mCreateNode(rootCenter, halfSize, NO_NODE, 0);
+        for (Handle handle = 0; handle < mObjects.size(); ++handle) {
+            Object& object = mObjects[handle];
+            if (object.entity != nullptr && object.node != NO_NODE) {
+                object.node = NO_NODE;
+                mLink(handle);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mSplit(I32 nodeIndex, const Frustum& frustum, U32 depth, std::vector<QueryTask>& tasks) const {
+        const Node& node = mNodes[nodeIndex];
+        if (node.count == 0) {
+            return;
+        }
+        if (node.depth >= depth) {
+            tasks.push_back({nodeIndex, true, false});
+            return;
+        }
+        F32 looseRadius = 2.0f * node.halfSize * std::sqrt(3.0f);
+        switch (frustum.intersectSphere(node.center, looseRadius)) {
+            case Frustum::OUTSIDE:
+                return;
+            case Frustum::INSIDE:
+                tasks.push_back({nodeIndex, true, true});
+                return;
+            case Frustum::INTERSECTS:
+            default:
+                break;
+        }
+        if (!node.objects.empty()) {
+            tasks.push_back({nodeIndex, false, false});
+        }
+        for (I32 child : node.children) {
+            if (child != NO_NODE) {
+                mSplit(child, frustum, depth, tasks);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mQuery(I32 nodeIndex, const Frustum& frustum,
+                             std::vector<Entity*>& result, std::vector<U8>& visibility) const {
+        const Node& node = mNodes[nodeIndex];
+        if (node.count == 0) {
+            return;
+        }
+        // bounding sphere of the loose cube
+        F32 looseRadius = 2.0f * node.halfSize * std::sqrt(3.0f);
+        switch (frustum.intersectSphere(node.center, looseRadius)) {
+            case Frustum::OUTSIDE:
+                return;
+            case Frustum::INSIDE:
+                mCollect(nodeIndex, result);
+                return;
+            case Frustum::INTERSECTS:
+            default:
+                break;
+        }
+        mTestObjects(nodeIndex, frustum, result, visibility);
+        for (I32 child : node.children) {
+            if (child != NO_NODE) {
+                mQuery(child, frustum, result, visibility);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mTestObjects(I32 nodeIndex, const Frustum& frustum,
+                                   std::vector<Entity*>& result, std::vector<U8>& visibility) const {
+        const Node& node = mNodes[nodeIndex];
+        U32 objectCount = (U32) node.objects.size();
+        if (objectCount == 0) {
+            return;
+        }
+        visibility.resize(objectCount);
+        frustum.containsSpheres(node.x.data(), node.y.data(), node.z.data(), node.radius.data(),
+                                objectCount, visibility.data());
+        for (U32 i = 0; i < objectCount; ++i) {
+            if (visibility[i]) {
+                result.push_back(mObjects[node.objects[i]].entity);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LooseOctree::mCollect(I32 nodeIndex, std::vector<Entity*>& result) const {
+        const Node& node = mNodes[nodeIndex];
+        if (node.count == 0) {
+            return;
+        }
+        for (Handle handle : node.objects) {
+            result.push_back(mObjects[handle].entity);
+        }
+        for (I32 child : node.children) {
+            if (child != NO_NODE) {
+                mCollect(child, result);
+            }
+        }
+    }
+}
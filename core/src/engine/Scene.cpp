@@ -25,6 +25,8 @@ constexpr char TAG[] = "Scene";
 
 namespace dma {
 
+    constexpr U32 Scene::CULLING_SPLIT_DEPTH;
+
     //----------------------------------------------------------------------
     Scene::Scene(ResourceManager* resourceManager,
                  AnimationSystem* animationSystem,
@@ -33,7 +35,12 @@ namespace dma {
             mSkyBox(nullptr),
             mResourceManager(resourceManager),
             mAnimationSystem(animationSystem),
-            mRenderingEngine(renderingEngine)
+            mRenderingEngine(renderingEngine),
+            mThreadPool(nullptr),
+            mVisibleEntities(1),
+            mMovedEntities(1),
+            mVisibility(1),
+            mDeferredRelease(false)
     {
         //set default light source
         Light light(glm::vec3(-100.0f, 10.0f, 50.0f),
@@ -56,6 +63,14 @@ namespace dma {
     void Scene::unload() {
         Log::trace(TAG, "Unloading Scene...");
         mEntities.clear();
+        mEntityList.clear();
+        mOctree.clear();
+        for (auto& visible : mVisibleEntities) {
+            visible.clear();
+        }
+        for (auto& moved : mMovedEntities) {
+            moved.clear();
+        }
         Log::trace(TAG, "Scene unloaded");
     }
 
@@ -191,38 +206,124 @@ namespace dma {
     void Scene::step(float dt) {
         assert(mCamera != nullptr && "Camera not set before calling Scene#step");
         mCamera->update(dt);
-        for (auto e : mEntities) {
-            assert(e != nullptr);
-            e->update(dt);
-            if (e->isRenderable()) {
-                const RenderingComponent *rc = e->getRenderingComponent();
-                assert(rc != nullptr);
-
-                // frustum culling
-                const BoundingSphere& sphere = rc->getMesh()->getBoundingSphere();
-                if (mCamera->containsSphere(glm::vec3(*e->getM() * glm::vec4(sphere.getCenter(), 1.0f)), sphere.getRadius())) {
-                    // Computes the distance to the camera
-                    float distance = distanceFromCamera(e);
-                    mRenderingEngine->subscribe(rc, distance);
+
+        mParallelFor((U32) mEntityList.size(), [this, dt](U32 worker, U32 begin, U32 end) {
+            std::vector<std::pair<Entity*, Placement*>>& moved = mMovedEntities[worker];
+            for (U32 i = begin; i < end; ++i) {
+                Entity& e = *mEntityList[i].first;
+                e.update(dt);
+                if (e.isRenderable()) {
+                    Placement& placement = *mEntityList[i].second;
+                    if (e.getTransformComponent().isDirty() || placement.handle == LooseOctree::INVALID_HANDLE
+                        || placement.mesh != e.getRenderingComponent()->getMesh().get()) {
+                        moved.push_back(mEntityList[i]);
+                    }
                 }
             }
+        });
+
+        // one linear pass over the dirty transforms
+        TransformPool& transformPool = TransformPool::getDefault();
+        mParallelFor(transformPool.getChunkCount(), [&transformPool](U32, U32 begin, U32 end) {
+            transformPool.update(begin, end);
+        });
+
+        // the octree is not thread-safe
+        for (auto& moved : mMovedEntities) {
+            for (auto& entry : moved) {
+                mPlace(*entry.first, *entry.second);
+            }
+            moved.clear();
+        }
+
+        // frustum culling
+        const Frustum& frustum = mCamera->getFrustum();
+        const glm::vec3& cameraPosition = mCamera->getPosition();
+        if (mThreadPool == nullptr) {
+            std::vector<Entity*>& visible = mVisibleEntities[0];
+            visible.clear();
+            mOctree.query(frustum, visible);
+            for (Entity* e : visible) {
+                // Computes the distance to the camera
+                float distance = glm::length<float>(e->getPosition() - cameraPosition);
+                mRenderingEngine->subscribe(e->getRenderingComponent(), distance);
+            }
+        } else {
+            mQueryTasks.clear();
+            mOctree.split(frustum, CULLING_SPLIT_DEPTH, mQueryTasks);
+            mParallelFor((U32) mQueryTasks.size(), [&](U32 worker, U32 begin, U32 end) {
+                std::vector<Entity*>& visible = mVisibleEntities[worker];
+                visible.clear();
+                for (U32 i = begin; i < end; ++i) {
+                    mOctree.query(mQueryTasks[i], frustum, visible, mVisibility[worker]);
+                }
+                for (Entity* e : visible) {
+                    float distance = glm::length<float>(e->getPosition() - cameraPosition);
+                    mRenderingEngine->subscribe(worker, e->getRenderingComponent(), distance);
+                }
+            });
+        }
+    }
+
+
+    //----------------------------------------------------------------------
+    void Scene::setThreadPool(ThreadPool* threadPool) {
+        mThreadPool = threadPool;
+        U32 workers = threadPool != nullptr ? threadPool->getWorkerCount() : 1;
+        mVisibleEntities.resize(workers);
+        mMovedEntities.resize(workers);
+        mVisibility.resize(workers);
+        mRenderingEngine->setShardCount(threadPool != nullptr ? workers : 0);
+    }
+
+
+    //----------------------------------------------------------------------
+    void Scene::setDeferredRelease(bool enabled) {
+        mDeferredRelease = enabled;
+        if (!enabled) {
+            releaseRemovedEntities();
         }
     }
 
 
+    //----------------------------------------------------------------------
+    void Scene::releaseRemovedEntities() {
+        mRemovedEntities.clear();
+    }
+
+
     //----------------------------------------------------------------------
     bool Scene::addEntity(std::shared_ptr<Entity> entity) {
-        return mEntities.insert(entity).second;
+        // placed in the octree at the next step, once its transform is up to date
+        Placement placement = {LooseOctree::INVALID_HANDLE, nullptr, (U32) mEntityList.size()};
+        auto inserted = mEntities.insert(std::make_pair(entity, placement));
+        if (inserted.second) {
+            mEntityList.push_back(std::make_pair(entity.get(), &inserted.first->second));
+        }
+        return inserted.second;
     }
 
 
     //----------------------------------------------------------------------
     bool Scene::removeEntity(std::shared_ptr<Entity> entity) {
-        if (mEntities.erase(entity) == 0) {
+        auto it = mEntities.find(entity);
+        if (it == mEntities.end()) {
             Log::warn(TAG, "Cannot remove entity since it doesn't belong to the scene");
             assert(!"Cannot remove entity since it doesn't belong to the scene");
             return false;
         }
+        if (it->second.handle != LooseOctree::INVALID_HANDLE) {
+            mOctree.remove(it->second.handle);
+        }
+        // swap with the last one
+        U32 index = it->second.index;
+        mEntityList[index] = mEntityList.back();
+        mEntityList[index].second->index = index;
+        mEntityList.pop_back();
+        if (mDeferredRelease) {
+            mRemovedEntities.push_back(it->first);
+        }
+        mEntities.erase(it);
         return true;
     }
 
@@ -237,4 +338,37 @@ namespace dma {
             mSkyBox->wipe();
         }
     }
+
+
+    /*============================== PRIVATE ==============================*/
+
+    //----------------------------------------------------------------------
+    void Scene::mPlace(Entity& entity, Placement& placement) {
+        const Mesh* mesh = entity.getRenderingComponent()->getMesh().get();
+        const BoundingSphere& sphere = mesh->getBoundingSphere();
+        const glm::mat4& M = *entity.getM();
+
+        // world-space sphere, the radius following the largest scale factor
+        glm::vec3 center = glm::vec3(M * glm::vec4(sphere.getCenter(), 1.0f));
+        float scale = std::max(glm::length(glm::vec3(M[0])),
+                               std::max(glm::length(glm::vec3(M[1])), glm::length(glm::vec3(M[2]))));
+        float radius = sphere.getRadius() * scale;
+
+        if (placement.handle == LooseOctree::INVALID_HANDLE) {
+            placement.handle = mOctree.insert(&entity, center, radius);
+        } else {
+            mOctree.update(placement.handle, center, radius);
+        }
+        placement.mesh = mesh;
+    }
+
+
+    //----------------------------------------------------------------------
+    void Scene::mParallelFor(U32 count, const ThreadPool::RangeTask& task) {
+        if (mThreadPool != nullptr) {
+            mThreadPool->parallelFor(count, task);
+        } else if (count > 0) {
+            task(0, 0, count);
+        }
+    }
 }
@@ -23,47 +23,45 @@ namespace dma {
 
 
     //------------------------------------------------------
-    TransformComponent::TransformComponent() :
-                    mPosition(glm::vec3(0.0f)),
-                    mOrientation(glm::quat()), //identity quaternion
-                    mScale(glm::vec3(1.0f)),
-                    mM(glm::mat4(1.0f)),
-                    mDirty(true)
+    TransformComponent::TransformComponent(bool manual) :
+                    mHandle(TransformPool::getDefault().allocate(manual ? (U8) TransformPool::MANUAL : (U8) 0)),
+                    mChunk(TransformPool::getDefault().getChunk(mHandle)),
+                    mIndex(mHandle % TransformPool::CHUNK_SIZE)
     {}
 
 
     //------------------------------------------------------
     TransformComponent::~TransformComponent() {
-
+        TransformPool::getDefault().release(mHandle);
     }
 
 
     //------------------------------------------------------
     void TransformComponent::setPosition(const glm::vec3& position) {
-        mPosition = position;
-        mDirty = true;
+        mChunk->positions[mIndex] = position;
+        setDirty(true);
     }
 
 
     //------------------------------------------------------
     void TransformComponent::translate(const glm::vec3& translation) {
-        mPosition += translation;
-        mDirty = true;
+        mChunk->positions[mIndex] += translation;
+        setDirty(true);
     }
 
 
     //------------------------------------------------------
     void TransformComponent::setOrientation(const glm::quat& rotationQuat) {
-        mOrientation = rotationQuat;
-        mDirty = true;
+        mChunk->orientations[mIndex] = rotationQuat;
+        setDirty(true);
     }
 
 
     //------------------------------------------------------
     void TransformComponent::rotate(const float angle, const glm::vec3 &axis) {
         glm::quat q = glm::angleAxis(glm::radians(angle), axis);
-        mOrientation = q * mOrientation;
-        mDirty = true;
+        mChunk->orientations[mIndex] = q * mChunk->orientations[mIndex];
+        setDirty(true);
     }
 
 
@@ -87,20 +85,21 @@ namespace dma {
 
     //------------------------------------------------------
     void TransformComponent::setScale(const glm::vec3 &scale) {
-        mScale = scale;
-        mDirty = true;
+        mChunk->scales[mIndex] = scale;
+        setDirty(true);
     }
 
 
     //------------------------------------------------------
     void TransformComponent::update(const bool reverse) {
-        if (mDirty) {
-            if (reverse) {
-                mM = glm::scale(glm::mat4(1.0f), mScale) * glm::mat4_cast(mOrientation) * glm::translate(glm::mat4(1.0f), mPosition);
-            } else {
-                mM = glm::translate(glm::mat4(1.0f), mPosition) * glm::mat4_cast(mOrientation) * glm::scale(glm::mat4(1.0f), mScale);
-            }
-            mDirty = false;
+        U8& flags = mChunk->flags[mIndex];
+        if (reverse) {
+            flags |= (U8) TransformPool::REVERSE;
+        } else {
+            flags &= (U8) ~TransformPool::REVERSE;
+        }
+        if (flags & TransformPool::DIRTY) {
+            TransformPool::updateSlot(*mChunk, mIndex);
         }
     }
 }
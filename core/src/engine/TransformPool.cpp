@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "engine/TransformPool.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace dma {
+
+    constexpr U32 TransformPool::CHUNK_SIZE;
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    TransformPool& TransformPool::getDefault() {
+        static TransformPool pool;
+        return pool;
+    }
+
+
+    //------------------------------------------------------------------------
+    TransformPool::TransformPool() :
+            mNext(0),
+            mSize(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    TransformPool::~TransformPool() {}
+
+
+    //------------------------------------------------------------------------
+    TransformPool::Handle TransformPool::allocate(U8 flags) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Handle handle;
+        if (!mFreeHandles.empty()) {
+            handle = mFreeHandles.back();
+            mFreeHandles.pop_back();
+        } else {
+            handle = mNext++;
+            if (handle / CHUNK_SIZE >= mChunks.size()) {
+                mChunks.push_back(std::unique_ptr<Chunk>(new Chunk()));
+            }
+        }
+        Chunk& chunk = *mChunks[handle / CHUNK_SIZE];
+        U32 index = handle % CHUNK_SIZE;
+        chunk.positions[index] = glm::vec3(0.0f);
+        chunk.orientations[index] = glm::quat(); //identity quaternion
+        chunk.scales[index] = glm::vec3(1.0f);
+        chunk.M[index] = glm::mat4(1.0f);
+        chunk.flags[index] = (U8) (flags | ALLOCATED | DIRTY);
+        ++mSize;
+        return handle;
+    }
+
+
+    //------------------------------------------------------------------------
+    void TransformPool::release(Handle handle) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        assert(handle < mNext);
+        Chunk& chunk = *mChunks[handle / CHUNK_SIZE];
+        assert(chunk.flags[handle % CHUNK_SIZE] & ALLOCATED);
+        chunk.flags[handle % CHUNK_SIZE] = 0;
+        mFreeHandles.push_back(handle);
+        --mSize;
+    }
+
+
+    //------------------------------------------------------------------------
+    TransformPool::Chunk* TransformPool::getChunk(Handle handle) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        assert(handle < mNext);
+        return mChunks[handle / CHUNK_SIZE].get();
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 TransformPool::getChunkCount() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return (U32) mChunks.size();
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 TransformPool::update() {
+        return update(0, getChunkCount());
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 TransformPool::update(U32 firstChunk, U32 endChunk) {
+        U32 updated = 0;
+        for (U32 c = firstChunk; c < endChunk; ++c) {
+            Chunk* chunk;
+            U32 end;
+            {
+                // chunks never move, only the list of chunks may grow meanwhile
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (c * CHUNK_SIZE >= mNext) {
+                    break;
+                }
+                chunk = mChunks[c].get();
+                end = std::min(CHUNK_SIZE, mNext - c * CHUNK_SIZE);
+            }
+            for (U32 i = 0; i < end; ++i) {
+                if ((chunk->flags[i] & (DIRTY | MANUAL)) == DIRTY) {
+                    updateSlot(*chunk, i);
+                    ++updated;
+                }
+            }
+        }
+        return updated;
+    }
+
+
+    //------------------------------------------------------------------------
+    void TransformPool::updateSlot(Chunk& chunk, U32 index) {
+        const glm::mat4 R = glm::mat4_cast(chunk.orientations[index]);
+        if (chunk.flags[index] & REVERSE) {
+            chunk.M[index] = glm::scale(glm::mat4(1.0f), chunk.scales[index]) * R
+                             * glm::translate(glm::mat4(1.0f), chunk.positions[index]);
+        } else {
+            chunk.M[index] = glm::translate(glm::mat4(1.0f), chunk.positions[index]) * R
+                             * glm::scale(glm::mat4(1.0f), chunk.scales[index]);
+        }
+        chunk.flags[index] &= (U8) ~DIRTY;
+    }
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/BackgroundTileProvider.hpp"
+#include "engine/geo/GeoEngine.hpp"
+#include "resource/RawImage.hpp"
+#include "utils/GeoUtils.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+
+constexpr auto TAG = "BackgroundTileProvider";
+
+namespace dma {
+    namespace geo {
+
+        constexpr U32 BackgroundTileProvider::DEFAULT_THREAD_COUNT;
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        BackgroundTileProvider::BackgroundTileProvider(GeoEngine& engine, const std::string& ns,
+                                                       std::shared_ptr<ITileSource> source,
+                                                       U32 threadCount) :
+                mEngine(engine),
+                mNamespace(ns),
+                mSource(source),
+                mGeneration(0),
+                mStats({0, 0, 0}),
+                mThreadPool(threadCount)
+        {}
+
+
+        //------------------------------------------------------------------------
+        BackgroundTileProvider::~BackgroundTileProvider() {}
+
+
+        //------------------------------------------------------------------------
+        void BackgroundTileProvider::attach(ResourceManager& resourceManager) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mMapDir = resourceManager.getPathFor(ResourceManager::TEXTURE);
+            mDecodedTileDir = resourceManager.getDecodedTileDir();
+        }
+
+
+        //------------------------------------------------------------------------
+        void BackgroundTileProvider::detach(ResourceManager& resourceManager) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.clear();
+        }
+
+
+        //------------------------------------------------------------------------
+        void BackgroundTileProvider::fetch(int x, int y, int z) {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            U32 generation;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mPending.find(key) != mPending.end()) {
+                    return;
+                }
+                generation = ++mGeneration;
+                mPending[key] = generation;
+            }
+            mThreadPool.post([this, x, y, z, generation]() {
+                mLoad(x, y, z, generation);
+            });
+        }
+
+
+        //------------------------------------------------------------------------
+        void BackgroundTileProvider::cancel(int x, int y, int z) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.erase(GeoUtils::tileKey(x, y, z));
+        }
+
+
+        //------------------------------------------------------------------------
+        BackgroundTileProvider::Stats BackgroundTileProvider::getStats() const {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mStats;
+        }
+
+
+        /* ================= PRIVATE ========================*/
+
+        //------------------------------------------------------------------------
+        void BackgroundTileProvider::mLoad(int x, int y, int z, U32 generation) {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            std::string mapDir, decodedTileDir;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mIsCurrent(key, generation)) {
+                    ++mStats.cancelled;
+                    return;
+                }
+                mapDir = mMapDir;
+                decodedTileDir = mDecodedTileDir;
+            }
+
+            char zxy[40];
+            snprintf(zxy, sizeof(zxy), "%d/%d/%d", z, x, y);
+            std::string sid = (mNamespace.empty() ? "tiles/" : "tiles/" + mNamespace + "/") + zxy;
+
+            std::vector<BYTE> data;
+            Status status;
+            try {
+                status = mSource->read(x, y, z, data);
+            } catch (std::exception& e) {
+                Log::error(TAG, "Unable to read %s: %s", sid.c_str(), e.what());
+                status = STATUS_KO;
+            }
+
+            // decoded here rather than by the MapLoader, the raw copy being mapped instead
+            Image image;
+            if (status == STATUS_OK && !decodedTileDir.empty()) {
+                status = image.loadAsPNG(data.data(), (U32) data.size());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (status != STATUS_OK) {
+                    Log::trace(TAG, "Tile %s not fetched", sid.c_str());
+                    ++mStats.failed;
+                    mPending.erase(key);
+                    return;
+                }
+                if (!mIsCurrent(key, generation)) {
+                    ++mStats.cancelled;
+                    return;
+                }
+            }
+
+            // the PNG first, its raw copy being up to date if not older
+            status = mWriteFile(mapDir + sid + ".png", data);
+            if (status == STATUS_OK && !decodedTileDir.empty()) {
+                RawImage::write(decodedTileDir + sid + ".raw", image);
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mIsCurrent(key, generation)) {
+                ++mStats.cancelled;
+                return;
+            }
+            mPending.erase(key);
+            if (status != STATUS_OK) {
+                ++mStats.failed;
+                return;
+            }
+            ++mStats.fetched;
+            GeoEngine* engine = &mEngine;
+            mEngine.post([engine, x, y, z]() {
+                engine->getGeoSceneManager().notifyTileAvailable(x, y, z);
+            });
+        }
+
+
+        //------------------------------------------------------------------------
+        bool BackgroundTileProvider::mIsCurrent(U64 key, U32 generation) const {
+            auto it = mPending.find(key);
+            return it != mPending.end() && it->second == generation;
+        }
+
+
+        //------------------------------------------------------------------------
+        Status BackgroundTileProvider::mWriteFile(const std::string& filename, const std::vector<BYTE>& data) {
+            size_t slash = filename.find_last_of('/');
+            if (slash != std::string::npos && !Utils::makeDirs(filename.substr(0, slash))) {
+                Log::error(TAG, "Unable to create the directory of %s", filename.c_str());
+                return STATUS_KO;
+            }
+            // written aside then renamed, never being seen incomplete
+            std::string tmp = filename + ".tmp";
+            FILE* file = fopen(tmp.c_str(), "wb");
+            if (file == nullptr) {
+                Log::error(TAG, "Unable to write %s", tmp.c_str());
+                return STATUS_KO;
+            }
+            bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+            ok = fclose(file) == 0 && ok;
+            if (!ok || rename(tmp.c_str(), filename.c_str()) != 0) {
+                Log::error(TAG, "Unable to write %s", filename.c_str());
+                remove(tmp.c_str());
+                return STATUS_KO;
+            }
+            return STATUS_OK;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/DirectoryTileSource.hpp"
+#include "utils/Utils.hpp"
+
+#include <cstdio>
+
+
+namespace dma {
+    namespace geo {
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        DirectoryTileSource::DirectoryTileSource(const std::string& dir) :
+                mDir(dir)
+        {
+            Utils::addTrailingSlash(mDir);
+        }
+
+
+        //------------------------------------------------------------------------
+        DirectoryTileSource::~DirectoryTileSource() {}
+
+
+        //------------------------------------------------------------------------
+        Status DirectoryTileSource::read(int x, int y, int z, std::vector<BYTE>& data) {
+            char zxy[40];
+            snprintf(zxy, sizeof(zxy), "%d/%d/%d.png", z, x, y);
+            std::string filename = mDir + zxy;
+            if (!Utils::fileExists(filename)) {
+                return STATUS_KO;
+            }
+            return Utils::bufferize(filename, data);
+        }
+    }
+}
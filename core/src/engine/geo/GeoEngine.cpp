@@ -67,6 +67,7 @@ namespace dma {
         //------------------------------------------------------------------------------
         void GeoEngine::refresh() {
             mEngine.refresh();
+            mGeoSceneManager.refresh();
         }
 
 
@@ -88,6 +89,7 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         void GeoEngine::wipe() {
+            mGeoSceneManager.wipe();
             mEngine.wipe();
         }
 
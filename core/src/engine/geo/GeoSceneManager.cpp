@@ -52,17 +52,19 @@ namespace dma {
         //------------------------------------------------------------------------------
         void GeoSceneManager::init() {
             mTileMap.init();
-            for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
-                mScene.addEntity(tile);
+            if (mTileMap.getGround() != nullptr) {
+                mScene.addEntity(mTileMap.getGround());
+            } else {
+                for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
+                    mScene.addEntity(tile);
+                }
             }
         }
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::unload() {
             Log::trace(TAG, "Unloading GeoSceneManager...");
-            for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
-                mScene.removeEntity(tile);
-            }
+            mRemoveTiles();
             mTileMap.unload();
             removeAllPois();
             mOrigin.lat = 0.0;
@@ -73,6 +75,8 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::step() { //TODO optimization ?
+            mTileMap.step();
+
             for (auto& kv : mPOIs) {
                 auto poi = kv.second;
                 if (poi->isDirty()) {
@@ -92,8 +96,22 @@ namespace dma {
                     dest.z = dest.z + (tile->getQuad().getHeight() / 2.0f);
                     tile->setPosition(dest);
                     tile->setDirty(false);
+                    mTileMap.mPlaceTile(*tile);
                 }
             }
+            mTileMap.mUpdateGround();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::refresh() {
+            mTileMap.refresh();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::wipe() {
+            mTileMap.wipe();
         }
 
 
@@ -255,6 +273,8 @@ namespace dma {
             mCameraCoords = coords;
             mLastX = x0;
             mLastY = y0;
+
+            mTileMap.track(GeoUtils::lng2tilexf(coords.lng, ZOOM_LEVEL), GeoUtils::lat2tileyf(coords.lat, ZOOM_LEVEL));
         }
 
 
@@ -270,6 +290,12 @@ namespace dma {
         }
 
 
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setTileProvider(std::shared_ptr<ITileProvider> provider) {
+            mTileMap.setTileProvider(provider);
+        }
+
+
         //------------------------------------------------------------------------------
         std::shared_ptr<Poi> GeoSceneManager::pick(int screenX, int screenY) {
             std::list<std::shared_ptr<Poi>> intersected;
@@ -324,7 +350,51 @@ namespace dma {
         void GeoSceneManager::updateTileDiffuseMaps() {
             mTileMap.updateDiffuseMaps();
         }
-    }
-}
 
 
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setTilePrefetchEnabled(bool enabled) {
+            mTileMap.setPrefetchEnabled(enabled);
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setTileLodLevels(int levels) {
+            mTileMap.setLodLevels(levels);
+            mResetTileMap();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setTileAtlasEnabled(bool enabled) {
+            mTileMap.setAtlasEnabled(enabled);
+            mResetTileMap();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::mRemoveTiles() {
+            if (mTileMap.getGround() != nullptr) {
+                mScene.removeEntity(mTileMap.getGround());
+            } else {
+                for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
+                    mScene.removeEntity(tile);
+                }
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::mResetTileMap() {
+            if (mTileMap.getTiles().empty()) {
+                return; // not initialized yet
+            }
+            mRemoveTiles();
+            mTileMap.unload();
+            init();
+            if (mLastX != -1) {
+                mTileMap.update(mLastX, mLastY);
+            }
+        }
+    }
+}
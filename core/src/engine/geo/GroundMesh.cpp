@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/GroundMesh.hpp"
+
+#include <algorithm>
+
+
+namespace dma {
+    namespace geo {
+
+        constexpr U32 FLOATS_PER_VERTEX = 11; // position, uv, flat normal, smooth normal
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        GroundMesh::GroundMesh(U32 tileCount) :
+                Mesh(),
+                mTiles(tileCount, {glm::vec3(0.0f), 0.0f, 0.0f, glm::vec4(0.0f)}),
+                mData(tileCount * 4 * FLOATS_PER_VERTEX, 0.0f)
+        {
+            mSID = "ground";
+            U32 offset = 0;
+            VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, offset);
+            offset += positionElement.getSizeInByte();
+            addVertexElement(positionElement);
+
+            VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, offset);
+            offset += uvElement.getSizeInByte();
+            addVertexElement(uvElement);
+
+            VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, offset);
+            offset += flatNormalElement.getSizeInByte();
+            addVertexElement(flatNormalElement);
+
+            VertexElement smoothNormalElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_FLOAT, offset);
+            offset += smoothNormalElement.getSizeInByte();
+            addVertexElement(smoothNormalElement);
+
+            mVertexSize = offset;
+            mVertexCount = tileCount * 4;
+            mVertexBuffer = std::make_shared<VertexBuffer>();
+            mIndexBuffer = std::make_shared<IndexBuffer>();
+        }
+
+
+        //------------------------------------------------------------------------
+        GroundMesh::~GroundMesh() {}
+
+
+        //------------------------------------------------------------------------
+        void GroundMesh::init() {
+            std::vector<U16> indices(mTiles.size() * 6);
+            for (U32 i = 0; i < mTiles.size(); ++i) {
+                U16 base = (U16) (i * 4);
+                // bottom left - top left - top right, bottom left - top right - bottom right
+                U16 quad[] = {0, 2, 1, 0, 3, 2};
+                for (U32 k = 0; k < 6; ++k) {
+                    indices[i * 6 + k] = base + quad[k];
+                }
+            }
+            mVertexBuffer->generateBuffer(mVertexSize, mVertexSize * mVertexCount);
+            mIndexBuffer->generateBuffer((U32) indices.size());
+            mIndexBuffer->writeData(indices.data());
+            upload();
+        }
+
+
+        //------------------------------------------------------------------------
+        void GroundMesh::setTile(U32 index, const glm::vec3& center, F32 width, F32 height) {
+            mTiles[index].center = center;
+            mTiles[index].width = width;
+            mTiles[index].height = height;
+        }
+
+
+        //------------------------------------------------------------------------
+        void GroundMesh::setTileRect(U32 index, const glm::vec4& rect) {
+            mTiles[index].rect = rect;
+        }
+
+
+        //------------------------------------------------------------------------
+        void GroundMesh::upload() {
+            glm::vec3 min(0.0f), max(0.0f);
+            bool empty = true;
+            for (const TileQuad& tile : mTiles) {
+                if (tile.width == 0.0f) {
+                    continue; // not placed yet
+                }
+                glm::vec3 half(tile.width / 2.0f, 0.0f, tile.height / 2.0f);
+                min = empty ? tile.center - half : glm::min(min, tile.center - half);
+                max = empty ? tile.center + half : glm::max(max, tile.center + half);
+                empty = false;
+            }
+            // same corners and texture coordinates as a Quad, lying on the ground
+            static const F32 corners[4][4] = {{-1.0f, -1.0f, 0.0f, 0.0f},
+                                              {-1.0f,  1.0f, 0.0f, 1.0f},
+                                              { 1.0f,  1.0f, 1.0f, 1.0f},
+                                              { 1.0f, -1.0f, 1.0f, 0.0f}};
+            F32* data = mData.data();
+            for (const TileQuad& tile : mTiles) {
+                const glm::vec3& c = tile.center;
+                for (U32 k = 0; k < 4; ++k, data += FLOATS_PER_VERTEX) {
+                    data[0] = c.x + corners[k][0] * tile.width / 2.0f;
+                    data[1] = c.y;
+                    data[2] = c.z - corners[k][1] * tile.height / 2.0f;
+                    data[3] = glm::mix(tile.rect.x, tile.rect.z, corners[k][2]);
+                    data[4] = glm::mix(tile.rect.y, tile.rect.w, corners[k][3]);
+                    data[5] = data[8] = 0.0f;
+                    data[6] = data[9] = 1.0f;
+                    data[7] = data[10] = 0.0f;
+                }
+            }
+            mVertexBuffer->writeData(0, (U32) (mData.size() * sizeof(F32)), mData.data());
+
+            mBoundingSphere = BoundingSphere((min + max) / 2.0f, glm::length(max - min) / 2.0f);
+        }
+    }
+}
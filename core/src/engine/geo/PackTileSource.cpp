@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/PackTileSource.hpp"
+
+
+namespace dma {
+    namespace geo {
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        PackTileSource::PackTileSource(const std::string& filename) {
+            mPack.open(filename);
+        }
+
+
+        //------------------------------------------------------------------------
+        PackTileSource::~PackTileSource() {}
+
+
+        //------------------------------------------------------------------------
+        Status PackTileSource::read(int x, int y, int z, std::vector<BYTE>& data) {
+            U32 size;
+            // the mapped pages are only read: no lock needed
+            const BYTE* png = mPack.find(x, y, z, size);
+            if (png == nullptr) {
+                return STATUS_KO;
+            }
+            data.assign(png, png + size);
+            return STATUS_OK;
+        }
+    }
+}
@@ -88,14 +88,14 @@ namespace dma {
             }
 
             mCurrentTranslationAnimation =
-                    new TranslationAnimation(*mTransformComponent,
-                                             mTransformComponent->getPosition(),
-                                             mTransformComponent->getPosition() + glm::vec3(0.0f, 2.0f, 0.0f),
+                    new TranslationAnimation(mTransformComponent,
+                                             mTransformComponent.getPosition(),
+                                             mTransformComponent.getPosition() + glm::vec3(0.0f, 2.0f, 0.0f),
                                              3.0f, TranslationAnimation::Function::EASE, true, true);
             mAnimationComponent->add(mCurrentTranslationAnimation);
 
             mCurrentRotationAnimation =
-                    new RotationAnimation(*mTransformComponent,
+                    new RotationAnimation(mTransformComponent,
                                           4.0f, true, 360.0f,
                                           glm::normalize(glm::vec3(0.0f, 1.0f, 0.0f)));
             mAnimationComponent->add(mCurrentRotationAnimation);
@@ -135,7 +135,7 @@ namespace dma {
         //---------------------------------------------------------------
         bool Poi::intersects(const glm::vec3 &ray, const glm::vec3& origin) {
             const BoundingSphere& boundingSphere = mRenderingComponent->getMesh()->getBoundingSphere();
-            glm::vec3 oc = origin - glm::vec3(mTransformComponent->getM() * glm::vec4(boundingSphere.getCenter(), 1.0f));
+            glm::vec3 oc = origin - glm::vec3(mTransformComponent.getM() * glm::vec4(boundingSphere.getCenter(), 1.0f));
             float b = glm::dot<float>(ray, oc);
             float c = glm::dot<float>(oc, oc) - boundingSphere.getRadius() * boundingSphere.getRadius();
 
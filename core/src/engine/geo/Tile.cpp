@@ -32,6 +32,8 @@ namespace dma {
                 Entity(quad, material),
                 mCoords(coords),
                 x(x), y(y), z(z),
+                slot(-1),
+                mAtlasDirty(false),
                 mQuad(quad)
         {
             pitch(-90.0f);
@@ -66,6 +68,7 @@ namespace dma {
         //--------------------------------------------------------------------------
         void Tile::setDiffuseMap(std::shared_ptr<Map> diffuseMap) {
             getMaterial()->setDiffuseMap(diffuseMap, TILE_PASS_INDEX);
+            mAtlasDirty = true;
         }
 
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "engine/geo/TileGrid.hpp"
+
+#include <algorithm>
+
+
+namespace dma {
+    namespace geo {
+
+        /* ================= ROUTINES ========================*/
+
+        //------------------------------------------------------------------------
+        /**
+         * Calls f on the tiles within a but not within b, visiting only those.
+         */
+        static void forEachOutside(const TileGrid::Bounds& a, const TileGrid::Bounds& b,
+                                   const TileGrid::CellFunc& f) {
+            for (int x = a.x0; x <= a.x1; ++x) {
+                if (x < b.x0 || x > b.x1) {
+                    for (int y = a.y0; y <= a.y1; ++y) {
+                        f(x, y);
+                    }
+                } else {
+                    for (int y = a.y0; y <= std::min(a.y1, b.y0 - 1); ++y) {
+                        f(x, y);
+                    }
+                    for (int y = std::max(a.y0, b.y1 + 1); y <= a.y1; ++y) {
+                        f(x, y);
+                    }
+                }
+            }
+        }
+
+
+        //------------------------------------------------------------------------
+        static void forEachWithin(const TileGrid::Bounds& a, const TileGrid::CellFunc& f) {
+            for (int x = a.x0; x <= a.x1; ++x) {
+                for (int y = a.y0; y <= a.y1; ++y) {
+                    f(x, y);
+                }
+            }
+        }
+
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        TileGrid::TileGrid() :
+                mWidth(1),
+                mOuter({0, 0, -1, -1}),
+                mHole({0, 0, -1, -1})
+        {}
+
+
+        //------------------------------------------------------------------------
+        TileGrid::~TileGrid() {}
+
+
+        //------------------------------------------------------------------------
+        void TileGrid::reset(int width) {
+            mWidth = width;
+            mOuter = mHole = {0, 0, -1, -1};
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileGrid::move(const Bounds& outer, const Bounds& hole, const CellFunc& release, const CellFunc& assign) {
+            const Bounds oldOuter = mOuter;
+            const Bounds oldHole = mHole;
+            mOuter = outer;
+            mHole = hole;
+
+            if (!outer.overlaps(oldOuter)) {
+                // jumped, or first move
+                forEachWithin(oldOuter, [&](int x, int y) {
+                    if (!oldHole.contains(x, y)) {
+                        release(x, y);
+                    }
+                });
+                forEachWithin(outer, [&](int x, int y) {
+                    if (!hole.contains(x, y)) {
+                        assign(x, y);
+                    }
+                });
+                return;
+            }
+
+            // all released first, for their tiles to be reused
+            forEachOutside(oldOuter, outer, [&](int x, int y) {
+                if (!oldHole.contains(x, y)) {
+                    release(x, y);
+                }
+            });
+            forEachWithin(hole, [&](int x, int y) {
+                if (oldOuter.contains(x, y) && !oldHole.contains(x, y)) {
+                    release(x, y);
+                }
+            });
+
+            forEachOutside(outer, oldOuter, [&](int x, int y) {
+                if (!hole.contains(x, y)) {
+                    assign(x, y);
+                }
+            });
+            forEachWithin(oldHole, [&](int x, int y) {
+                if (outer.contains(x, y) && !hole.contains(x, y)) {
+                    assign(x, y);
+                }
+            });
+        }
+    }
+}
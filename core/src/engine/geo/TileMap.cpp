@@ -18,6 +18,9 @@
 
 #include <utils/GeoUtils.hpp>
 #include <string.h>
+#include <chrono>
+#include <cstdio>
+#include <functional>
 #include "utils/Utils.hpp"
 #include "engine/geo/TileMap.hpp"
 
@@ -31,6 +34,23 @@ namespace dma {
         constexpr int TileMap::SIZE;
         constexpr int TileMap::OFFSET;
         constexpr int TileMap::ZOOM;
+        constexpr int TileMap::MAX_LOD_LEVELS;
+        constexpr int TileMap::LOD_SIZE;
+        constexpr U32 TileMap::ATLAS_SLOT_SIZE;
+        constexpr U32 TileMap::HISTORY_SIZE;
+        constexpr double TileMap::HISTORY_MIN_SECONDS;
+        constexpr double TileMap::PREFETCH_MIN_SPEED;
+        constexpr double TileMap::PREFETCH_HALF_ANGLE;
+        constexpr double TileMap::PREFETCH_TOLERANCE;
+
+        //---------------------------------------------------------------------------
+        /**
+         * @return the absolute difference between two angles in radians, in [0, pi]
+         */
+        static double angleBetween(double a, double b) {
+            double d = fmod(fabs(a - b), 2.0 * M_PI);
+            return d > M_PI ? 2.0 * M_PI - d : d;
+        }
 
         //---------------------------------------------------------------------------
         bool TileMap::isInRange(int x, int y, int xp, int yp) {
@@ -50,8 +70,24 @@ namespace dma {
                 mResourceManager(resourceManager),
                 mLastX(-1),
                 mLastY(-1),
+                mLodLevels(1),
+                mSidPrefix("tiles/"),
                 mNullCallbacks(new GeoEngineCallbacks()),
-                mCallbacks(mNullCallbacks) {
+                mCallbacks(mNullCallbacks),
+                mRequests([this](int x, int y, int z, bool prefetch) { mIssueTile(x, y, z, prefetch); },
+                          [this](int x, int y, int z) {
+                              if (mTileProvider != nullptr && mTileProvider->getNamespace() == mNamespace) {
+                                  mTileProvider->cancel(x, y, z);
+                              } else {
+                                  mCallbacks->onTileCancel(x, y, z);
+                              }
+                          }),
+                mAtlasEnabled(false),
+                mGroundDirty(false),
+                mPrefetchX(-1),
+                mPrefetchY(-1),
+                mPrefetchHeading(0.0),
+                mPrefetchEnabled(true) {
 
         }
 
@@ -66,23 +102,60 @@ namespace dma {
         //---------------------------------------------------------------------------
         void TileMap::init() {
             mLastX = mLastY = -1;
-            // Create TILE_MAP_SIZE * TILE_MAP_SIZE tiles
-            for (int i = 0; i < SIZE * SIZE; ++i) {
-                std::shared_ptr<Quad> quad = mResourceManager.createQuad(1.0f, 1.0f);
-                Status status;
-                std::shared_ptr<Material> mat = mResourceManager.createMaterial(TILE_MATERIAL, &status); //material with default tile texture
-                std::shared_ptr<Tile> tile = std::make_shared<Tile>(quad, mat);
-                //TODO remove set in material tile.json tile->setDiffuseMap(mResourceManager.acquireTexture(DEFAULT_TILE_DIFFUSE_MAP, &status));
-                tile->mDirty = true;
-                mTiles.push_back(tile);
+            for (int level = 0; level < mLodLevels; ++level) {
+                Level& l = mLevels[level];
+                int width, count;
+                if (level == 0) {
+                    // SIZE being odd, aligned on even tiles it spans SIZE + 1
+                    width = mLodLevels == 1 ? SIZE : SIZE + 1;
+                    count = width * width;
+                } else {
+                    width = LOD_SIZE;
+                    count = LOD_SIZE * LOD_SIZE - (LOD_SIZE / 2) * (LOD_SIZE / 2);
+                }
+                l.grid.reset(width);
+                l.cells.assign(width * width, nullptr);
+                l.rows.assign(width, {-1, 0.0, 0.0f, 0.0f});
+                for (int i = 0; i < count; ++i) {
+                    std::shared_ptr<Quad> quad = mLodLevels == 1 ?
+                                                 mResourceManager.createQuad(1.0f, 1.0f) :
+                                                 mResourceManager.createSkirtedQuad(1.0f, 1.0f);
+                    Status status;
+                    std::shared_ptr<Material> mat = mResourceManager.createMaterial(TILE_MATERIAL, &status); //material with default tile texture
+                    std::shared_ptr<Tile> tile = std::make_shared<Tile>(quad, mat);
+                    //TODO remove set in material tile.json tile->setDiffuseMap(mResourceManager.acquireTexture(DEFAULT_TILE_DIFFUSE_MAP, &status));
+                    tile->mDirty = true;
+                    tile->slot = (int) mTiles.size();
+                    mTiles.push_back(tile);
+                    l.spare.push_back(tile);
+                }
             }
+
+            if (mAtlasEnabled) {
+                mInitAtlas();
+            }
+            mResourceManager.setTileTexturesEnabled(mAtlas == nullptr);
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::unload() {
+            wipe();
+            mAtlas = nullptr;
+            mGroundMesh = nullptr;
+            mGround = nullptr;
+            mFallbackMap = nullptr;
             mRemoveAllTiles();
+            for (int level = 0; level < MAX_LOD_LEVELS; ++level) {
+                mLevels[level].cells.clear();
+                mLevels[level].rows.clear();
+                mLevels[level].spare.clear();
+            }
             mLastX = mLastY = -1;
+            mRequests.clear();
+            mHistory.clear();
+            mPrefetched.clear();
+            mPrefetchX = mPrefetchY = -1;
         }
 
 
@@ -95,79 +168,290 @@ namespace dma {
                 return;
             }
 
-            int z = ZOOM;
             // if update gives the same tile : skip.
             if (x0 == mLastX && y0 == mLastY) {
                 return;
             }
 
-            double coords[SIZE+1][SIZE+1][2];
-
-            for (int x = x0 - OFFSET; x <= x0 + OFFSET + 1; ++x) {
-                for (int y = y0 - OFFSET; y <= y0 + OFFSET + 1; ++y) {
-                    double tileLat = GeoUtils::tiley2lat(y, z);
-                    double tileLon = GeoUtils::tilex2long(x, z);
-                    coords[x-(x0 -OFFSET)][y-(y0 -OFFSET)][0] = tileLat;
-                    coords[x-(x0 -OFFSET)][y-(y0 -OFFSET)][1] = tileLon;
+            Bounds outer = {x0 - OFFSET, y0 - OFFSET, x0 + OFFSET, y0 + OFFSET};
+            Bounds hole = {0, 0, -1, -1};
+            for (int level = 0; level < mLodLevels; ++level) {
+                if (level > 0) {
+                    // the previous level, in tiles of this one
+                    hole = {outer.x0 >> 1, outer.y0 >> 1, outer.x1 >> 1, outer.y1 >> 1};
+                    outer.x0 = (hole.x0 - LOD_SIZE / 4) & ~1;
+                    outer.y0 = (hole.y0 - LOD_SIZE / 4) & ~1;
+                    outer.x1 = outer.x0 + LOD_SIZE - 1;
+                    outer.y1 = outer.y0 + LOD_SIZE - 1;
+                }
+                if (level + 1 < mLodLevels) {
+                    // covers whole tiles of the next level
+                    outer.x0 &= ~1;
+                    outer.y0 &= ~1;
+                    outer.x1 |= 1;
+                    outer.y1 |= 1;
                 }
+                mUpdateLevel(level, outer, hole);
             }
 
-            bool isUpToDate[SIZE][SIZE];
-            memset(isUpToDate, 0, SIZE*SIZE);
+            mResourceManager.update(); // unload unused resources
 
-            std::list<std::shared_ptr<Tile>> toUpdate;
+            mLastX = x0;
+            mLastY = y0;
+        }
 
-            for (auto tile : mTiles) {
-                if (isInRange(tile->x, tile->y, x0, y0)) {
-                    int i = tile->x - x0 + OFFSET;
-                    int j = tile->y - y0 + OFFSET;
-                    isUpToDate[i][j] = true;
-                } else {
-                    toUpdate.push_back(tile);
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateLevel(int level, const Bounds& outer, const Bounds& hole) {
+            Level& l = mLevels[level];
+            l.grid.move(outer, hole,
+                        [&](int x, int y) { mReleaseCell(l, x, y); },
+                        [&](int x, int y) { mAssignCell(level, x, y); });
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mReleaseCell(Level& level, int x, int y) {
+            std::shared_ptr<Tile>& cell = level.cell(x, y);
+            if (cell != nullptr) {
+                mCancelTile(cell->x, cell->y, cell->z);
+                level.spare.push_back(cell);
+                cell = nullptr;
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mAssignCell(int level, int x, int y) {
+            Level& l = mLevels[level];
+            const int z = ZOOM - level;
+            assert(!l.spare.empty());
+            std::shared_ptr<Tile> tile = l.spare.back();
+            l.spare.pop_back();
+            l.cell(x, y) = tile;
+
+            const Row& row = mGetRow(l, y, z);
+            Status status = mUpdateTile(tile, row.lat, GeoUtils::tilex2long(x, z), row.width, row.height, x, y, z);
+            if (status != STATUS_OK) {
+                std::stringstream ss;
+                ss << "error while creating tilemap level " << level
+                << " with tile (" << x << ", " << y << ", " << z << ")";
+                Log::error(TAG, ss.str());
+                throw std::runtime_error(ss.str());
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        const TileMap::Row& TileMap::mGetRow(Level& level, int y, int z) {
+            Row& row = level.rows[TileGrid::wrap(y, level.grid.getWidth())];
+            if (row.y != y) {
+                // the distances only depend on the latitude, and on the longitude span
+                double lat = GeoUtils::tiley2lat(y, z);
+                double bottomLat = GeoUtils::tiley2lat(y + 1, z);
+                double span = GeoUtils::tilex2long(1, z) - GeoUtils::tilex2long(0, z);
+                row.y = y;
+                row.lat = lat;
+                row.width = (float) GeoUtils::slc(LatLng(lat, 0.0), LatLng(lat, span));
+                row.height = (float) GeoUtils::slc(LatLng(lat, 0.0), LatLng(bottomLat, 0.0));
+            }
+            return row;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setLodLevels(int levels) {
+            mLodLevels = std::max(1, std::min(levels, MAX_LOD_LEVELS));
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setAtlasEnabled(bool enabled) {
+            mAtlasEnabled = enabled;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::refresh() {
+            if (mAtlas == nullptr) {
+                return;
+            }
+            // the previous GL objects went with the context
+            mAtlas->create();
+            mGroundMesh->init();
+            if (mFallbackMap->getImage() != nullptr) {
+                mAtlas->upload(0, *mFallbackMap->getImage());
+            }
+            for (std::shared_ptr<Tile>& tile : mTiles) {
+                tile->mAtlasDirty = true;
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::wipe() {
+            if (mAtlas != nullptr) {
+                mAtlas->wipe();
+                mGroundMesh->wipe();
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mInitAtlas() {
+            U32 slotsPerRow = 1;
+            // the first slot for the default map
+            while (slotsPerRow * slotsPerRow < mTiles.size() + 1) {
+                slotsPerRow <<= 1;
+            }
+            mAtlas = std::make_shared<TextureAtlas>(ATLAS_SLOT_SIZE, slotsPerRow);
+            if (mAtlas->create() != STATUS_OK) {
+                Log::warn(TAG, "Unable to create the tile atlas, drawing tiles one by one");
+                mAtlas = nullptr;
+                return;
+            }
+
+            mFallbackMap = mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP);
+            if (mFallbackMap->getImage() != nullptr) {
+                mAtlas->upload(0, *mFallbackMap->getImage());
+            }
+
+            mGroundMesh = std::make_shared<GroundMesh>((U32) mTiles.size());
+            for (std::shared_ptr<Tile>& tile : mTiles) {
+                mGroundMesh->setTileRect(tile->slot, mAtlas->getSlotRect(0));
+                tile->mAtlasDirty = true;
+            }
+            mGroundMesh->init();
+
+            Status status;
+            std::shared_ptr<Material> mat = mResourceManager.createMaterial(TILE_MATERIAL, &status);
+            mat->setDiffuseMap(mAtlas, 0);
+            mGround = std::make_shared<Entity>(mGroundMesh, mat);
+            mGroundDirty = true;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateAtlas() {
+            for (std::shared_ptr<Tile>& tile : mTiles) {
+                if (!tile->mAtlasDirty) {
+                    continue;
                 }
+                tile->mAtlasDirty = false;
+                U32 slot = 0;
+                std::shared_ptr<Map> map = tile->getDiffuseMap();
+                if (map != nullptr && map != mFallbackMap && map->getImage() != nullptr
+                    && mAtlas->upload(tile->slot + 1, *map->getImage()) == STATUS_OK) {
+                    slot = tile->slot + 1;
+                }
+                mGroundMesh->setTileRect(tile->slot, mAtlas->getSlotRect(slot));
+                mGroundDirty = true;
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mPlaceTile(const Tile& tile) {
+            if (mGroundMesh != nullptr) {
+                mGroundMesh->setTile(tile.slot, tile.getPosition(), tile.getQuad().getWidth(), tile.getQuad().getHeight());
+                mGroundDirty = true;
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateGround() {
+            if (mGroundMesh != nullptr && mGroundDirty) {
+                mGroundMesh->upload();
+                // the entity stays at the origin, but its bounds changed
+                mGround->getTransformComponent().setDirty(true);
+                mGroundDirty = false;
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::track(double x, double y) {
+            std::chrono::duration<double> now = std::chrono::steady_clock::now().time_since_epoch();
+            mHistory.push_back({x, y, now.count()});
+            if (mHistory.size() > HISTORY_SIZE) {
+                mHistory.pop_front();
+            }
+
+            if (!mPrefetchEnabled || mLastX == -1) {
+                return;
+            }
+            const Sample& first = mHistory.front();
+            const Sample& last = mHistory.back();
+            double dt = last.time - first.time;
+            if (dt < HISTORY_MIN_SECONDS) {
+                return;
+            }
+            double vx = (last.x - first.x) / dt;
+            double vy = (last.y - first.y) / dt;
+            if (sqrt(vx * vx + vy * vy) < PREFETCH_MIN_SPEED) {
+                // standing still: what was prefetched may still be needed
+                return;
+            }
+            double heading = atan2(vy, vx);
+            if (mLastX == mPrefetchX && mLastY == mPrefetchY
+                && angleBetween(heading, mPrefetchHeading) < glm::radians(PREFETCH_TOLERANCE)) {
+                return;
             }
 
-            for (int x = x0 - OFFSET; x <= x0 + OFFSET; ++x) {
-                for (int y = y0 - OFFSET; y <= y0 + OFFSET; ++y) {
-                    int i = x - x0 + OFFSET;
-                    int j = y - y0 + OFFSET;
-                    if (!isUpToDate[i][j]) {
-                        std::shared_ptr<Tile> tile = toUpdate.front();
-                        toUpdate.pop_front();
-                        double tileLat = coords[i][j][0];
-                        double tileLng = coords[i][j][1];
-
-                        double rightTileLat = coords[i + 1][j][0];
-                        double rightTileLng = coords[i + 1][j][1];
-
-                        double bottomTileLat = coords[i][j + 1][0];
-                        double bottomTileLon = coords[i][j + 1][1];
-
-                        float width = (float) GeoUtils::slc(LatLng(tileLat, tileLng), LatLng(rightTileLat, rightTileLng));
-                        float height = (float) GeoUtils::slc(LatLng(tileLat, tileLng), LatLng(bottomTileLat, bottomTileLon));
-                        Status status = mUpdateTile(tile, tileLat, tileLng, width, height, x, y, z);
-                        if (status != STATUS_OK) {
-                            std::stringstream ss;
-                            ss << "error while creating tilemap (" << x0 << "," << y0
-                            << ") with tile (" << x << ", " << y << ", " << z << ")";
-                            Log::error(TAG, ss.str());
-                            throw std::runtime_error(ss.str());
-                        }
+            // the ring just beyond the map, ahead of the camera
+            std::set<std::pair<int, int>> prefetched;
+            const int r = OFFSET + 1;
+            const double minCos = cos(glm::radians(PREFETCH_HALF_ANGLE));
+            for (int dx = -r; dx <= r; ++dx) {
+                for (int dy = -r; dy <= r; ++dy) {
+                    if (abs(dx) != r && abs(dy) != r) {
+                        continue;
+                    }
+                    double cosine = (dx * cos(heading) + dy * sin(heading)) / sqrt(double(dx * dx + dy * dy));
+                    if (cosine >= minCos) {
+                        prefetched.insert(std::make_pair(mLastX + dx, mLastY + dy));
                     }
                 }
             }
 
-            mResourceManager.update(); // unload unused resources
+            for (const std::pair<int, int>& tile : mPrefetched) {
+                if (prefetched.find(tile) == prefetched.end()
+                    && !isInRange(tile.first, tile.second, mLastX, mLastY)) {
+                    mCancelTile(tile.first, tile.second, ZOOM);
+                }
+            }
+            for (const std::pair<int, int>& tile : prefetched) {
+                if (mPrefetched.find(tile) == mPrefetched.end()) {
+                    mPrefetchTile(tile.first, tile.second);
+                }
+            }
+            mPrefetched.swap(prefetched);
+            mPrefetchX = mLastX;
+            mPrefetchY = mLastY;
+            mPrefetchHeading = heading;
+        }
 
-            mLastX = x0;
-            mLastY = y0;
+
+        //---------------------------------------------------------------------------
+        void TileMap::setPrefetchEnabled(bool enabled) {
+            mPrefetchEnabled = enabled;
+            if (!enabled) {
+                mCancelPrefetch();
+            }
         }
 
 
         //---------------------------------------------------------------------------
         Status TileMap::notifyTileAvailable(int x, int y, int z) {
             Log::trace(TAG, "Notifying tile available (%d, %d, %d)", x, y, z);
+            mRequests.complete(x, y, z);
             std::shared_ptr<Tile> tile = findTile(x, y, z);
+            if (tile == nullptr && z == ZOOM && mPrefetched.find(std::make_pair(x, y)) != mPrefetched.end()) {
+                // decoded ahead of the camera
+                mResourceManager.requestMap(tileSid(x, y, z));
+                return STATUS_OK;
+            }
             if (tile == nullptr) {
                 std::stringstream ss;
                 ss <<"Trying to set Tile Image but Tile (" << x << ", " << y << ", " << z << ") doesn't exist in the TileMap";
@@ -176,16 +460,43 @@ namespace dma {
                 //throw std::runtime_error(ss.str());
                 //throwException(TAG, ExceptionType::NO_SUCH_ELEMENT, ss.str());
             }
-            std::string sid = tileSid(x, y, z);
-            std::shared_ptr<Map> diffuseMap = mResourceManager.acquireMap(sid);
-            tile->setDiffuseMap(diffuseMap);
+            // decoded in the background, the default map staying until then
+            mResourceManager.requestMap(tileSid(x, y, z));
             return STATUS_OK;
         }
 
 
+        //---------------------------------------------------------------------------
+        void TileMap::step() {
+            // nearest to the camera first
+            if (!mHistory.empty()) {
+                mRequests.flush(mHistory.back().x, mHistory.back().y, ZOOM);
+            } else {
+                mRequests.flush(mLastX + 0.5, mLastY + 0.5, ZOOM);
+            }
+
+            mUploadedMaps.clear();
+            mResourceManager.uploadMaps(mUploadedMaps);
+            for (const std::string& sid : mUploadedMaps) {
+                int x, y, z;
+                std::shared_ptr<Tile> tile;
+                if (mParseSid(sid, x, y, z) && (tile = findTile(x, y, z)) != nullptr) {
+                    tile->setDiffuseMap(mResourceManager.acquireMap(sid));
+                }
+                // otherwise the tile has left the map meanwhile,
+                // the map being unloaded by the next ResourceManager::update
+            }
+
+            if (mAtlas != nullptr) {
+                mUpdateAtlas();
+            }
+        }
+
+
         //---------------------------------------------------------------------------
         Status TileMap::mUpdateTile(std::shared_ptr<Tile> tile, double lat, double lng, float width, float height, int x , int y, int z) {
 
+            // the previous tile's requests were cancelled when it left its cell
             tile->x = x;
             tile->y = y;
             tile->z = z;
@@ -193,19 +504,7 @@ namespace dma {
             tile->mCoords.lat = lat;
             tile->mCoords.lng = lng;
 
-            std::shared_ptr<Map> diffuseMap;
-
-            std::string sid = tileSid(x, y, z);
-
-            diffuseMap = mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP);
-            if (mResourceManager.hasMap(sid)) {
-                diffuseMap = mResourceManager.acquireMap(sid);
-            } else if (!mNamespace.empty()) {
-                Log::trace(TAG, "No tile found with sid %s", sid.c_str());
-                mCallbacks->onTileRequest(x, y, z);
-            }
-
-            tile->setDiffuseMap(diffuseMap);
+            mAssignDiffuseMap(*tile);
             tile->setDirty(true);
             //Log::trace(TAG, "Tile (%d, %d, %d) updated, diffuse map: %s", x, y, z, diffuseMap->getSID().c_str());
             return STATUS_OK;
@@ -220,49 +519,143 @@ namespace dma {
 
         //---------------------------------------------------------------------------
         std::shared_ptr<Tile> TileMap::findTile(int x, int y, int z) {
-            for (auto tile : mTiles) {
-                if (tile->x == x && tile->y == y && tile->z == z) {
-                    return tile;
-                }
+            int level = ZOOM - z;
+            if (level < 0 || level >= mLodLevels) {
+                return nullptr;
+            }
+            Level& l = mLevels[level];
+            if (l.cells.empty() || !l.grid.contains(x, y)) {
+                return nullptr;
             }
-            return nullptr;
+            return l.cell(x, y);
         }
 
 
         //---------------------------------------------------------------------------
         std::string TileMap::tileSid(int x, int y, int z) const {
-            std::stringstream ssid;
-            ssid << "tiles/";
-            if (!mNamespace.empty()) {
-                ssid << mNamespace << "/";
+            char zxy[40];
+            snprintf(zxy, sizeof(zxy), "%d/%d/%d", z, x, y);
+            return mSidPrefix + zxy;
+        }
+
+
+        //---------------------------------------------------------------------------
+        bool TileMap::mParseSid(const std::string& sid, int& x, int& y, int& z) const {
+            if (sid.compare(0, mSidPrefix.size(), mSidPrefix) != 0) {
+                return false;
             }
-            ssid << z << "/" << x << "/" << y;
-            return ssid.str();
+            int length = 0;
+            return sscanf(sid.c_str() + mSidPrefix.size(), "%d/%d/%d%n", &z, &x, &y, &length) == 3
+                   && mSidPrefix.size() + length == sid.size();
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::setNamespace(const std::string &ns) {
             Log::debug(TAG, "Setting namespace: %s", ns.c_str());
+            mCancelPrefetch();
+            // to the previous provider or callbacks
+            mRequests.cancelAll();
             mNamespace = ns;
-            if (mTiles.front()->x != -1) { // -1 means tile map not set
+            mSidPrefix = ns.empty() ? "tiles/" : "tiles/" + ns + "/";
+            if (!mTiles.empty() && mTiles.front()->x != -1) { // -1 means tile map not set
                 updateDiffuseMaps();
             }
         }
 
 
+        //---------------------------------------------------------------------------
+        void TileMap::setTileProvider(std::shared_ptr<ITileProvider> provider) {
+            mRequests.cancelAll();
+            if (mTileProvider != nullptr) {
+                mTileProvider->detach(mResourceManager);
+            }
+            mTileProvider = provider;
+            if (mTileProvider != nullptr) {
+                mTileProvider->attach(mResourceManager);
+                setNamespace(mTileProvider->getNamespace());
+            }
+        }
+
+
         //---------------------------------------------------------------------------
         void TileMap::updateDiffuseMaps() {
             for (std::shared_ptr<Tile> tile : mTiles) {
-                std::string sid = tileSid(tile->x, tile->y, tile->z);
-                if (mResourceManager.hasMap(sid)) {
-                    tile->setDiffuseMap(mResourceManager.acquireMap(sid));
-                } else {
-                    tile->setDiffuseMap(mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP));
-                    mCallbacks->onTileRequest(tile->x, tile->y, tile->z);
-                }
+                mAssignDiffuseMap(*tile);
                 tile->setDirty(true);
             }
         }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mAssignDiffuseMap(Tile& tile) {
+            std::string sid = tileSid(tile.x, tile.y, tile.z);
+            if (mResourceManager.isMapLoaded(sid)) {
+                tile.setDiffuseMap(mResourceManager.acquireMap(sid));
+                return;
+            }
+            tile.setDiffuseMap(mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP));
+            if (mResourceManager.hasMap(sid)) {
+                mResourceManager.requestMap(sid);
+            } else {
+                Log::trace(TAG, "No tile found with sid %s", sid.c_str());
+                mFetchTile(tile.x, tile.y, tile.z, false);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mPrefetchTile(int x, int y) {
+            std::string sid = tileSid(x, y, ZOOM);
+            if (mResourceManager.isMapLoaded(sid)) {
+                return;
+            }
+            if (mResourceManager.hasMap(sid)) {
+                mResourceManager.requestMap(sid);
+            } else {
+                mFetchTile(x, y, ZOOM, true);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mFetchTile(int x, int y, int z, bool prefetch) {
+            bool provided = mTileProvider != nullptr && mTileProvider->getNamespace() == mNamespace;
+            if (provided || !mNamespace.empty()) {
+                mRequests.request(x, y, z, prefetch);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mIssueTile(int x, int y, int z, bool prefetch) {
+            if (mTileProvider != nullptr && mTileProvider->getNamespace() == mNamespace) {
+                mTileProvider->fetch(x, y, z);
+            } else if (prefetch) {
+                mCallbacks->onTilePrefetch(x, y, z);
+            } else {
+                mCallbacks->onTileRequest(x, y, z);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mCancelTile(int x, int y, int z) {
+            mResourceManager.cancelMapRequest(tileSid(x, y, z));
+            mRequests.cancel(x, y, z);
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mCancelPrefetch() {
+            for (const std::pair<int, int>& tile : mPrefetched) {
+                if (!isInRange(tile.first, tile.second, mLastX, mLastY)) {
+                    mCancelTile(tile.first, tile.second, ZOOM);
+                }
+            }
+            mPrefetched.clear();
+            // renewed at the next track()
+            mPrefetchX = mPrefetchY = -1;
+        }
     }
 }
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/TilePackProvider.hpp"
+#include "resource/ResourceManager.hpp"
+#include "utils/Log.hpp"
+
+
+constexpr auto TAG = "TilePackProvider";
+
+namespace dma {
+    namespace geo {
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        TilePackProvider::TilePackProvider(const std::string& filename, const std::string& ns) :
+                mPack(std::make_shared<TilePack>()),
+                mNamespace(ns)
+        {
+            if (mPack->open(filename) == STATUS_OK) {
+                Log::debug(TAG, "%u tiles in %s", mPack->getTileCount(), filename.c_str());
+            }
+        }
+
+
+        //------------------------------------------------------------------------
+        TilePackProvider::~TilePackProvider() {}
+
+
+        //------------------------------------------------------------------------
+        void TilePackProvider::attach(ResourceManager& resourceManager) {
+            resourceManager.addTilePack(mNamespace, mPack);
+        }
+
+
+        //------------------------------------------------------------------------
+        void TilePackProvider::detach(ResourceManager& resourceManager) {
+            resourceManager.removeTilePack(mNamespace);
+        }
+
+
+        //------------------------------------------------------------------------
+        void TilePackProvider::fetch(int x, int y, int z) {
+            Log::trace(TAG, "Tile (%d, %d, %d) not in %s", x, y, z, mPack->getFilename().c_str());
+        }
+    }
+}
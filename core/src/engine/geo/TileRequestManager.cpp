@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/TileRequestManager.hpp"
+#include "utils/GeoUtils.hpp"
+
+#include <algorithm>
+
+
+namespace dma {
+    namespace geo {
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------
+        TileRequestManager::TileRequestManager(const FetchFunction& fetch, const CancelFunction& cancel) :
+                mFetch(fetch),
+                mCancel(cancel),
+                mStats({0, 0, 0})
+        {}
+
+
+        //------------------------------------------------------------------------
+        TileRequestManager::~TileRequestManager() {}
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::request(int x, int y, int z, bool prefetch) {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            if (mInFlight.find(key) != mInFlight.end()) {
+                ++mStats.deduped;
+                return;
+            }
+            auto it = mQueued.find(key);
+            if (it != mQueued.end()) {
+                it->second.prefetch = it->second.prefetch && prefetch;
+                ++mStats.deduped;
+                return;
+            }
+            mQueued[key] = {x, y, z, prefetch};
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::flush(double x, double y, int zoom) {
+            if (mQueued.empty()) {
+                return;
+            }
+            mOrder.clear();
+            for (auto& kv : mQueued) {
+                const Request& request = kv.second;
+                // the tile's center, in tiles at zoom
+                double scale = request.z <= zoom ? double(1 << (zoom - request.z)) : 1.0 / double(1 << (request.z - zoom));
+                double dx = (request.x + 0.5) * scale - x;
+                double dy = (request.y + 0.5) * scale - y;
+                mOrder.push_back(std::make_pair(dx * dx + dy * dy, request));
+            }
+            mQueued.clear();
+            std::sort(mOrder.begin(), mOrder.end(), [](const std::pair<double, Request>& a,
+                                                      const std::pair<double, Request>& b) {
+                return a.second.prefetch != b.second.prefetch ? b.second.prefetch : a.first < b.first;
+            });
+
+            for (auto& entry : mOrder) {
+                const Request& request = entry.second;
+                mInFlight[GeoUtils::tileKey(request.x, request.y, request.z)] = request;
+                ++mStats.issued;
+                mFetch(request.x, request.y, request.z, request.prefetch);
+            }
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::complete(int x, int y, int z) {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            mInFlight.erase(key);
+            mQueued.erase(key);
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::cancel(int x, int y, int z) {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            mQueued.erase(key);
+            if (mInFlight.erase(key) > 0) {
+                ++mStats.cancelled;
+                mCancel(x, y, z);
+            }
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::cancelAll() {
+            mQueued.clear();
+            for (auto& kv : mInFlight) {
+                ++mStats.cancelled;
+                mCancel(kv.second.x, kv.second.y, kv.second.z);
+            }
+            mInFlight.clear();
+        }
+
+
+        //------------------------------------------------------------------------
+        void TileRequestManager::clear() {
+            mQueued.clear();
+            mInFlight.clear();
+        }
+
+
+        //------------------------------------------------------------------------
+        bool TileRequestManager::isPending(int x, int y, int z) const {
+            U64 key = GeoUtils::tileKey(x, y, z);
+            return mQueued.find(key) != mQueued.end() || mInFlight.find(key) != mInFlight.end();
+        }
+    }
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rendering/BindingCache.hpp"
+
+#include "utils/Log.hpp"
+#include "utils/GLExtensions.hpp"
+
+
+constexpr auto TAG = "BindingCache";
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    static void setAttrib(BindingRecord::Attrib* attribs, ShaderProgram::AttribSem sem,
+                          const ShaderProgram& program, const Mesh& mesh, VertexElement::Semantic semantic) {
+        assert(mesh.hasVertexElement(semantic));
+        const VertexElement& element = mesh.getVertexElement(semantic);
+        BindingRecord::Attrib& attrib = attribs[sem];
+        attrib.location = (GLuint) program.getAttributeLocation(sem);
+        attrib.count = element.getCount();
+        attrib.type = element.getType();
+        attrib.normalized = (GLboolean) (element.isNormalized() ? GL_TRUE : GL_FALSE);
+        attrib.stride = mesh.getVertexSize();
+        attrib.offset = (GLvoid*) (U64) element.getOffset();
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    BindingCache::BindingCache() {}
+
+
+    //------------------------------------------------------------------------
+    BindingCache::~BindingCache() {}
+
+
+    //------------------------------------------------------------------------
+    BindingRecord& BindingCache::get(const Mesh& mesh, const Pass& pass) {
+        return get(mesh, pass, *pass.getShaderProgram());
+    }
+
+
+    //------------------------------------------------------------------------
+    BindingRecord& BindingCache::get(const Mesh& mesh, const Pass& pass, const ShaderProgram& program) {
+        U64 key = mComputeKey(mesh, pass, program);
+        auto it = mRecords.find(key);
+        if (it != mRecords.end()) {
+            return it->second;
+        }
+        BindingRecord& record = mRecords[key];
+        mBuild(mesh, pass, program, record);
+        mMeshKeys[mesh.getId()].push_back(key);
+        return record;
+    }
+
+
+    //------------------------------------------------------------------------
+    void BindingCache::clear(bool releaseVertexArrays) {
+        Log::trace(TAG, "Clearing %u binding records", (U32) mRecords.size());
+        if (releaseVertexArrays && GLExtensions::hasVertexArrayObject()) {
+            for (auto& entry : mRecords) {
+                if (entry.second.vertexArray != 0) {
+                    GLExtensions::deleteVertexArrays(1, &entry.second.vertexArray);
+                }
+            }
+        }
+        mRecords.clear();
+        mMeshKeys.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void BindingCache::forget(U32 meshId, bool releaseVertexArrays) {
+        auto keys = mMeshKeys.find(meshId);
+        if (keys == mMeshKeys.end()) {
+            return;
+        }
+        for (U64 key : keys->second) {
+            auto it = mRecords.find(key);
+            if (it == mRecords.end()) {
+                continue;
+            }
+            if (releaseVertexArrays && it->second.vertexArray != 0) {
+                GLExtensions::deleteVertexArrays(1, &it->second.vertexArray);
+            }
+            mRecords.erase(it);
+        }
+        mMeshKeys.erase(keys);
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    U64 BindingCache::mComputeKey(const Mesh& mesh, const Pass& pass, const ShaderProgram& program) {
+        U64 funcs = 0;
+        for (Pass::Func func : {Pass::LIGHTING_FLAT, Pass::LIGHTING_SMOOTH, Pass::DIFFUSE_MAP,
+                                Pass::DIFFUSE_MAP_ACTIVATION, Pass::SCALING, Pass::DIFFUSE_COLOR}) {
+            if (pass.hasFunc(func)) {
+                funcs |= 1ULL << func;
+            }
+        }
+        return ((U64) mesh.getId() << 32) | ((U64) (program.getId() & 0xFFFFFF) << 8) | funcs;
+    }
+
+
+    //------------------------------------------------------------------------
+    void BindingCache::mBuild(const Mesh& mesh, const Pass& pass, const ShaderProgram& program, BindingRecord& record) {
+        BindingRecord::Attrib attribs[ShaderProgram::AttribSem::AS_size];
+        bool used[ShaderProgram::AttribSem::AS_size] = {false};
+
+        record.vertexArray = 0;
+        for (U32 i = 0; i < ShaderProgram::UniformSem::US_size; ++i) {
+            record.uniforms[i] = -1;
+        }
+        auto useUniform = [&](ShaderProgram::UniformSem sem) {
+            record.uniforms[sem] = program.getUniformLocation(sem);
+        };
+
+        // Transform
+        useUniform(ShaderProgram::UniformSem::MVP);
+        setAttrib(attribs, ShaderProgram::AttribSem::POS, program, mesh, VertexElement::Semantic::POSITION);
+        used[ShaderProgram::AttribSem::POS] = program.hasAttribute(ShaderProgram::AttribSem::POS);
+
+        // Lighting
+        if (pass.hasFunc(Pass::Func::LIGHTING_FLAT) || pass.hasFunc(Pass::Func::LIGHTING_SMOOTH)) {
+            useUniform(ShaderProgram::UniformSem::MV);
+            useUniform(ShaderProgram::UniformSem::N);
+            setAttrib(attribs, ShaderProgram::AttribSem::NORMAL, program, mesh,
+                      pass.hasFunc(Pass::Func::LIGHTING_FLAT) ? VertexElement::Semantic::FLAT_NORMAL
+                                                              : VertexElement::Semantic::SMOOTH_NORMAL);
+            used[ShaderProgram::AttribSem::NORMAL] = program.hasAttribute(ShaderProgram::AttribSem::NORMAL);
+        }
+
+        // Diffuse map
+        record.diffuseMap = pass.hasFunc(Pass::Func::DIFFUSE_MAP);
+        if (record.diffuseMap) {
+            useUniform(ShaderProgram::UniformSem::DM);
+            setAttrib(attribs, ShaderProgram::AttribSem::UV, program, mesh, VertexElement::Semantic::UV);
+            used[ShaderProgram::AttribSem::UV] = program.hasAttribute(ShaderProgram::AttribSem::UV);
+            if (pass.hasFunc(Pass::Func::DIFFUSE_MAP_ACTIVATION)) {
+                useUniform(ShaderProgram::UniformSem::MV);
+                useUniform(ShaderProgram::UniformSem::DM_ACTIVATION);
+            }
+        }
+
+        // Scaling, overrides the lighting normals
+        if (pass.hasFunc(Pass::Func::SCALING)) {
+            useUniform(ShaderProgram::UniformSem::N);
+            useUniform(ShaderProgram::UniformSem::DECODE_SCALE);
+            setAttrib(attribs, ShaderProgram::AttribSem::NORMAL, program, mesh, VertexElement::Semantic::SMOOTH_NORMAL);
+            used[ShaderProgram::AttribSem::NORMAL] = program.hasAttribute(ShaderProgram::AttribSem::NORMAL);
+        }
+
+        // Diffuse color
+        if (pass.hasFunc(Pass::Func::DIFFUSE_COLOR)) {
+            useUniform(ShaderProgram::UniformSem::DIFFUSE_COLOR);
+        }
+
+        // Lights
+        if (program.hasUniform(ShaderProgram::UniformSem::LIGHT0_POSITION)) {
+            useUniform(ShaderProgram::UniformSem::LIGHT0_POSITION);
+            useUniform(ShaderProgram::UniformSem::LIGHT0_AMBIENT);
+            useUniform(ShaderProgram::UniformSem::LIGHT0_DIFFUSE);
+            useUniform(ShaderProgram::UniformSem::LIGHT0_SPECULAR);
+        }
+
+        // Pack the attributes
+        record.attribCount = 0;
+        record.attribMask = 0;
+        for (U32 i = 0; i < ShaderProgram::AttribSem::AS_size; ++i) {
+            if (used[i]) {
+                record.attribs[record.attribCount++] = attribs[i];
+                record.attribMask |= 1u << attribs[i].location;
+            }
+        }
+    }
+}
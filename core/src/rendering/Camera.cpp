@@ -30,6 +30,8 @@ namespace dma {
 
     //--------------------------------------------------------------------------
     Camera::Camera() :
+            // the view is computed by update(), which clears the dirty flag itself
+            mTransformComponent(true),
             mAnimationComponent(mTransformComponent),
             mCurrentTranslationAnimation(nullptr),
             mCurrentSlerpAnimation(nullptr)
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rendering/FramePacket.hpp"
+
+
+namespace dma {
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    FramePacket::FramePacket() :
+            mV(1.0f),
+            mP(1.0f),
+            mReady(false)
+    {}
+
+
+    //------------------------------------------------------------------------
+    FramePacket::~FramePacket() {}
+
+
+    //------------------------------------------------------------------------
+    void FramePacket::build(const RenderQueue& queue, const glm::mat4& V, const glm::mat4& P,
+                            const std::vector<RenderQueue::Item>& hud, const glm::mat4& hudV, const glm::mat4& hudP) {
+        const std::vector<RenderQueue::Item>& opaque = queue.getOpaqueItems();
+        const std::vector<RenderQueue::Item>& backToFront = queue.getBackToFrontItems();
+
+        // reserved up front, the items pointing into it
+        mMatrices.clear();
+        mMatrices.reserve(opaque.size() + backToFront.size() + hud.size());
+        mCopy(opaque, mOpaque);
+        mCopy(backToFront, mBackToFront);
+        mCopy(hud, mHUD);
+        mV = V;
+        mP = P;
+        mHUDV = hudV;
+        mHUDP = hudP;
+        mReady = true;
+    }
+
+
+    //------------------------------------------------------------------------
+    void FramePacket::clear() {
+        mOpaque.clear();
+        mBackToFront.clear();
+        mHUD.clear();
+        mMatrices.clear();
+        mReady = false;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void FramePacket::mCopy(const std::vector<RenderQueue::Item>& src, std::vector<RenderQueue::Item>& dst) {
+        dst.resize(src.size());
+        for (size_t i = 0; i < src.size(); ++i) {
+            dst[i] = src[i];
+            // passes of a package are often next to each other, sharing a matrix
+            if (i > 0 && src[i].M == src[i - 1].M) {
+                dst[i].M = dst[i - 1].M;
+            } else {
+                mMatrices.push_back(*src[i].M);
+                dst[i].M = &mMatrices.back();
+            }
+        }
+    }
+}
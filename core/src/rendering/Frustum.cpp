@@ -20,6 +20,14 @@
 #include "rendering/Frustum.hpp"
 #include "utils/Log.hpp"
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRUSTUM_NEON
+#endif
+
 #define TAG "Frustum"
 
 namespace dma {
@@ -106,6 +114,13 @@ namespace dma {
         mPlanes[RIGHT].setNormal(normal);
         mPlanes[RIGHT].setPoint(m);
 
+        for (int i = 0; i < 6; i++) {
+            const glm::vec3& n = mPlanes[i].getNormal();
+            mPlaneX[i] = n.x;
+            mPlaneY[i] = n.y;
+            mPlaneZ[i] = n.z;
+            mPlaneD[i] = -glm::dot(n, mPlanes[i].getPoint());
+        }
     }
 
 
@@ -122,4 +137,93 @@ namespace dma {
         }
         return true;
     }
+
+
+    //-----------------------------------------------------------------------------
+    Frustum::Intersection Frustum::intersectSphere(const glm::vec3& center, float radius) const {
+        Intersection result = INSIDE;
+        for (int i = 0; i < 6; i++) {
+            float distance = mPlanes[i].distance(center);
+            if (distance > radius) {
+                return OUTSIDE;
+            }
+            if (distance > -radius) {
+                result = INTERSECTS;
+            }
+        }
+        return result;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void Frustum::containsSpheres(const F32* cx, const F32* cy, const F32* cz, const F32* r,
+                                  U32 count, U8* out) const {
+        U32 i = 0;
+#if defined(FRUSTUM_SSE)
+        __m128 px[6], py[6], pz[6], pd[6];
+        for (int p = 0; p < 6; p++) {
+            px[p] = _mm_set1_ps(mPlaneX[p]);
+            py[p] = _mm_set1_ps(mPlaneY[p]);
+            pz[p] = _mm_set1_ps(mPlaneZ[p]);
+            pd[p] = _mm_set1_ps(mPlaneD[p]);
+        }
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(cx + i);
+            __m128 y = _mm_loadu_ps(cy + i);
+            __m128 z = _mm_loadu_ps(cz + i);
+            __m128 radius = _mm_loadu_ps(r + i);
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y)),
+                                             _mm_add_ps(_mm_mul_ps(pz[p], z), pd[p]));
+                outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, radius));
+            }
+            int mask = _mm_movemask_ps(outside);
+            out[i]     = (U8) !(mask & 1);
+            out[i + 1] = (U8) !(mask & 2);
+            out[i + 2] = (U8) !(mask & 4);
+            out[i + 3] = (U8) !(mask & 8);
+        }
+#elif defined(FRUSTUM_NEON)
+        float32x4_t px[6], py[6], pz[6], pd[6];
+        for (int p = 0; p < 6; p++) {
+            px[p] = vdupq_n_f32(mPlaneX[p]);
+            py[p] = vdupq_n_f32(mPlaneY[p]);
+            pz[p] = vdupq_n_f32(mPlaneZ[p]);
+            pd[p] = vdupq_n_f32(mPlaneD[p]);
+        }
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t x = vld1q_f32(cx + i);
+            float32x4_t y = vld1q_f32(cy + i);
+            float32x4_t z = vld1q_f32(cz + i);
+            float32x4_t radius = vld1q_f32(r + i);
+            uint32x4_t outside = vdupq_n_u32(0);
+            for (int p = 0; p < 6; p++) {
+                // same operation order as the scalar version, no fused multiply-add
+                float32x4_t distance = vaddq_f32(vaddq_f32(vmulq_f32(px[p], x), vmulq_f32(py[p], y)),
+                                                 vaddq_f32(vmulq_f32(pz[p], z), pd[p]));
+                outside = vorrq_u32(outside, vcgtq_f32(distance, radius));
+            }
+            out[i]     = (U8) (vgetq_lane_u32(outside, 0) == 0);
+            out[i + 1] = (U8) (vgetq_lane_u32(outside, 1) == 0);
+            out[i + 2] = (U8) (vgetq_lane_u32(outside, 2) == 0);
+            out[i + 3] = (U8) (vgetq_lane_u32(outside, 3) == 0);
+        }
+#endif
+        containsSpheresScalar(cx + i, cy + i, cz + i, r + i, count - i, out + i);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void Frustum::containsSpheresScalar(const F32* cx, const F32* cy, const F32* cz, const F32* r,
+                                        U32 count, U8* out) const {
+        for (U32 i = 0; i < count; i++) {
+            bool outside = false;
+            for (int p = 0; p < 6; p++) {
+                F32 distance = (mPlaneX[p] * cx[i] + mPlaneY[p] * cy[i]) + (mPlaneZ[p] * cz[i] + mPlaneD[p]);
+                outside |= distance > r[i];
+            }
+            out[i] = (U8) !outside;
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rendering/GLStateCache.hpp"
+
+#include "utils/GLES2Logger.hpp"
+#include "utils/GLExtensions.hpp"
+
+#include <algorithm>
+
+
+constexpr auto TAG = "GLStateCache";
+
+namespace dma {
+
+    constexpr U32 GLStateCache::MAX_TEXTURE_UNITS;
+    constexpr U32 GLStateCache::MAX_VERTEX_ATTRIBS;
+    constexpr GLuint GLStateCache::UNKNOWN;
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    GLStateCache::GLStateCache() :
+            mMaxAttribs(0),
+            mStats{0, 0},
+            mLastFrameStats{0, 0}
+    {
+        mForgetBindings();
+        mForgetRenderStates();
+        mAttribMask = 0;
+        mVertexArray = 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    GLStateCache::~GLStateCache() {}
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::reset() {
+        mForgetBindings();
+        mForgetRenderStates();
+
+        if (GLExtensions::hasVertexArrayObject()) {
+            GLExtensions::bindVertexArray(0);
+        }
+        mVertexArray = 0;
+
+        GLint maxAttribs = 0;
+        glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs);
+        mMaxAttribs = std::min((U32) std::max(maxAttribs, 0), MAX_VERTEX_ATTRIBS);
+        for (U32 i = 0; i < mMaxAttribs; ++i) {
+            glDisableVertexAttribArray(i);
+        }
+        mAttribMask = 0;
+        Log::trace(TAG, "GL state cache reset (%u vertex attribs)", mMaxAttribs);
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::beginFrame() {
+        mLastFrameStats = mStats;
+        mStats.issued = 0;
+        mStats.filtered = 0;
+        mForgetBindings();
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::useProgram(GLuint program) {
+        if (!mFilter(mProgram == program)) {
+            glUseProgram(program);
+            mProgram = program;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+        GLuint& bound = target == GL_ELEMENT_ARRAY_BUFFER ? mElementArrayBuffer : mArrayBuffer;
+        if (!mFilter(bound == buffer)) {
+            glBindBuffer(target, buffer);
+            bound = buffer;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::activeTexture(U32 unit) {
+        assert(unit < MAX_TEXTURE_UNITS);
+        if (!mFilter(mActiveUnit == unit)) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            mActiveUnit = unit;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+        if (mActiveUnit == UNKNOWN) {
+            activeTexture(0);
+        }
+        GLuint& bound = target == GL_TEXTURE_CUBE_MAP ? mTexturesCube[mActiveUnit] : mTextures2D[mActiveUnit];
+        if (!mFilter(bound == texture)) {
+            glBindTexture(target, texture);
+            bound = texture;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::setCapability(GLenum capability, bool enabled) {
+        I32* state;
+        switch (capability) {
+            case GL_CULL_FACE:
+                state = &mCapabilities[CULL_FACE];
+                break;
+            case GL_DEPTH_TEST:
+                state = &mCapabilities[DEPTH_TEST];
+                break;
+            case GL_BLEND:
+                state = &mCapabilities[BLEND];
+                break;
+            default:
+                Log::error(TAG, "Unsupported capability 0x%x", capability);
+                assert(false);
+                return;
+        }
+        if (!mFilter(*state == (I32) enabled)) {
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+            *state = enabled;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::cullFace(GLenum mode) {
+        if (!mFilter(mCullFace == mode)) {
+            glCullFace(mode);
+            mCullFace = mode;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::depthMask(bool enabled) {
+        if (!mFilter(mDepthMask == (I32) enabled)) {
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+            mDepthMask = enabled;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::depthFunc(GLenum func) {
+        if (!mFilter(mDepthFunc == func)) {
+            glDepthFunc(func);
+            mDepthFunc = func;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::blendFunc(GLenum sfactor, GLenum dfactor) {
+        if (!mFilter(mBlendSrc == sfactor && mBlendDst == dfactor)) {
+            glBlendFunc(sfactor, dfactor);
+            mBlendSrc = sfactor;
+            mBlendDst = dfactor;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::setEnabledAttribs(U32 mask) {
+        assert(mVertexArray == 0);
+        U32 changed = mask ^ mAttribMask;
+        for (U32 i = 0; i < MAX_VERTEX_ATTRIBS; ++i) {
+            U32 bit = 1u << i;
+            if (!(changed & bit)) {
+                if (mask & bit) {
+                    ++mStats.filtered;
+                }
+                continue;
+            }
+            ++mStats.issued;
+            if (mask & bit) {
+                glEnableVertexAttribArray(i);
+            } else {
+                glDisableVertexAttribArray(i);
+            }
+        }
+        mAttribMask = mask;
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::bindVertexArray(GLuint vertexArray) {
+        if (!mFilter(mVertexArray == vertexArray)) {
+            GLExtensions::bindVertexArray(vertexArray);
+            mVertexArray = vertexArray;
+            // the element array buffer binding is part of the vertex array state
+            mElementArrayBuffer = UNKNOWN;
+        }
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void GLStateCache::mForgetBindings() {
+        mProgram = UNKNOWN;
+        mArrayBuffer = UNKNOWN;
+        mElementArrayBuffer = UNKNOWN;
+        mActiveUnit = UNKNOWN;
+        std::fill(mTextures2D, mTextures2D + MAX_TEXTURE_UNITS, UNKNOWN);
+        std::fill(mTexturesCube, mTexturesCube + MAX_TEXTURE_UNITS, UNKNOWN);
+    }
+
+
+    //------------------------------------------------------------------------
+    void GLStateCache::mForgetRenderStates() {
+        std::fill(mCapabilities, mCapabilities + CAPABILITY_COUNT, -1);
+        mCullFace = UNKNOWN;
+        mDepthMask = -1;
+        mDepthFunc = UNKNOWN;
+        mBlendSrc = UNKNOWN;
+        mBlendDst = UNKNOWN;
+    }
+}
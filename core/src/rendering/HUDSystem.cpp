@@ -54,7 +54,7 @@ namespace dma {
         std::shared_ptr<Entity> entity = std::make_shared<Entity>(quad, mat);
         entity->setPosition(glm::vec3(hudElement->x + hudElement->width / 2.0f, hudElement->y - hudElement->height / 2.0f, 0.0f));
         entity->setScale(quad->getScale());
-        entity->update(0.0f);
+        entity->getTransformComponent().update();
         hudElement->mEntity = entity;
         mHUDElements.push_back(hudElement);
     }
@@ -32,20 +32,22 @@ namespace dma {
     IndexBuffer::IndexBuffer() :
             mHandle(0),
             mSizeInByte(0),
-            mElementCount(0)
+            mElementCount(0),
+            mType(GL_UNSIGNED_SHORT)
     {}
 
-    IndexBuffer::IndexBuffer(U32 elementCount) : IndexBuffer() {
-        generateBuffer(elementCount);
+    IndexBuffer::IndexBuffer(U32 elementCount, GLenum type) : IndexBuffer() {
+        generateBuffer(elementCount, type);
     }
 
     IndexBuffer::~IndexBuffer() {
     }
 
 
-    void IndexBuffer::generateBuffer(U32 elementCount) {
-        mSizeInByte = elementCount * sizeof(GLushort);
+    void IndexBuffer::generateBuffer(U32 elementCount, GLenum type) {
+        mSizeInByte = (U64) elementCount * getTypeSize(type);
         mElementCount = elementCount;
+        mType = type;
         glGenBuffers(1, &mHandle);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mHandle);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInByte, NULL, GL_STATIC_DRAW);
@@ -66,11 +68,13 @@ namespace dma {
             glDeleteBuffers(1, &mHandle);
         }
         mHandle = 0;
+        mRanges.clear();
     }
 
     const std::string IndexBuffer::toString() const {
         std::ostringstream oss;
-        oss << "mHandle=" << mHandle << " mSizeInByte=" << mSizeInByte << " mElementCount=" << mElementCount;
+        oss << "mHandle=" << mHandle << " mSizeInByte=" << mSizeInByte << " mElementCount=" << mElementCount
+            << " mType=" << mType << " mRanges=" << mRanges.size();
         return oss.str();
     }
 
@@ -38,7 +38,7 @@ namespace dma {
 
 
     //----------------------------------------------------------------
-    float Plane::distance(const glm::vec3& p) {
+    float Plane::distance(const glm::vec3& p) const {
         //float D = glm::dot<float>(-mNormal, mPoint);
 
         //float d = glm::dot<float>(p - mPoint, mNormal);
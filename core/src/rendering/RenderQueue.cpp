@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstring>  // memcpy
+
+#include "rendering/RenderQueue.hpp"
+
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    /**
+     * Returns the bits of a positive float, which compare like the float itself.
+     */
+    static inline U32 floatBits(F32 value) {
+        if (!(value > 0.0f)) { // also catches NaN
+            return 0;
+        }
+        U32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    //------------------------------------------------------------------------
+    static inline U64 field(U64 value, U32 bitCount, U32 shift) {
+        return (value & ((1ULL << bitCount) - 1)) << shift;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    RenderQueue::RenderQueue() :
+            mSortMode(SortMode::STATE),
+            mBatching(false)
+    {}
+
+
+    //------------------------------------------------------------------------
+    RenderQueue::~RenderQueue() {}
+
+
+    //------------------------------------------------------------------------
+    void RenderQueue::push(RenderingPackage* package, bool backToFront, F32 distanceFromCamera) {
+        assert(package != nullptr);
+        U32 depth = floatBits(distanceFromCamera);
+        U8 passCount = package->mMaterial->getPassCount();
+
+        for (U8 i = 0; i < passCount; ++i) {
+            Item item;
+            item.package = package;
+            item.M = &package->M;
+            item.pass = i;
+            if (backToFront && mBatching) {
+                // pass after pass, farthest first, the program & texture only breaking
+                // ties: packages sharing a state are batched only when adjacent in depth
+                item.key = field(i, 4, 60) | field(~depth, 32, 24) | field(mComputeState(package, i) >> 12, 24, 0);
+                mBackToFront.push_back(item);
+            } else if (backToFront) {
+                // farthest first, passes of a same package in order
+                item.key = field(~depth, 32, 32) | field(i, 4, 0);
+                mBackToFront.push_back(item);
+            } else {
+                item.key = mComputeStateKey(package, i, depth);
+                mOpaque.push_back(item);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderQueue::sort() {
+        mRadixSort(mOpaque, mScratch);
+        mRadixSort(mBackToFront, mScratch);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderQueue::append(RenderQueue& other) {
+        assert(other.mSortMode == mSortMode && other.mBatching == mBatching);
+        mOpaque.insert(mOpaque.end(), other.mOpaque.begin(), other.mOpaque.end());
+        mBackToFront.insert(mBackToFront.end(), other.mBackToFront.begin(), other.mBackToFront.end());
+        other.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderQueue::clear() {
+        mOpaque.clear();
+        mBackToFront.clear();
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    U64 RenderQueue::mComputeStateKey(RenderingPackage* package, U8 pass, U32 depth) const {
+        // keep the 24 most significant bits of the distance (sign excluded)
+        U64 depthBucket = depth >> 7;
+        U64 state = mComputeState(package, pass);
+
+        switch (mSortMode) {
+            case SortMode::DISTANCE:
+                return field(pass, 4, 60) | field(depthBucket, 24, 36) | field(state, 36, 0);
+            case SortMode::STATE:
+            default:
+                return field(pass, 4, 60) | field(state, 36, 24) | field(depthBucket, 24, 0);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    U64 RenderQueue::mComputeState(RenderingPackage* package, U8 pass) {
+        Pass& p = package->mMaterial->getPass(pass);
+        U64 program = p.getShaderProgram()->getHandle();
+        U64 texture = p.hasFunc(Pass::Func::DIFFUSE_MAP) ? p.getDiffuseMap()->getHandle() : 0;
+        U64 vertexBuffer = package->mMesh->getVertexBuffer().getHandle();
+
+        // GL names are small integers in practice; truncating them only
+        // makes the sort less effective, never incorrect.
+        return field(program, 10, 26) | field(texture, 14, 12) | field(vertexBuffer, 12, 0);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderQueue::mRadixSort(std::vector<Item>& items, std::vector<Item>& scratch) {
+        const size_t count = items.size();
+        if (count < 2) {
+            return;
+        }
+        scratch.resize(count);
+
+        Item* src = items.data();
+        Item* dst = scratch.data();
+
+        // LSD radix sort on 8-bit digits, stable
+        for (U32 shift = 0; shift < 64; shift += 8) {
+            size_t offsets[256] = {0};
+            for (size_t i = 0; i < count; ++i) {
+                ++offsets[(src[i].key >> shift) & 0xFF];
+            }
+            // skip the digits shared by all the keys
+            if (offsets[(src[0].key >> shift) & 0xFF] == count) {
+                continue;
+            }
+            size_t sum = 0;
+            for (U32 d = 0; d < 256; ++d) {
+                size_t c = offsets[d];
+                offsets[d] = sum;
+                sum += c;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != items.data()) {
+            std::memcpy(items.data(), src, count * sizeof(Item));
+        }
+    }
+}
@@ -17,6 +17,7 @@
 
 
 #include <cstring>  // strlen
+#include <algorithm>
 
 #include "rendering/RenderingEngine.hpp"
 
@@ -24,6 +25,7 @@
 #include "utils/ExceptionHandler.hpp"
 #include "utils/GLES2Logger.hpp"
 #include "utils/GLUtils.hpp"
+#include "utils/GLExtensions.hpp"
 #include "utils/Utils.hpp"
 
 #include "glm/gtc/type_ptr.hpp"
@@ -39,20 +41,32 @@ namespace dma {
 
     /* ================= ROUTINES ========================*/
 
-    //------------------------------------------------------------------------
-
-
+    // below that, instancing does not pay for its setup
+    static constexpr U32 MIN_INSTANCES = 2;
 
     /* ================= PUBLIC ========================*/
 
     //------------------------------------------------------------------------
     RenderingEngine::RenderingEngine(ResourceManager& resourceManager) :
+            mResourceManager(resourceManager),
             mHUDSystem(resourceManager),
             mSkyBox(nullptr),
             mV(NULL),
             mP(NULL),
-            mAspectRatio(0.0f)
-    {}
+            mAspectRatio(0.0f),
+            mUseVertexArrays(false),
+            mSkyBoxVertexArray(0),
+            mSkyBoxVertexArrayOwner(nullptr),
+            mSkyBoxVertexArrayBuffer(0),
+            mInstancingEnabled(false),
+            mInstancingMode(InstancingMode::NONE),
+            mInstanceBuffer(0)
+    {
+        // bindings of unused meshes would otherwise pile up as POIs stream in
+        mResourceManager.setMeshDropListener([this](const Mesh& mesh) {
+            mForgetMesh(mesh.getId());
+        });
+    }
 
 
     //------------------------------------------------------------------------
@@ -73,9 +87,17 @@ namespace dma {
         }
         assert(hasOglContext);
 
-        glEnable(GL_CULL_FACE);
+        GLExtensions::load();
+        mUseVertexArrays = GLExtensions::hasVertexArrayObject();
+        Log::trace(TAG, "Drawing %s vertex array objects", mUseVertexArrays ? "with" : "without");
+        mInstancingMode = GLExtensions::hasInstancedArrays() ? InstancingMode::INSTANCED_ARRAYS
+                                                             : InstancingMode::UNIFORM_ARRAYS;
+
+        mStateCache.reset();
+        mStateCache.setCapability(GL_CULL_FACE, true);
         glFrontFace(GL_CCW);
-        glEnable(GL_DEPTH_TEST);
+        mStateCache.setCapability(GL_DEPTH_TEST, true);
+        mStateCache.depthFunc(GL_LESS);
         glClearColor(CLEAR_COLOR);
 
         return STATUS_OK;
@@ -90,15 +112,15 @@ namespace dma {
         mHUDSystem.unload();
 
         // force program to not be used anymore, to ensure proper deletion.
-        if (GLUtils::hasGlContext()) {
-            glUseProgram(0);
-        }
-        while (!mFrontToBack.empty()) {
-            mFrontToBack.pop();
+        bool hasGlContext = GLUtils::hasGlContext();
+        if (hasGlContext) {
+            mStateCache.useProgram(0);
         }
-        while (!mBackToFront.empty()) {
-            mBackToFront.pop();
+        mRenderQueue.clear();
+        for (auto& shard : mShards) {
+            shard->clear();
         }
+        invalidateBindings(hasGlContext);
         Log::trace(TAG, "RenderingEngine unloaded");
     }
 
@@ -116,20 +138,57 @@ namespace dma {
 
 
     //------------------------------------------------------------------------
-    void RenderingEngine::subscribe(RenderingPackage* package, bool back2front, float distanceFromCamera) {
-        Entry e;
-        e.renderingPackage = package;
-        if (back2front) {
-            e.distance = distanceFromCamera; //the farthest first
-            mBackToFront.push(e);
+    void RenderingEngine::invalidateBindings(bool releaseGlObjects) {
+        if (releaseGlObjects && mUseVertexArrays) {
+            mStateCache.bindVertexArray(0);
+        }
+        mBindingCache.clear(releaseGlObjects && mUseVertexArrays);
+        mReleaseSkyBoxVertexArray(releaseGlObjects);
+        mReleaseInstancing(releaseGlObjects);
+    }
 
-        } else {
-            e.distance = -distanceFromCamera; //the closest first
-            mFrontToBack.push(e);
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::setSortMode(RenderQueue::SortMode sortMode) {
+        mRenderQueue.setSortMode(sortMode);
+        for (auto& shard : mShards) {
+            shard->setSortMode(sortMode);
         }
     }
 
 
+    //------------------------------------------------------------------------
+    void RenderingEngine::setInstancingEnabled(bool enabled) {
+        mInstancingEnabled = enabled;
+        mRenderQueue.setBatching(enabled);
+        for (auto& shard : mShards) {
+            shard->setBatching(enabled);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::setShardCount(U32 count) {
+        for (auto& shard : mShards) {
+            mRenderQueue.append(*shard);
+        }
+        mShards.resize(count);
+        for (auto& shard : mShards) {
+            if (shard == nullptr) {
+                shard.reset(new RenderQueue());
+                shard->setSortMode(mRenderQueue.getSortMode());
+                shard->setBatching(mRenderQueue.isBatching());
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::subscribe(RenderingPackage* package, bool back2front, float distanceFromCamera) {
+        mRenderQueue.push(package, back2front, distanceFromCamera);
+    }
+
+
     //------------------------------------------------------------------------
     void RenderingEngine::subscribe(const RenderingComponent* component, float distanceFromCamera) {
         for(RenderingPackage* rp : component->getRenderingPackages()) {
@@ -138,6 +197,16 @@ namespace dma {
     }
 
 
+    //------------------------------------------------------------------------
+    void RenderingEngine::subscribe(U32 shard, const RenderingComponent* component, float distanceFromCamera) {
+        assert(shard < mShards.size());
+        RenderQueue& queue = *mShards[shard];
+        for(RenderingPackage* rp : component->getRenderingPackages()) {
+            queue.push(rp, rp->isBackToFront(), distanceFromCamera);
+        }
+    }
+
+
     //------------------------------------------------------------------------
     void RenderingEngine::subscribeHUDElement(std::shared_ptr<HUDElement> hudElement) {
         mHUDSystem.addHUDElement(hudElement);
@@ -148,51 +217,132 @@ namespace dma {
     void RenderingEngine::drawFrame() {
         assert (mV != NULL && "mV not set before rendering starts!");
         assert (mP != NULL && "mP not set before rendering starts!");
-        glDepthMask(GL_TRUE);
+        mMergeShards();
+        mRenderQueue.sort();
+        mCollectHUDItems();
+        mDrawFrame(mRenderQueue.getOpaqueItems(), mRenderQueue.getBackToFrontItems(), *mV, *mP,
+                   mHUDItems, mHUDSystem.mV, mHUDSystem.mP);
+        mRenderQueue.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::buildFramePacket(FramePacket& packet) {
+        assert (mV != NULL && "mV not set before rendering starts!");
+        assert (mP != NULL && "mP not set before rendering starts!");
+        mMergeShards();
+        mRenderQueue.sort();
+        // the HUD elements may also change while the packet is drawn
+        mCollectHUDItems();
+        packet.build(mRenderQueue, *mV, *mP, mHUDItems, mHUDSystem.mV, mHUDSystem.mP);
+        mRenderQueue.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::drawFramePacket(const FramePacket& packet) {
+        if (!packet.isReady()) {
+            // first frame of a pipeline
+            mStateCache.depthMask(true);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            return;
+        }
+        mDrawFrame(packet.getOpaqueItems(), packet.getBackToFrontItems(), packet.getV(), packet.getP(),
+                   packet.getHUDItems(), packet.getHUDV(), packet.getHUDP());
+    }
+
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mMergeShards() {
+        for (auto& shard : mShards) {
+            mRenderQueue.append(*shard);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mCollectHUDItems() {
+        mHUDItems.clear();
+        for (auto hudElem : mHUDSystem.getHUDElements()) {
+            for (auto rp : hudElem->mEntity->getRenderingComponent()->getRenderingPackages()) {
+                for (U8 i = 0; i < rp->mMaterial->getPassCount(); ++i) {
+                    RenderQueue::Item item;
+                    item.key = 0;
+                    item.package = rp;
+                    item.M = &rp->M;
+                    item.pass = i;
+                    mHUDItems.push_back(item);
+                }
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawFrame(const std::vector<RenderQueue::Item>& opaque,
+                                     const std::vector<RenderQueue::Item>& backToFront,
+                                     const glm::mat4& V, const glm::mat4& P,
+                                     const std::vector<RenderQueue::Item>& hud,
+                                     const glm::mat4& hudV, const glm::mat4& hudP) {
+        mStateCache.beginFrame();
+        mStateCache.depthMask(true);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         ///////////////////////////////////////////
-        // 1. Draw front to back
-        while (!mFrontToBack.empty()) {
-            mDraw(mFrontToBack.top().renderingPackage, *mV, *mP);
-            mFrontToBack.pop();
-        }
+        // 1. Draw opaque packages, sorted by state
+        mDrawItems(opaque, V, P);
 
         ///////////////////////////////////////////
         // 2. Draw the skybox (early depth testing) if any
         if (mSkyBox) {
-            mDrawSkyBox();
+            mDrawSkyBox(V, P);
         }
 
         ///////////////////////////////////////////
         // 3. Draw back to front
-        while (!mBackToFront.empty()) {
-            mDraw(mBackToFront.top().renderingPackage, *mV, *mP);
-            mBackToFront.pop();
-        }
+        mDrawItems(backToFront, V, P);
 
 
         ///////////////////////////////////////////
         // 4. Draw the HUD
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        for (auto hudElem : mHUDSystem.getHUDElements()) {
-            for (auto rp : hudElem->mEntity->getRenderingComponent()->getRenderingPackages()) {
-                mDraw(rp, mHUDSystem.mV, mHUDSystem.mP);
-                //mDraw(rp, *mV, *mP);
-            }
+        mStateCache.setCapability(GL_DEPTH_TEST, false);
+        mStateCache.setCapability(GL_BLEND, true);
+        mStateCache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        for (const RenderQueue::Item& item : hud) {
+            mDraw(item.package, item.pass, *item.M, hudV, hudP);
+        }
+        mStateCache.setCapability(GL_BLEND, false);
+        mStateCache.setCapability(GL_DEPTH_TEST, true);
+
+        // leave the default vertex array bound for the resource loaders
+        if (mUseVertexArrays) {
+            mStateCache.bindVertexArray(0);
         }
-        glDisable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
     }
 
 
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawItems(const std::vector<RenderQueue::Item>& items, const glm::mat4& V, const glm::mat4& P) {
+        size_t i = 0;
+        while (i < items.size()) {
+            size_t end = mInstancingEnabled ? mFindInstances(items, i) : i + 1;
+            U32 count = (U32) (end - i);
+            if (count < MIN_INSTANCES || !mDrawInstanced(&items[i], count, V, P)) {
+                for (size_t j = i; j < end; ++j) {
+                    mDraw(items[j].package, items[j].pass, *items[j].M, V, P);
+                }
+            }
+            i = end;
+        }
+    }
 
-    /* ================= PRIVATE ========================*/
 
     //------------------------------------------------------------------------
-    void RenderingEngine::mDraw(RenderingPackage* package, const glm::mat4& V, const glm::mat4& P) {
+    void RenderingEngine::mDraw(RenderingPackage* package, U8 passIndex, const glm::mat4& M,
+                                const glm::mat4& V, const glm::mat4& P) {
         GLUtils::clearGlErrors();
 
         assert(package != NULL);
@@ -202,234 +352,497 @@ namespace dma {
 
         //Log::debug(TAG, "%s", glm::to_string(*(package->M)).c_str());
 
-        const glm::mat4 MV = V * package->M;
-        const glm::mat4 MVP = P * MV;
-        const glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(MV)));
+        assert(passIndex < material->getPassCount());
+        Pass& pass = material->getPass(passIndex);
 
+        const ShaderProgram* shaderProgram = pass.getShaderProgram().get();
 
-        for (U8 i = 0; i < material->getPassCount(); ++i) {
+        assert(shaderProgram != NULL && "ShaderProgram is NULL before calling glUseProgram");
+        assert(shaderProgram->getHandle() != 0 && "ShaderProgram handle is 0 before calling glUseProgram");
+        mStateCache.useProgram(shaderProgram->getHandle());
 
-            Pass& pass = material->getPass(i);
+        BindingRecord& binding = mBindingCache.get(*mesh, pass);
+        const GLint* uniforms = binding.uniforms;
 
-            std::shared_ptr<ShaderProgram> shaderProgram = pass.getShaderProgram();
+        mSetupPass(pass);
 
-            assert(shaderProgram != NULL && "ShaderProgram is NULL before calling glUseProgram");
-            assert(shaderProgram->getHandle() != 0 && "ShaderProgram handle is 0 before calling glUseProgram");
-            glUseProgram(shaderProgram->getHandle());
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Setup vertex attributes, those of split meshes being set for each range
+        const bool split = mesh->getIndexBuffer().isSplit();
+        if (mUseVertexArrays && !split) {
+            if (binding.vertexArray == 0) {
+                mCreateVertexArray(binding, *mesh);
+            }
+            mStateCache.bindVertexArray(binding.vertexArray);
+        } else {
+            if (mUseVertexArrays) {
+                mStateCache.bindVertexArray(0);
+            }
+            if (!split) {
+                mSetupAttribs(binding, mesh->getVertexBuffer().getHandle());
+            }
+            mStateCache.setEnabledAttribs(binding.attribMask);
+            mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->getIndexBuffer().getHandle());
+        }
 
-            glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer().getHandle());
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Setup uniforms
+        // positions quantized to the bounding sphere are decoded along with the model
+        const glm::mat4 MV = V * M * mesh->getDecodeMatrix();
+        const glm::mat4 MVP = P * MV;
+        glUniformMatrix4fv(uniforms[ShaderProgram::UniformSem::MVP], 1, GL_FALSE, glm::value_ptr(MVP));
 
-            /////////////////////////////////////////////////////////////////////////
-            // Setup rendering state according to the material functionalities.    //
-            /////////////////////////////////////////////////////////////////////////
+        if (uniforms[ShaderProgram::UniformSem::MV] != -1) {
+            glUniformMatrix4fv(uniforms[ShaderProgram::UniformSem::MV], 1, GL_FALSE, glm::value_ptr(MV));
+        }
 
-            GLint attr;
-            U16 attribCount = 0;
+        if (uniforms[ShaderProgram::UniformSem::N] != -1) {
+            const glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(MV)));
+            glUniformMatrix3fv(uniforms[ShaderProgram::UniformSem::N], 1, GL_FALSE, glm::value_ptr(N));
+        }
 
-            ////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Setup cull mode
-            switch (pass.getCullMode()) {
-                case Pass::NONE:
-                glDisable(GL_CULL_FACE);
-                    break;
-                case Pass::CullMode::FRONT:
-                glEnable(GL_CULL_FACE);
-                    glCullFace(GL_FRONT);
-                    break;
-                case Pass::BACK:
-                glEnable(GL_CULL_FACE);
-                    glCullFace(GL_BACK);
-                    break;
-                default:
-                    Log::error(TAG, "Invalid cull mode");
-                    assert(false);
-            }
+        if (uniforms[ShaderProgram::UniformSem::DECODE_SCALE] != -1) {
+            glUniform1f(uniforms[ShaderProgram::UniformSem::DECODE_SCALE], mesh->getDecodeScale());
+        }
 
-            ////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Setup depth writing
-            if (pass.getDepthWriting()) {
-                glDepthMask(GL_TRUE);
-            } else {
-                glDepthMask(GL_FALSE);
-            }
+        if (uniforms[ShaderProgram::UniformSem::DIFFUSE_COLOR] != -1) {
+            const glm::vec3& diffuseColor = pass.getDiffuseColor();
+            glUniform3f(uniforms[ShaderProgram::UniformSem::DIFFUSE_COLOR],
+                        diffuseColor.r, diffuseColor.g, diffuseColor.b);
+        }
 
-            ////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Setup Transform
-
-            // Uniforms
-            glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MVP),
-                               1, GL_FALSE, glm::value_ptr(MVP));
-            // Attributes
-            // Positions
-            assert(mesh->hasVertexElement(VertexElement::Semantic::POSITION));
-            attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::POS);
-            mAttribIndices[attribCount++] = (GLuint) attr;
-            glEnableVertexAttribArray((GLuint) attr);
-            const VertexElement& positionElement = mesh->getVertexElement(VertexElement::Semantic::POSITION);
-            glVertexAttribPointer((GLuint) attr,
-                                  positionElement.getCount(),
-                                  positionElement.getType(),
-                                  GL_FALSE,
-                                  mesh->getVertexSize(),
-                                  ((GLvoid *) (U64) (positionElement.getOffset())));
-
-
-            //////////////////////////////////////////////
-            // Setup lighting computation
-            if (pass.hasFunc(Pass::Func::LIGHTING_FLAT)
-                || pass.hasFunc(Pass::Func::LIGHTING_SMOOTH)) {
-
-                // Uniform
-                glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MV),
-                                   1, GL_FALSE, glm::value_ptr(MV));
-                glUniformMatrix3fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::N),
-                                   1, GL_FALSE, glm::value_ptr(N));
-                // Attributes
-                // Normal
-                assert(mesh->hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)
-                       || mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::NORMAL);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &normalElement = pass.hasFunc(Pass::LIGHTING_FLAT) ?
-                                                     mesh->getVertexElement(VertexElement::Semantic::FLAT_NORMAL) :
-                                                     mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                glVertexAttribPointer((GLuint) attr,
-                                      normalElement.getCount(),
-                                      normalElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (normalElement.getOffset())));
-            }
+        mSetupPassUniforms(binding, pass, V);
 
-            //////////////////////////////////////////////
-            // Setup diffuse map
-            if (pass.hasFunc(Pass::Func::DIFFUSE_MAP)) {
-                // active & bind texture
-                glActiveTexture(GL_TEXTURE0);
-                std::shared_ptr<Map> diffuseMap = pass.getDiffuseMap();
-                glBindTexture(GL_TEXTURE_2D, diffuseMap->getHandle());
-                glUniform1i(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DM),
-                            0); //0 means GL_TEXTURE0
-                // Attributes
-                // UV
-                assert(mesh->hasVertexElement(VertexElement::Semantic::UV));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::UV);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &uvElement = mesh->getVertexElement(VertexElement::Semantic::UV);
-                glVertexAttribPointer((GLuint) attr,
-                                      uvElement.getCount(),
-                                      uvElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (uvElement.getOffset())));
-
-                if (pass.hasFunc(Pass::Func::DIFFUSE_MAP_ACTIVATION)) {
-                    glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MV),
-                                       1, GL_FALSE, glm::value_ptr(MV));
-                    glUniform1i(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DM_ACTIVATION),
-                                pass.isDiffuseMapEnabled());
-                }
-            }
+        if (!split) {
+            glDrawElements(GL_TRIANGLES,
+                           mesh->getIndexBuffer().getElementCount(),
+                           mesh->getIndexBuffer().getType(), 0);
+            return;
+        }
+        // no base vertex in GLES2: the attributes point to the first vertex of the range instead
+        for (const IndexBuffer::Range& range : mesh->getIndexBuffer().getRanges()) {
+            mSetupAttribs(binding, mesh->getVertexBuffer().getHandle(), range.baseVertex * mesh->getVertexSize());
+            glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_SHORT,
+                           (GLvoid*) (U64) (range.first * sizeof(U16)));
+        }
+    }
 
-            //////////////////////////////////////////////
-            // Setup scaling
-            if (pass.hasFunc(Pass::Func::SCALING)) {
-                // Uniform
-                glUniformMatrix3fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::N),
-                                   1, GL_FALSE, glm::value_ptr(N));
-                // Attributes
-                // Normal
-                assert(mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::NORMAL);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &normalElement = mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                glVertexAttribPointer((GLuint) attr,
-                                      normalElement.getCount(),
-                                      normalElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (normalElement.getOffset())));
+
+    //------------------------------------------------------------------------
+    size_t RenderingEngine::mFindInstances(const std::vector<RenderQueue::Item>& items, size_t first) const {
+        const RenderQueue::Item& item = items[first];
+        Pass& pass = item.package->mMaterial->getPass(item.pass);
+        bool diffuseMap = pass.hasFunc(Pass::Func::DIFFUSE_MAP);
+
+        size_t end = first + 1;
+        for (; end < items.size(); ++end) {
+            const RenderQueue::Item& other = items[end];
+            if (other.pass != item.pass || other.package->mMesh != item.package->mMesh) {
+                break;
+            }
+            Pass& otherPass = other.package->mMaterial->getPass(other.pass);
+            if (otherPass.getShaderProgram() != pass.getShaderProgram()
+                || otherPass.getFuncFlags() != pass.getFuncFlags()
+                || otherPass.getCullMode() != pass.getCullMode()
+                || otherPass.getDepthWriting() != pass.getDepthWriting()) {
+                break;
             }
+            if (diffuseMap && (otherPass.getDiffuseMap()->getHandle() != pass.getDiffuseMap()->getHandle()
+                               || otherPass.isDiffuseMapEnabled() != pass.isDiffuseMapEnabled())) {
+                break;
+            }
+        }
+        return end;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool RenderingEngine::mDrawInstanced(const RenderQueue::Item* items, U32 count,
+                                         const glm::mat4& V, const glm::mat4& P) {
+        const RenderQueue::Item& first = items[0];
+        const Mesh& mesh = *first.package->mMesh;
+        Pass& pass = first.package->mMaterial->getPass(first.pass);
+        if (mesh.getIndexBuffer().isSplit()) {
+            return false;
+        }
 
-            //////////////////////////////////////////////
-            // Setup diffuse color
-            if (pass.hasFunc(Pass::Func::DIFFUSE_COLOR)) {
-                // Uniforms
-                const glm::vec3& diffuseColor = pass.getDiffuseColor();
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DIFFUSE_COLOR),
-                            diffuseColor.r, diffuseColor.g, diffuseColor.b);
+        const ShaderProgram* program = mGetInstancedProgram(*pass.getShaderProgram());
+        if (program == nullptr) {
+            return false;
+        }
+
+        // instance data is not part of any vertex array object
+        if (mUseVertexArrays) {
+            mStateCache.bindVertexArray(0);
+        }
+
+        const InstanceBatch* batch = nullptr;
+        if (mInstancingMode == InstancingMode::UNIFORM_ARRAYS) {
+            batch = mGetInstanceBatch(mesh, program->getMaxInstances());
+            if (batch == nullptr) {
+                return false;
             }
+        }
+
+        GLUtils::clearGlErrors();
 
+        mStateCache.useProgram(program->getHandle());
+        BindingRecord& binding = mBindingCache.get(mesh, pass, *program);
+        mSetupPass(pass);
+
+        glUniformMatrix4fv(program->getUniformLocation(ShaderProgram::UniformSem::V), 1, GL_FALSE, glm::value_ptr(V));
+        glUniformMatrix4fv(program->getUniformLocation(ShaderProgram::UniformSem::P), 1, GL_FALSE, glm::value_ptr(P));
+        if (binding.uniforms[ShaderProgram::UniformSem::DECODE_SCALE] != -1) {
+            glUniform1f(binding.uniforms[ShaderProgram::UniformSem::DECODE_SCALE], mesh.getDecodeScale());
+        }
+        mSetupPassUniforms(binding, pass, V);
+
+        mInstanceMatrices.clear();
+        mInstanceColors.clear();
+        for (U32 i = 0; i < count; ++i) {
+            mInstanceMatrices.push_back(*items[i].M * mesh.getDecodeMatrix());
+            mInstanceColors.push_back(items[i].package->mMaterial->getPass(first.pass).getDiffuseColor());
+        }
+
+        if (mInstancingMode == InstancingMode::INSTANCED_ARRAYS) {
+            mDrawInstancedArrays(binding, mesh, *program, count);
+        } else {
+            mDrawUniformArrays(binding, *batch, *program, count);
+        }
+        return true;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawInstancedArrays(const BindingRecord& binding, const Mesh& mesh,
+                                               const ShaderProgram& program, U32 count) {
+        mSetupAttribs(binding, mesh.getVertexBuffer().getHandle());
+
+        // matrices then colors, the buffer being orphaned at each call
+        const U32 matricesSize = count * sizeof(glm::mat4);
+        const U32 colorsSize = count * sizeof(glm::vec3);
+        if (mInstanceBuffer == 0) {
+            glGenBuffers(1, &mInstanceBuffer);
+        }
+        mStateCache.bindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, matricesSize + colorsSize, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, matricesSize, mInstanceMatrices.data());
+        glBufferSubData(GL_ARRAY_BUFFER, matricesSize, colorsSize, mInstanceColors.data());
+
+        // a mat4 attribute spans 4 locations, one per column
+        GLuint locations[5];
+        GLuint matrixLocation = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::INSTANCE_M);
+        for (U32 c = 0; c < 4; ++c) {
+            locations[c] = matrixLocation + c;
+            glVertexAttribPointer(locations[c], 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (GLvoid*) (U64) (c * sizeof(glm::vec4)));
+        }
+        locations[4] = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::INSTANCE_COLOR);
+        glVertexAttribPointer(locations[4], 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (GLvoid*) (U64) matricesSize);
 
-            //////////////////////////////////////////////
-            // Setup lights
-            if (shaderProgram->hasUniform(ShaderProgram::UniformSem::LIGHT0_POSITION)) {
-                glm::vec4 lightPos = V * glm::vec4(mLight.position, 1.0f);
-                lightPos.w = 0.0f;
-                glUniform4f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_POSITION), lightPos.x, lightPos.y, lightPos.z, lightPos.w);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_AMBIENT), mLight.ambient.r, mLight.ambient.g, mLight.ambient.b);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_DIFFUSE), mLight.diffuse.r, mLight.diffuse.g, mLight.diffuse.b);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_SPECULAR), mLight.specular.r, mLight.specular.g, mLight.specular.b);
+        U32 mask = binding.attribMask;
+        for (GLuint location : locations) {
+            GLExtensions::vertexAttribDivisor(location, 1);
+            mask |= 1u << location;
+        }
+        mStateCache.setEnabledAttribs(mask);
+        mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.getIndexBuffer().getHandle());
+
+        GLExtensions::drawElementsInstanced(GL_TRIANGLES, mesh.getIndexBuffer().getElementCount(),
+                                            mesh.getIndexBuffer().getType(), 0, count);
+
+        // other programs may use these locations for per-vertex attributes
+        for (GLuint location : locations) {
+            GLExtensions::vertexAttribDivisor(location, 0);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawUniformArrays(const BindingRecord& binding, const InstanceBatch& batch,
+                                             const ShaderProgram& program, U32 count) {
+        mSetupAttribs(binding, batch.vertexBuffer);
+
+        GLuint indexLocation = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::INSTANCE_INDEX);
+        mStateCache.bindBuffer(GL_ARRAY_BUFFER, batch.instanceIndexBuffer);
+        glVertexAttribPointer(indexLocation, 1, GL_FLOAT, GL_FALSE, 0, ((GLvoid *) (U64) (0)));
+        mStateCache.setEnabledAttribs(binding.attribMask | 1u << indexLocation);
+        mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBuffer);
+
+        GLint matricesLocation = program.getUniformLocation(ShaderProgram::UniformSem::INSTANCE_M_ARRAY);
+        GLint colorsLocation = program.getUniformLocation(ShaderProgram::UniformSem::INSTANCE_COLOR_ARRAY);
+        for (U32 first = 0; first < count; first += batch.capacity) {
+            U32 n = std::min(batch.capacity, count - first);
+            glUniformMatrix4fv(matricesLocation, n, GL_FALSE, glm::value_ptr(mInstanceMatrices[first]));
+            glUniform3fv(colorsLocation, n, glm::value_ptr(mInstanceColors[first]));
+            glDrawElements(GL_TRIANGLES, n * batch.indexCount, GL_UNSIGNED_SHORT, 0);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mSetupPass(const Pass& pass) {
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Setup cull mode
+        switch (pass.getCullMode()) {
+            case Pass::NONE:
+                mStateCache.setCapability(GL_CULL_FACE, false);
+                break;
+            case Pass::CullMode::FRONT:
+                mStateCache.setCapability(GL_CULL_FACE, true);
+                mStateCache.cullFace(GL_FRONT);
+                break;
+            case Pass::BACK:
+                mStateCache.setCapability(GL_CULL_FACE, true);
+                mStateCache.cullFace(GL_BACK);
+                break;
+            default:
+                Log::error(TAG, "Invalid cull mode");
+                assert(false);
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Setup depth writing
+        mStateCache.depthMask(pass.getDepthWriting());
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mSetupPassUniforms(const BindingRecord& binding, Pass& pass, const glm::mat4& V) {
+        const GLint* uniforms = binding.uniforms;
+
+        if (binding.diffuseMap) {
+            mStateCache.activeTexture(0);
+            mStateCache.bindTexture(GL_TEXTURE_2D, pass.getDiffuseMap()->getHandle());
+            glUniform1i(uniforms[ShaderProgram::UniformSem::DM], 0); //0 means GL_TEXTURE0
+        }
+
+        if (uniforms[ShaderProgram::UniformSem::DM_ACTIVATION] != -1) {
+            glUniform1i(uniforms[ShaderProgram::UniformSem::DM_ACTIVATION], pass.isDiffuseMapEnabled());
+        }
+
+        if (uniforms[ShaderProgram::UniformSem::LIGHT0_POSITION] != -1) {
+            glm::vec4 lightPos = V * glm::vec4(mLight.position, 1.0f);
+            lightPos.w = 0.0f;
+            glUniform4f(uniforms[ShaderProgram::UniformSem::LIGHT0_POSITION], lightPos.x, lightPos.y, lightPos.z, lightPos.w);
+            glUniform3f(uniforms[ShaderProgram::UniformSem::LIGHT0_AMBIENT], mLight.ambient.r, mLight.ambient.g, mLight.ambient.b);
+            glUniform3f(uniforms[ShaderProgram::UniformSem::LIGHT0_DIFFUSE], mLight.diffuse.r, mLight.diffuse.g, mLight.diffuse.b);
+            glUniform3f(uniforms[ShaderProgram::UniformSem::LIGHT0_SPECULAR], mLight.specular.r, mLight.specular.g, mLight.specular.b);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mSetupAttribs(const BindingRecord& binding, GLuint vertexBuffer, U32 baseOffset) {
+        mStateCache.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        for (U8 i = 0; i < binding.attribCount; ++i) {
+            const BindingRecord::Attrib& attrib = binding.attribs[i];
+            glVertexAttribPointer(attrib.location, attrib.count, attrib.type, attrib.normalized, attrib.stride,
+                                  (const BYTE*) attrib.offset + baseOffset);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    const ShaderProgram* RenderingEngine::mGetInstancedProgram(const ShaderProgram& program) {
+        auto it = mInstancedPrograms.find(program.getId());
+        if (it != mInstancedPrograms.end()) {
+            return it->second.get();
+        }
+
+        std::shared_ptr<ShaderProgram> variant;
+        if (mInstancingMode == InstancingMode::INSTANCED_ARRAYS) {
+            variant = mResourceManager.acquireShaderProgramVariant(program.getSID(), ShaderManager::INSTANCED_VARIANT);
+            if (variant != nullptr && !(variant->hasAttribute(ShaderProgram::AttribSem::INSTANCE_M)
+                                        && variant->hasAttribute(ShaderProgram::AttribSem::INSTANCE_COLOR))) {
+                Log::warn(TAG, "Instanced shader %s lacks per-instance attributes", variant->getSID().c_str());
+                variant = nullptr;
             }
+        } else if (mInstancingMode == InstancingMode::UNIFORM_ARRAYS) {
+            variant = mResourceManager.acquireShaderProgramVariant(program.getSID(), ShaderManager::INSTANCE_ARRAYS_VARIANT);
+            if (variant != nullptr && !(variant->hasAttribute(ShaderProgram::AttribSem::INSTANCE_INDEX)
+                                        && variant->hasUniform(ShaderProgram::UniformSem::INSTANCE_M_ARRAY)
+                                        && variant->hasUniform(ShaderProgram::UniformSem::INSTANCE_COLOR_ARRAY))) {
+                Log::warn(TAG, "Instanced shader %s lacks per-instance uniforms", variant->getSID().c_str());
+                variant = nullptr;
+            }
+        }
+        mInstancedPrograms[program.getId()] = variant;
+        return variant.get();
+    }
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->getIndexBuffer().getHandle());
 
-            glDrawElements(GL_TRIANGLES,
-                           mesh->getIndexBuffer().getElementCount(),
-                           GL_UNSIGNED_SHORT, 0);
+    //------------------------------------------------------------------------
+    const RenderingEngine::InstanceBatch* RenderingEngine::mGetInstanceBatch(const Mesh& mesh, U32 maxInstances) {
+        auto it = mInstanceBatches.find(mesh.getId());
+        if (it != mInstanceBatches.end()) {
+            return it->second.capacity > 0 ? &it->second : nullptr;
+        }
 
+        InstanceBatch& batch = mInstanceBatches[mesh.getId()];
+        batch = {0, 0, 0, 0, 0};
+
+        const std::vector<BYTE>& vertexData = mesh.getVertexData();
+        const U16* indexData = reinterpret_cast<const U16*>(mesh.getIndexData().data());
+        U32 indexCount = mesh.getIndexCount();
+        U32 vertexCount = mesh.getVertexCount();
+        if (vertexData.empty() || indexCount == 0 || vertexCount == 0
+            || mesh.getIndexType() != GL_UNSIGNED_SHORT) {
+            return nullptr;
+        }
+        // all the copies must stay addressable with 16-bit indices
+        U32 capacity = std::min(maxInstances, 0x10000 / vertexCount);
+        if (capacity < MIN_INSTANCES) {
+            Log::trace(TAG, "Mesh %s too large for pseudo-instancing", mesh.getSID().c_str());
+            return nullptr;
+        }
 
-            //////////////////////////////////////////////
-            // Disable vertex attrib arrays
-            for (U16 j = 0; j < attribCount; ++j) {
-                glDisableVertexAttribArray(mAttribIndices[j]);
+        std::vector<BYTE> vertices;
+        std::vector<F32> instanceIndices;
+        std::vector<U16> indices;
+        vertices.reserve(vertexData.size() * capacity);
+        instanceIndices.reserve(vertexCount * capacity);
+        indices.reserve(indexCount * capacity);
+        for (U32 i = 0; i < capacity; ++i) {
+            vertices.insert(vertices.end(), vertexData.begin(), vertexData.end());
+            instanceIndices.insert(instanceIndices.end(), vertexCount, (F32) i);
+            for (U32 j = 0; j < indexCount; ++j) {
+                indices.push_back((U16) (indexData[j] + i * vertexCount));
             }
         }
+
+        glGenBuffers(1, &batch.vertexBuffer);
+        mStateCache.bindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &batch.instanceIndexBuffer);
+        mStateCache.bindBuffer(GL_ARRAY_BUFFER, batch.instanceIndexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, instanceIndices.size() * sizeof(F32), instanceIndices.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &batch.indexBuffer);
+        mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(U16), indices.data(), GL_STATIC_DRAW);
+
+        batch.capacity = capacity;
+        batch.indexCount = indexCount;
+        Log::trace(TAG, "Mesh %s replicated %u times for pseudo-instancing", mesh.getSID().c_str(), capacity);
+        return &batch;
     }
 
 
     //------------------------------------------------------------------------
-    void RenderingEngine::mDrawSkyBox() {
-        glm::mat4 MVP = *mP * glm::mat4(glm::mat3(*mV)); //remove translation components
+    void RenderingEngine::mCreateVertexArray(BindingRecord& binding, const Mesh& mesh) {
+        GLExtensions::genVertexArrays(1, &binding.vertexArray);
+        mStateCache.bindVertexArray(binding.vertexArray);
+        mSetupAttribs(binding, mesh.getVertexBuffer().getHandle());
+        for (U8 i = 0; i < binding.attribCount; ++i) {
+            glEnableVertexAttribArray(binding.attribs[i].location);
+        }
+        mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.getIndexBuffer().getHandle());
+    }
 
-        glDisable(GL_CULL_FACE);
-        glDepthMask(GL_FALSE);
-        glDepthFunc(GL_LEQUAL);  // Change depth function so depth test passes when values are equal to depth buffer's content
 
-        std::shared_ptr<ShaderProgram> program = mSkyBox->getShaderProgram();
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawSkyBox(const glm::mat4& V, const glm::mat4& P) {
+        glm::mat4 MVP = P * glm::mat4(glm::mat3(V)); //remove translation components
+
+        mStateCache.setCapability(GL_CULL_FACE, false);
+        mStateCache.depthMask(false);
+        mStateCache.depthFunc(GL_LEQUAL);  // Change depth function so depth test passes when values are equal to depth buffer's content
 
-        glUseProgram(program->getHandle());
+        std::shared_ptr<ShaderProgram> program = mSkyBox->getShaderProgram();
 
-        glBindBuffer(GL_ARRAY_BUFFER, mSkyBox->getVertexBuffer().getHandle());
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mSkyBox->getIndexBuffer().getHandle());
+        mStateCache.useProgram(program->getHandle());
 
-        glActiveTexture(GL_TEXTURE0);
+        mStateCache.activeTexture(0);
 
         // Uniforms
         glUniformMatrix4fv(program->getUniformLocation(ShaderProgram::UniformSem::MVP),
                            1, GL_FALSE, glm::value_ptr(MVP));
-        glBindTexture(GL_TEXTURE_CUBE_MAP, mSkyBox->getCubeMap()->getHandle());
+        mStateCache.bindTexture(GL_TEXTURE_CUBE_MAP, mSkyBox->getCubeMap()->getHandle());
         glUniform1i(program->getUniformLocation(ShaderProgram::UniformSem::CUBE_MAP), 0); //0 means GL_TEXTURE0
+
         // Attributes
-        // UV
+        GLuint vertexBuffer = mSkyBox->getVertexBuffer().getHandle();
         GLuint attr = (GLuint) program->getAttributeLocation(ShaderProgram::AttribSem::POS);
-        glEnableVertexAttribArray((GLuint) attr);
-        glVertexAttribPointer((GLuint) attr,
-                              3,
-                              GL_FLOAT,
-                              GL_FALSE,
-                              12,
-                              ((GLvoid *) (U64) (0)));
+        if (mUseVertexArrays) {
+            if (mSkyBoxVertexArray == 0
+                || mSkyBoxVertexArrayOwner != mSkyBox
+                || mSkyBoxVertexArrayBuffer != vertexBuffer) {
+                mReleaseSkyBoxVertexArray(true);
+                GLExtensions::genVertexArrays(1, &mSkyBoxVertexArray);
+                mSkyBoxVertexArrayOwner = mSkyBox;
+                mSkyBoxVertexArrayBuffer = vertexBuffer;
+                mStateCache.bindVertexArray(mSkyBoxVertexArray);
+                mStateCache.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+                glVertexAttribPointer(attr, 3, GL_FLOAT, GL_FALSE, 12, ((GLvoid *) (U64) (0)));
+                glEnableVertexAttribArray(attr);
+                mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mSkyBox->getIndexBuffer().getHandle());
+            } else {
+                mStateCache.bindVertexArray(mSkyBoxVertexArray);
+            }
+        } else {
+            mStateCache.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+            glVertexAttribPointer(attr, 3, GL_FLOAT, GL_FALSE, 12, ((GLvoid *) (U64) (0)));
+            mStateCache.setEnabledAttribs(1u << attr);
+            mStateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mSkyBox->getIndexBuffer().getHandle());
+        }
 
         glDrawElements(GL_TRIANGLES,
                        mSkyBox->getIndexBuffer().getElementCount(),
-                       GL_UNSIGNED_SHORT, 0);
+                       mSkyBox->getIndexBuffer().getType(), 0);
+
+        mStateCache.depthMask(true);
+        mStateCache.depthFunc(GL_LESS); // Set depth function back to default
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mReleaseSkyBoxVertexArray(bool releaseGlObject) {
+        if (releaseGlObject && mSkyBoxVertexArray != 0) {
+            GLExtensions::deleteVertexArrays(1, &mSkyBoxVertexArray);
+        }
+        mSkyBoxVertexArray = 0;
+        mSkyBoxVertexArrayOwner = nullptr;
+        mSkyBoxVertexArrayBuffer = 0;
+    }
 
-        glDisableVertexAttribArray(attr);
-        glDepthMask(GL_TRUE);
-        glDepthFunc(GL_LESS); // Set depth function back to default
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mReleaseInstancing(bool releaseGlObjects) {
+        if (releaseGlObjects) {
+            for (auto& entry : mInstanceBatches) {
+                const InstanceBatch& batch = entry.second;
+                if (batch.capacity > 0) {
+                    GLuint buffers[] = {batch.vertexBuffer, batch.instanceIndexBuffer, batch.indexBuffer};
+                    glDeleteBuffers(3, buffers);
+                }
+            }
+            if (mInstanceBuffer != 0) {
+                glDeleteBuffers(1, &mInstanceBuffer);
+            }
+        }
+        mInstanceBatches.clear();
+        mInstanceBuffer = 0;
+        // variants are refreshed or reloaded along with the other shaders,
+        // only their locations may have changed
+        mInstancedPrograms.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mForgetMesh(U32 meshId) {
+        if (mUseVertexArrays) {
+            mStateCache.bindVertexArray(0);
+        }
+        mBindingCache.forget(meshId, mUseVertexArrays);
+
+        auto batch = mInstanceBatches.find(meshId);
+        if (batch != mInstanceBatches.end()) {
+            if (batch->second.capacity > 0) {
+                GLuint buffers[] = {batch->second.vertexBuffer, batch->second.instanceIndexBuffer,
+                                    batch->second.indexBuffer};
+                glDeleteBuffers(3, buffers);
+            }
+            mInstanceBatches.erase(batch);
+        }
     }
 }
@@ -35,6 +35,12 @@ namespace dma {
         BYTE* data;
     };
 
+    struct BoundedBuffer {
+        const BYTE* data;
+        U32 size;
+        U32 offset;
+    };
+
     //============================ ROUTINES ================================//
 
     void memoryReadCallback(png_structp png, png_bytep data, png_size_t size) {
@@ -44,6 +50,17 @@ namespace dma {
     }
 
 
+    //---------------------------------------------------------------------
+    void boundedReadCallback(png_structp png, png_bytep data, png_size_t size) {
+        BoundedBuffer* buffer = (BoundedBuffer*) png_get_io_ptr(png);
+        if (size > buffer->size - buffer->offset) {
+            png_error(png, "read past the end of the PNG data");
+        }
+        memcpy(data, buffer->data + buffer->offset, size);
+        buffer->offset += size;
+    }
+
+
     //---------------------------------------------------------------------
     inline void onPngError(FILE* file, const std::string& filename, const std::string& error) {
         fclose (file);
@@ -186,6 +203,7 @@ namespace dma {
     U32 Image::getHeight(){return mHeight;}
     GLint Image::getFormat(){return mFormat;}
     BYTE* Image::getPixels(){return mPixels;}
+    U32 Image::getSize() const {return mWidth * mHeight * mBytesPerPixel;}
 
 
     //---------------------------------------------------------------------
@@ -235,9 +253,6 @@ namespace dma {
         png_infop info_ptr;
         png_byte magic[8];
 
-        // image parameters
-        int bit_depth, color_type;
-
         /* open texture data read / binary */
         file = fopen(fname.c_str(), "rb");
 
@@ -291,6 +306,65 @@ namespace dma {
         /* tell libpng that we have already read the magic number */
         png_set_sig_bytes(png_ptr, sizeof (magic));
 
+        Status status = mReadPng(png_ptr, info_ptr, fname, reverse);
+        if (status != STATUS_OK) {
+            return status;
+        }
+
+        /* finish decompression and release memory */
+        png_read_end(png_ptr, NULL);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(file);
+
+        return STATUS_OK;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Image::loadAsPNG(const BYTE* data, U32 size, bool reverse) {
+        if (size < 8 || png_sig_cmp((png_const_bytep) data, 0, 8) != 0) {
+            Log::error(TAG, "invalid PNG data");
+            return throwException(TAG, ExceptionType::INVALID_FILE, "invalid PNG data");
+        }
+
+        static const char name[] = "<memory>";
+        png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                                                     (png_voidp) name,
+                                                     png_error_fn,
+                                                     png_warning_fn);
+        if (!png_ptr) {
+            return throwException(TAG, ExceptionType::MEMORY, "cannot create data structure");
+        }
+        png_infop info_ptr = png_create_info_struct(png_ptr);
+        if (!info_ptr) {
+            png_destroy_read_struct(&png_ptr, NULL, NULL);
+            return throwException(TAG, ExceptionType::INVALID_FILE, "cannot read info");
+        }
+
+        BoundedBuffer buffer = {data, size, 8};
+        if (setjmp(png_jmpbuf(png_ptr))) {
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            delete[] mPixels;
+            mPixels = NULL;
+            return throwException(TAG, ExceptionType::INVALID_FILE, "unknown error while reading PNG data");
+        }
+        png_set_read_fn(png_ptr, &buffer, boundedReadCallback);
+        png_set_sig_bytes(png_ptr, 8);
+
+        Status status = mReadPng(png_ptr, info_ptr, name, reverse);
+        if (status == STATUS_OK) {
+            png_read_end(png_ptr, NULL);
+        }
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return status;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Image::mReadPng(png_struct* png_ptr, png_info* info_ptr, const std::string& name, bool reverse) {
+        // image parameters
+        int bit_depth, color_type;
+
         /* read png info */
         png_read_info(png_ptr, info_ptr);
 
@@ -308,7 +382,7 @@ namespace dma {
                       &bit_depth, &color_type,
                       NULL, NULL, NULL);
 
-        Log::trace(TAG, "loading texture of size (%d, %d)", mWidth, mHeight);
+        Log::trace(TAG, "loading texture %s of size (%d, %d)", name.c_str(), mWidth, mHeight);
 
         if(!checkSizePowOf2(mWidth, mHeight)) {
 
@@ -358,11 +432,6 @@ namespace dma {
         /* read png data & fill data array */
         mReadPngData(png_ptr, mPixels, reverse);
 
-        /* finish decompression and release memory */
-        png_read_end(png_ptr, NULL);
-        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        fclose(file);
-
         return STATUS_OK;
     }
 
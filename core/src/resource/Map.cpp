@@ -45,13 +45,15 @@ namespace dma {
     //---------------------------------------------------------------------
     Map::Map() :
             Texture(),
-            mImage(nullptr)
+            mImage(nullptr),
+            mRaw(nullptr)
     {}
 
 
     //---------------------------------------------------------------------
     Map::~Map() {
         delete mImage;
+        delete mRaw;
     }
 
 
@@ -61,6 +63,8 @@ namespace dma {
         Log::trace(TAG, "Loading 2D texture %s ...", filename.c_str());
 
         if (mImage != nullptr) delete mImage;
+        delete mRaw;
+        mRaw = nullptr;
         mImage = new Image();
         Status status = mImage->loadAsPNG(filename) ;
         if (status != STATUS_OK) {
@@ -86,6 +90,8 @@ namespace dma {
 
 
         if (mImage != nullptr) delete mImage;
+        delete mRaw;
+        mRaw = nullptr;
         mImage = new Image(image);
 
         Status status = mLoadFromImage() ;
@@ -100,8 +106,46 @@ namespace dma {
     }
 
 
+    //---------------------------------------------------------------------
+    Status Map::load(Image* image) {
+        assert(image != nullptr);
+        if (mImage != image) {
+            delete mImage;
+            mImage = image;
+        }
+        delete mRaw;
+        mRaw = nullptr;
+        Status status = mLoadFromImage();
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Unable to load map from image");
+        }
+        return status;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Map::load(RawImage* raw) {
+        assert(raw != nullptr);
+        delete mImage;
+        mImage = nullptr;
+        if (mRaw != raw) {
+            delete mRaw;
+            mRaw = raw;
+        }
+        Status status = mLoadFromRaw();
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Unable to load map from raw image");
+        }
+        return status;
+    }
+
+
     //---------------------------------------------------------------------
     Status Map::refresh(const std::string &filename) {
+        if (mRaw != nullptr) {
+            Log::trace(TAG, "Refreshing Map %s from raw image", filename.c_str());
+            return mLoadFromRaw();
+        }
         if (mImage == nullptr) {
             Log::trace(TAG, "Refreshing Map %s from disk", filename.c_str());
             return load(filename);
@@ -114,6 +158,9 @@ namespace dma {
 
     //---------------------------------------------------------------------
     Status Map::refresh() {
+        if (mRaw != nullptr) {
+            return mLoadFromRaw();
+        }
         if (mImage == nullptr) {
             Log::error(TAG, "Refreshing Map that doesn't have cache");
             assert(!"Refreshing Map that doesn't have cache");
@@ -125,6 +172,19 @@ namespace dma {
     }
 
 
+    //---------------------------------------------------------------------
+    U32 Map::getMemorySize() const {
+        if (mRaw != nullptr) {
+            return isUploaded() ? mRaw->getSize() : 0;
+        }
+        if (mImage == nullptr) {
+            return 0;
+        }
+        U32 size = mImage->getSize();
+        return isUploaded() ? size + size + size / 3 : size;
+    }
+
+
     //---------------------------------------------------------------------
     Status Map::mLoadFromImage() {
         /* generate texture */
@@ -175,4 +235,43 @@ namespace dma {
         //TODO delete mImage if cache is off
         return STATUS_OK;
     }
+
+
+    //---------------------------------------------------------------------
+    Status Map::mLoadFromRaw() {
+        glGenTextures(1, &mHandle);
+        assert(mHandle);
+        glBindTexture(GL_TEXTURE_2D, mHandle);
+
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+        // rows of the small levels are not 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (U32 level = 0; level < mRaw->getLevelCount(); ++level) {
+            U32 width, height;
+            const BYTE* pixels = mRaw->getLevel(level, width, height);
+            glTexImage2D(GL_TEXTURE_2D,
+                         (GLint) level,
+                         mRaw->getFormat(),
+                         width,
+                         height,
+                         0, //ES border must be 0
+                         (GLenum) mRaw->getFormat(),
+                         GL_UNSIGNED_BYTE,
+                         pixels);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        checkAnisotropyExt();
+        if (enableAnisotropy) {
+            GLfloat anisotropyMax;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &anisotropyMax);
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropyMax);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return STATUS_OK;
+    }
 }
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "resource/MapLoader.hpp"
+#include "utils/Log.hpp"
+
+#include <stdexcept>
+
+
+constexpr auto TAG = "MapLoader";
+
+namespace dma {
+
+    constexpr U32 MapLoader::DEFAULT_THREAD_COUNT;
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    MapLoader::MapLoader(U32 threadCount) :
+            mGeneration(0),
+            mThreadPool(threadCount)
+    {}
+
+
+    //------------------------------------------------------------------------
+    MapLoader::~MapLoader() {}
+
+
+    //------------------------------------------------------------------------
+    void MapLoader::request(const std::string& sid, const std::string& filename,
+                            const std::string& rawFilename) {
+        requestDecode(sid, filename, [filename](Image& image) {
+            return image.loadAsPNG(filename);
+        }, rawFilename);
+    }
+
+
+    //------------------------------------------------------------------------
+    void MapLoader::requestDecode(const std::string& sid, const std::string& source, const Decoder& decode,
+                                  const std::string& rawFilename) {
+        U32 generation;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mPending.find(sid) != mPending.end()) {
+                return;
+            }
+            generation = ++mGeneration;
+            mPending[sid] = generation;
+        }
+        mThreadPool.post([this, sid, source, decode, rawFilename, generation]() {
+            mDecode(sid, source, decode, rawFilename, generation);
+        });
+    }
+
+
+    //------------------------------------------------------------------------
+    void MapLoader::cancel(const std::string& sid) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.erase(sid);
+        for (auto it = mReady.begin(); it != mReady.end(); ++it) {
+            if (it->sid == sid) {
+                mReady.erase(it);
+                break;
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void MapLoader::cancelAll() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.clear();
+        mReady.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    bool MapLoader::isPending(const std::string& sid) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPending.find(sid) != mPending.end();
+    }
+
+
+    //------------------------------------------------------------------------
+    bool MapLoader::pop(Result& result) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mReady.empty()) {
+            return false;
+        }
+        result = std::move(mReady.front());
+        mReady.pop_front();
+        mPending.erase(result.sid);
+        return true;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void MapLoader::mDecode(const std::string& sid, const std::string& source, const Decoder& decode,
+                            const std::string& rawFilename, U32 generation) {
+        {
+            // cancelled before being started
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mPending.find(sid);
+            if (it == mPending.end() || it->second != generation) {
+                return;
+            }
+        }
+
+        std::unique_ptr<RawImage> raw;
+        if (!rawFilename.empty() && RawImage::isUpToDate(rawFilename, source)) {
+            raw.reset(new RawImage());
+            if (raw->map(rawFilename) != STATUS_OK) {
+                raw.reset();
+            }
+        }
+
+        std::unique_ptr<Image> image;
+        Status status = STATUS_OK;
+        if (raw == nullptr) {
+            image.reset(new Image());
+            try {
+                status = decode(*image);
+            } catch (std::exception& e) {
+                Log::error(TAG, "Unable to decode %s: %s", sid.c_str(), e.what());
+                status = STATUS_KO;
+            }
+            if (status == STATUS_OK && !rawFilename.empty()) {
+                // mapped instead of decoded next time
+                RawImage::write(rawFilename, *image);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mPending.find(sid);
+        if (it == mPending.end() || it->second != generation) {
+            return;
+        }
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Unable to decode %s", sid.c_str());
+            mPending.erase(it);
+            return;
+        }
+        Result result;
+        result.sid = sid;
+        result.image = std::move(image);
+        result.raw = std::move(raw);
+        mReady.push_back(std::move(result));
+    }
+}
@@ -18,15 +18,28 @@
 
 #include "resource/MapManager.hpp"
 
+#include <chrono>
+#include <cstdlib>
+
 #define TAG "MapManager"
 
 #define FALLBACK_MAP_SID "fallback"
 
 namespace dma {
 
+    constexpr U32 MapManager::DEFAULT_UPLOAD_BYTES;
+    constexpr F32 MapManager::DEFAULT_UPLOAD_MILLIS;
 
     //-----------------------------------------------------------------
-    MapManager::MapManager(const std::string& dir) {
+    MapManager::MapManager(const std::string& dir) :
+            mUploadBytes(DEFAULT_UPLOAD_BYTES),
+            mUploadMillis(DEFAULT_UPLOAD_MILLIS),
+            mUploadClock([]() {
+                std::chrono::duration<F64, std::milli> now = std::chrono::steady_clock::now().time_since_epoch();
+                return now.count();
+            }),
+            mTileTextures(true)
+    {
         mMapDir = dir;
         Utils::addTrailingSlash(mMapDir);
     }
@@ -50,23 +63,36 @@ namespace dma {
         if (sid == FALLBACK_MAP_SID) {
             return mFallbackMap;
         }
-        if (mMaps.find(sid) == mMaps.end()) {
-            std::shared_ptr<Map> map = std::make_shared<Map>();
-            try {
-                mLoadMap(map, sid);
-            } catch (std::runtime_error& e) {
-                Log::warn(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
-                return mFallbackMap;
-            }
-            mMaps[sid] = map;
+        auto it = mMaps.find(sid);
+        if (it != mMaps.end()) {
+            mTileCache.touch(sid);
+            return it->second;
         }
-        return mMaps[sid];
+        std::shared_ptr<Map> map = std::make_shared<Map>();
+        try {
+            mLoadMap(map, sid);
+        } catch (std::runtime_error& e) {
+            Log::warn(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
+            return mFallbackMap;
+        }
+        if (TileCache::isTileSid(sid)) {
+            mTileCache.miss();
+        }
+        mInsert(sid, map, false);
+        return map;
     }
 
 
     //-----------------------------------------------------------------
     bool MapManager::hasResource(const std::string &sid) const {
-        return Utils::fileExists(mMapDir + sid + ".png") || Utils::fileExists(mMapDir + sid + ".PNG");
+        std::shared_ptr<TilePack> pack;
+        U32 size;
+        if (mFindPacked(sid, size, pack) != nullptr) {
+            return true;
+        }
+        std::string rawFilename = mRawFilename(sid);
+        return Utils::fileExists(mMapDir + sid + ".png") || Utils::fileExists(mMapDir + sid + ".PNG")
+               || (!rawFilename.empty() && Utils::fileExists(rawFilename));
     }
 
 
@@ -80,9 +106,17 @@ namespace dma {
         for (auto& kv : mMaps) {
             const std::string& sid = kv.first;
             auto map = kv.second;
+            if (mIsImageOnly(sid)) {
+                // only holding its image
+                continue;
+            }
             map->wipe();
-            std::string filename = mMapDir + sid;
-            map->load(filename);
+            // from the same source as when acquired: tile pack, raw copy or file
+            try {
+                mLoadMap(map, sid);
+            } catch (std::runtime_error& e) {
+                Log::warn(TAG, "Unable to reload map %s", sid.c_str());
+            }
         }
 
         Log::trace(TAG, "MapManager reloaded");
@@ -99,6 +133,9 @@ namespace dma {
         for (auto& kv : mMaps) {
             const std::string& sid = kv.first;
             auto map = kv.second;
+            if (mIsImageOnly(sid)) {
+                continue;
+            }
             //map->wipe();
             std::string filename = mMapDir + sid;
             map->refresh(filename);
@@ -129,10 +166,15 @@ namespace dma {
         mFallbackMap->wipe();
         mFallbackMap = nullptr; //release reference count
 
+        if (mLoader != nullptr) {
+            mLoader->cancelAll();
+        }
+
         for (auto& kv : mMaps) {
             kv.second->wipe();
         }
         mMaps.clear();
+        mTileCache.clear();
 
         Log::trace(TAG, "MapManager unloaded");
     }
@@ -142,23 +184,229 @@ namespace dma {
     void MapManager::update() {
         auto it = mMaps.begin();
         while (it != mMaps.end()) {
-            if (it->second.unique()) {
+            // unused tile maps stay cached, within the budget
+            if (it->second.unique() && !TileCache::isTileSid(it->first)) {
                 it->second->wipe();
                 it = mMaps.erase(it);
             } else {
                 ++it;
             }
         }
+
+        mTileCache.shrink([this](const std::string& sid) {
+            auto it = mMaps.find(sid);
+            if (!it->second.unique()) {
+                return false;
+            }
+            it->second->wipe();
+            mMaps.erase(it);
+            return true;
+        });
+    }
+
+
+    //-----------------------------------------------------------------
+    bool MapManager::isLoaded(const std::string& sid) const {
+        return mMaps.find(sid) != mMaps.end();
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::requestAsync(const std::string& sid) {
+        if (isLoaded(sid)) {
+            return;
+        }
+        if (mLoader == nullptr) {
+            mLoader.reset(new MapLoader());
+        }
+        if (TileCache::isTileSid(sid) && !mLoader->isPending(sid)) {
+            mTileCache.miss();
+        }
+        std::shared_ptr<TilePack> pack;
+        U32 size;
+        const BYTE* data = mFindPacked(sid, size, pack);
+        if (data != nullptr) {
+            // the pack stays mapped until decoded
+            mLoader->requestDecode(sid, pack->getFilename(), [pack, data, size](Image& image) {
+                return image.loadAsPNG(data, size);
+            }, mRawFilename(sid));
+        } else {
+            mLoader->request(sid, mMapDir + sid + ".png", mRawFilename(sid));
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::cancelAsync(const std::string& sid) {
+        if (mLoader != nullptr) {
+            mLoader->cancel(sid);
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::uploadDecoded(std::vector<std::string>& uploaded) {
+        if (mLoader == nullptr) {
+            return;
+        }
+        F64 start = mUploadClock();
+        U32 bytes = 0;
+        bool first = true;
+        MapLoader::Result result;
+        while (first || bytes < mUploadBytes) {
+            if (!first && mUploadClock() - start >= mUploadMillis) {
+                break;
+            }
+            if (!mLoader->pop(result)) {
+                break;
+            }
+            first = false;
+            if (isLoaded(result.sid)) {
+                // acquired synchronously meanwhile
+                continue;
+            }
+            std::shared_ptr<Map> map = std::make_shared<Map>();
+            if (result.raw != nullptr) {
+                bytes += result.raw->getSize();
+                if (mIsImageOnly(result.sid)) {
+                    map->setImage(result.raw->toImage());
+                } else if (map->load(result.raw.release()) != STATUS_OK) {
+                    continue;
+                }
+            } else {
+                bytes += result.image->getSize();
+                if (mIsImageOnly(result.sid)) {
+                    map->setImage(result.image.release());
+                } else if (map->load(result.image.release()) != STATUS_OK) {
+                    continue;
+                }
+            }
+            mInsert(result.sid, map, true);
+            uploaded.push_back(result.sid);
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setUploadBudget(U32 maxBytes, F32 maxMillis) {
+        mUploadBytes = maxBytes;
+        mUploadMillis = maxMillis;
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setTileTexturesEnabled(bool enabled) {
+        if (enabled && !mTileTextures) {
+            for (auto& kv : mMaps) {
+                std::shared_ptr<Map> map = kv.second;
+                if (TileCache::isTileSid(kv.first) && !map->isUploaded() && map->getImage() != nullptr) {
+                    map->load(map->getImage());
+                    mTileCache.add(kv.first, map->getMemorySize());
+                }
+            }
+        }
+        mTileTextures = enabled;
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setDecodedTileDir(const std::string& dir) {
+        mDecodedTileDir = dir;
+        if (!mDecodedTileDir.empty()) {
+            Utils::addTrailingSlash(mDecodedTileDir);
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::addTilePack(const std::string& ns, std::shared_ptr<TilePack> pack) {
+        mTilePacks[ns] = pack;
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::removeTilePack(const std::string& ns) {
+        mTilePacks.erase(ns);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void MapManager::mInsert(const std::string& sid, std::shared_ptr<Map> map, bool requested) {
+        mMaps[sid] = map;
+        if (TileCache::isTileSid(sid)) {
+            mTileCache.add(sid, map->getMemorySize(), requested);
+        }
     }
 
 
     //----------------------------------------------------------------------------------------------
     void MapManager::mLoadMap(std::shared_ptr<Map> map, const std::string &sid) {
         std::string filename = mMapDir + sid + ".png";
-        if (!Utils::fileExists(filename)) {
+        std::string rawFilename = mRawFilename(sid);
+        std::shared_ptr<TilePack> pack;
+        U32 size;
+        const BYTE* packed = mFindPacked(sid, size, pack);
+        std::string source = packed != nullptr ? pack->getFilename() : filename;
+        if (!rawFilename.empty() && RawImage::isUpToDate(rawFilename, source)) {
+            std::unique_ptr<RawImage> raw(new RawImage());
+            if (raw->map(rawFilename) == STATUS_OK) {
+                if (mIsImageOnly(sid)) {
+                    map->setImage(raw->toImage());
+                } else {
+                    map->load(raw.release());
+                }
+                return;
+            }
+        }
+        if (packed == nullptr && !Utils::fileExists(filename)) {
             Log::error(TAG, "2D texture %s doesn't exist", sid.c_str());
             throw std::runtime_error("2D texture " + sid + " doesn't exist");
         }
+        if (packed != nullptr || mIsImageOnly(sid) || !rawFilename.empty()) {
+            Image* image = new Image();
+            Status status = packed != nullptr ? image->loadAsPNG(packed, size) : image->loadAsPNG(filename);
+            if (status != STATUS_OK) {
+                delete image;
+                Log::error(TAG, "Unable to load map %s", sid.c_str());
+                throw std::runtime_error("Unable to load map " + sid);
+            }
+            if (!rawFilename.empty()) {
+                RawImage::write(rawFilename, *image);
+            }
+            if (mIsImageOnly(sid)) {
+                map->setImage(image);
+            } else {
+                map->load(image);
+            }
+            return;
+        }
         map->load(filename);
     }
+
+
+    //----------------------------------------------------------------------------------------------
+    const BYTE* MapManager::mFindPacked(const std::string& sid, U32& size, std::shared_ptr<TilePack>& pack) const {
+        if (mTilePacks.empty() || !TileCache::isTileSid(sid)) {
+            return nullptr;
+        }
+        // tiles/<ns>/z/x/y, the namespace being empty or holding slashes
+        size_t yPos = sid.rfind('/');
+        size_t xPos = yPos == std::string::npos ? yPos : sid.rfind('/', yPos - 1);
+        size_t zPos = xPos == std::string::npos ? xPos : sid.rfind('/', xPos - 1);
+        if (zPos == std::string::npos || zPos < 5) {
+            return nullptr;
+        }
+        auto it = mTilePacks.find(zPos > 5 ? sid.substr(6, zPos - 6) : "");
+        if (it == mTilePacks.end()) {
+            return nullptr;
+        }
+        int z = atoi(sid.c_str() + zPos + 1);
+        int x = atoi(sid.c_str() + xPos + 1);
+        int y = atoi(sid.c_str() + yPos + 1);
+        const BYTE* data = it->second->find(x, y, z, size);
+        if (data != nullptr) {
+            pack = it->second;
+        }
+        return data;
+    }
 }
@@ -18,17 +18,27 @@
 
 #include "resource/Mesh.hpp"
 
+#include <atomic>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+
 namespace dma {
 
+    /* ================= STATIC VARIABLES ========================*/
+    static std::atomic<U32> sNextId(1);
+
     /* ================= PRIVATE ========================*/
 
     //------------------------------------------------------------------------------
     Mesh::Mesh() :
+            mId(sNextId++),
             mVertexSemFlags(0),
             mVertexSize(0),
             mVertexCount(0),
+            mIndexType(GL_UNSIGNED_SHORT),
             mVertexBuffer(nullptr),
-            mIndexBuffer(nullptr)
+            mIndexBuffer(nullptr),
+            mDecodeMatrix(1.0f)
     {}
 
 
@@ -54,9 +64,35 @@ namespace dma {
 
     //------------------------------------------------------------------------------
     void Mesh::clearCache() {
-        positions.clear();
-        uvs.clear();
-        flatNormals.clear();
-        vertexIndices.clear();
+        vertexData.clear();
+        indexData.clear();
+    }
+
+
+    //------------------------------------------------------------------------------
+    void Mesh::setIndexData(const std::vector<U32>& indices) {
+        if (mVertexCount <= 0x10000) {
+            mIndexType = GL_UNSIGNED_SHORT;
+            indexData.resize(indices.size() * sizeof(U16));
+            U16* data = reinterpret_cast<U16*>(indexData.data());
+            for (size_t i = 0; i < indices.size(); ++i) {
+                data[i] = (U16) indices[i];
+            }
+        } else {
+            mIndexType = GL_UNSIGNED_INT;
+            indexData.resize(indices.size() * sizeof(U32));
+            memcpy(indexData.data(), indices.data(), indexData.size());
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void Mesh::updateDecodeMatrix() {
+        mDecodeMatrix = glm::mat4(1.0f);
+        if (hasVertexElement(VertexElement::Semantic::POSITION)
+            && getVertexElement(VertexElement::Semantic::POSITION).isNormalized()) {
+            mDecodeMatrix = glm::translate(mDecodeMatrix, mBoundingSphere.getCenter());
+            mDecodeMatrix = glm::scale(mDecodeMatrix, glm::vec3(mBoundingSphere.getRadius()));
+        }
     }
 }
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/MeshFile.hpp"
+#include "resource/Mesh.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+constexpr auto TAG = "MeshFile";
+
+namespace dma {
+
+    constexpr U32 MeshFile::VERSION;
+
+    static const char MAGIC[4] = {'D', 'M', 'A', 'M'};
+    static constexpr U32 HEADER_WORDS = 7;
+    static constexpr U32 ELEMENT_WORDS = 4;
+    static constexpr U32 SPHERE_WORDS = 4;
+
+    static inline U32 align4(U32 size) {
+        return (size + 3) & ~3u;
+    }
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    Status MeshFile::write(const std::string& filename, const Mesh& mesh) {
+        const std::vector<BYTE>& vertices = mesh.getVertexData();
+        const std::vector<BYTE>& indices = mesh.getIndexData();
+        if (vertices.empty() || indices.empty()) {
+            Log::error(TAG, "No data to write to %s", filename.c_str());
+            return STATUS_KO;
+        }
+
+        std::vector<U32> header(HEADER_WORDS);
+        memcpy(&header[0], MAGIC, sizeof(MAGIC));
+        header[1] = VERSION;
+        header[2] = mesh.getVertexSize();
+        header[3] = mesh.getVertexCount();
+        header[4] = mesh.getIndexCount();
+        header[5] = IndexBuffer::getTypeSize(mesh.getIndexType());
+        for (U32 s = 0; s < VertexElement::Semantic::SIZE; ++s) {
+            VertexElement::Semantic semantic = (VertexElement::Semantic) s;
+            if (mesh.hasVertexElement(semantic)) {
+                const VertexElement& element = mesh.getVertexElement(semantic);
+                header.push_back(semantic);
+                header.push_back(element.getCount());
+                header.push_back(element.getType());
+                header.push_back(element.getOffset());
+                ++header[6];
+            }
+        }
+        const BoundingSphere& sphere = mesh.getBoundingSphere();
+        F32 center[SPHERE_WORDS] = {sphere.getCenter().x, sphere.getCenter().y, sphere.getCenter().z,
+                                    sphere.getRadius()};
+
+        size_t slash = filename.find_last_of('/');
+        if (slash != std::string::npos && !Utils::makeDirs(filename.substr(0, slash))) {
+            Log::error(TAG, "Unable to create the directory of %s", filename.c_str());
+            return STATUS_KO;
+        }
+        std::string tmp = filename + ".tmp";
+        FILE* file = fopen(tmp.c_str(), "wb");
+        if (file == nullptr) {
+            Log::error(TAG, "Unable to write %s", tmp.c_str());
+            return STATUS_KO;
+        }
+        static const BYTE padding[3] = {0, 0, 0};
+        bool ok = fwrite(header.data(), sizeof(U32), header.size(), file) == header.size()
+                  && fwrite(center, sizeof(F32), SPHERE_WORDS, file) == SPHERE_WORDS
+                  && fwrite(vertices.data(), 1, vertices.size(), file) == vertices.size()
+                  && fwrite(padding, 1, align4((U32) vertices.size()) - vertices.size(), file)
+                     == align4((U32) vertices.size()) - vertices.size()
+                  && fwrite(indices.data(), 1, indices.size(), file) == indices.size();
+        ok = fclose(file) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), filename.c_str()) != 0) {
+            Log::error(TAG, "Unable to write %s", filename.c_str());
+            remove(tmp.c_str());
+            return STATUS_KO;
+        }
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    Status MeshFile::read(const std::string& filename, Mesh& mesh) {
+        FILE* file = fopen(filename.c_str(), "rb");
+        if (file == nullptr) {
+            return STATUS_KO;
+        }
+        U32 header[HEADER_WORDS];
+        if (fread(header, sizeof(U32), HEADER_WORDS, file) != HEADER_WORDS
+            || memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || header[1] != VERSION) {
+            Log::warn(TAG, "%s is not a mesh file of version %u", filename.c_str(), VERSION);
+            fclose(file);
+            return STATUS_KO;
+        }
+        U32 vertexSize = header[2];
+        U32 vertexCount = header[3];
+        U32 indexCount = header[4];
+        U32 indexSize = header[5];
+        U32 elementCount = header[6];
+        if ((indexSize != sizeof(U16) && indexSize != sizeof(U32)) || elementCount > VertexElement::Semantic::SIZE
+            || vertexSize == 0 || vertexCount == 0 || indexCount == 0) {
+            Log::error(TAG, "Invalid mesh file %s", filename.c_str());
+            fclose(file);
+            return STATUS_KO;
+        }
+
+        U32 elements[VertexElement::Semantic::SIZE * ELEMENT_WORDS];
+        F32 sphere[SPHERE_WORDS];
+        if (fread(elements, sizeof(U32), elementCount * ELEMENT_WORDS, file) != elementCount * ELEMENT_WORDS
+            || fread(sphere, sizeof(F32), SPHERE_WORDS, file) != SPHERE_WORDS) {
+            Log::error(TAG, "Truncated mesh file %s", filename.c_str());
+            fclose(file);
+            return STATUS_KO;
+        }
+        VertexElement vertexElements[VertexElement::Semantic::SIZE];
+        for (U32 i = 0; i < elementCount; ++i) {
+            const U32* element = &elements[i * ELEMENT_WORDS];
+            bool valid = element[0] < VertexElement::Semantic::SIZE && VertexElement::getTypeSize(element[2]) != 0
+                         && element[1] >= 1 && element[1] <= 4;
+            if (valid) {
+                vertexElements[i] = VertexElement((VertexElement::Semantic) element[0], element[1],
+                                                  (GLenum) element[2], element[3]);
+                valid = (U64) element[3] + vertexElements[i].getSizeInByte() <= vertexSize;
+            }
+            if (!valid) {
+                Log::error(TAG, "Invalid vertex element in %s", filename.c_str());
+                fclose(file);
+                return STATUS_KO;
+            }
+        }
+
+        // straight into the buffers uploaded by the MeshManager
+        U64 vertexBytes = (U64) vertexSize * vertexCount;
+        U64 indexBytes = (U64) indexCount * indexSize;
+        long start = ftell(file);
+        bool sized = start >= 0 && fseek(file, 0, SEEK_END) == 0;
+        long end = sized ? ftell(file) : -1;
+        sized = sized && fseek(file, start, SEEK_SET) == 0;
+        if (vertexBytes > 0xFFFFFFFFull || indexBytes > 0xFFFFFFFFull || !sized
+            || ((vertexBytes + 3) & ~3ull) + indexBytes > (U64) (end - start)) {
+            Log::error(TAG, "Invalid mesh file %s", filename.c_str());
+            fclose(file);
+            return STATUS_KO;
+        }
+        mesh.vertexData.resize((size_t) vertexBytes);
+        mesh.indexData.resize((size_t) indexBytes);
+        bool ok = fread(mesh.vertexData.data(), 1, (size_t) vertexBytes, file) == vertexBytes
+                  && fseek(file, align4((U32) vertexBytes) - (U32) vertexBytes, SEEK_CUR) == 0
+                  && fread(mesh.indexData.data(), 1, (size_t) indexBytes, file) == indexBytes;
+        fclose(file);
+        if (!ok) {
+            Log::error(TAG, "Truncated mesh file %s", filename.c_str());
+            mesh.clearCache();
+            return STATUS_KO;
+        }
+
+        for (U32 i = 0; i < indexCount; ++i) {
+            U32 index = indexSize == sizeof(U32) ? reinterpret_cast<const U32*>(mesh.indexData.data())[i]
+                                                 : reinterpret_cast<const U16*>(mesh.indexData.data())[i];
+            if (index >= vertexCount) {
+                Log::error(TAG, "Index out of range in %s", filename.c_str());
+                mesh.clearCache();
+                return STATUS_KO;
+            }
+        }
+
+        for (U32 i = 0; i < elementCount; ++i) {
+            mesh.addVertexElement(vertexElements[i]);
+        }
+        mesh.mVertexSize = vertexSize;
+        mesh.mVertexCount = vertexCount;
+        mesh.mIndexType = indexSize == sizeof(U32) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        mesh.mBoundingSphere = BoundingSphere(sphere[0], sphere[1], sphere[2], sphere[3]);
+        mesh.updateDecodeMatrix();
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool MeshFile::isUpToDate(const std::string& filename, const std::string& source) {
+        I64 time = Utils::getModificationTime(filename);
+        return time >= 0 && time >= Utils::getModificationTime(source);
+    }
+}
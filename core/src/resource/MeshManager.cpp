@@ -17,7 +17,9 @@
 
 
 #include "resource/MeshManager.hpp"
-#include "utils/ObjReader.hpp"
+#include "resource/MeshFile.hpp"
+#include "utils/ObjParser.hpp"
+#include "utils/GLExtensions.hpp"
 #include "utils/Log.hpp"
 #include "utils/ExceptionHandler.hpp"
 
@@ -30,6 +32,8 @@ constexpr auto TAG = "MeshManager";
 namespace dma {
 
     const std::string MeshManager::FALLBACK_MESH_SID = "fallback";
+    constexpr F32 MeshManager::DEFAULT_SMOOTHING_ANGLE;
+    constexpr U32 VertexIndices::NONE;
 
     /* ================= ROUTINES ========================*/
 
@@ -39,70 +43,62 @@ namespace dma {
                    std::vector<glm::vec2>& uvs,
                    std::vector<glm::vec3>& flatNormals,
                    std::vector<VertexIndices>& vertexIndices) {
-        /////////////////////////////////////////////////////
-        //1. open obj file.
-        ObjReader objReader(path);
-        if(!objReader.isOpen()) {
-            Log::error(TAG, "Cannot open file %s", path.c_str());
-            assert(!"Cannot open obj file");
+        if (ObjParser::parseFile(path, positions, uvs, flatNormals, vertexIndices) != STATUS_OK) {
+            Log::error(TAG, "Cannot read file %s", path.c_str());
+            assert(!"Cannot read obj file");
             return STATUS_KO;
         }
 
-        /////////////////////////////////////////////////////
-        //2. parse positions
-        glm::vec3 p;
-        objReader.gotoPositions();
-        while(objReader.nextPosition(p)) {
-            positions.push_back(p);
-        }
-
         if(positions.empty()) {
             Log::error(TAG, "No position vertex found while reading file \"%s\"", path.c_str());
             assert(!"No position vertex found");
             return STATUS_KO;
         }
-        /////////////////////////////////////////////////////
-        //3. parse uvs
-        glm::vec2 uv;
-        objReader.gotoUV();
-        while(objReader.nextUV(uv)) {
-            uvs.push_back(uv);
-        }
-
-        /////////////////////////////////////////////////////
-        // 4. parse normals as flat normal
-        glm::vec3 n;
-        objReader.gotoNormals();
-        while(objReader.nextNormal(n)) {
-            flatNormals.push_back(n);
-        }
-
-        /////////////////////////////////////////////////////
-        // 5. parse faces
-        U16 f[3][3];
-        objReader.gotoFaces();
-        while(objReader.nextFace(f)) {
-            for(int i=0; i<3; ++i) {
-                VertexIndices vi(f[i][ObjReader::FACE_P],
-                                 f[i][ObjReader::FACE_UV],
-                                 f[i][ObjReader::FACE_N]);
-
-                vertexIndices.push_back(vi);
-            }
-        }
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------------------
-    inline bool containsNormal(const std::vector<glm::vec3> &normals,
-                               const glm::vec3& n) {
-        F32 e = 0.0001f;
-        for(glm::vec3 normal : normals) {
-            if(glm::abs(glm::dot<float>(normal, n) - 1) < e) return true;
+    /**
+     * Vertex index by VertexIndices, open addressing with linear probing.
+     */
+    class VertexIndexTable {
+
+    public:
+        explicit VertexIndexTable(size_t count) {
+            size_t capacity = 16;
+            while (capacity < count * 2) {
+                capacity <<= 1;
+            }
+            mMask = capacity - 1;
+            // empty slots have no position
+            mKeys.resize(capacity);
+            mIndices.resize(capacity);
+        }
+
+        /**
+         * @return the index of the key, set to index if not found.
+         */
+        inline U32 insert(const VertexIndices& key, U32 index, bool& inserted) {
+            size_t slot = (size_t) (key.hash() >> 32) & mMask;
+            while (mKeys[slot].p != VertexIndices::NONE) {
+                if (mKeys[slot] == key) {
+                    inserted = false;
+                    return mIndices[slot];
+                }
+                slot = (slot + 1) & mMask;
+            }
+            mKeys[slot] = key;
+            mIndices[slot] = index;
+            inserted = true;
+            return index;
         }
-        return false;
-    }
+
+    private:
+        std::vector<VertexIndices> mKeys;
+        std::vector<U32> mIndices;
+        size_t mMask;
+    };
 
 
     //----------------------------------------------------------------------------------------------
@@ -110,11 +106,11 @@ namespace dma {
                              const std::vector<glm::vec3>& positions,
                              std::vector<VertexIndices>& indices) {
 
-        U16 ifn = 0;
-        for(U16 i = 0; i < indices.size(); i += 3) {
-            U16 ia = indices[i].p;
-            U16 ib = indices[i+1].p;
-            U16 ic = indices[i+2].p;
+        U32 ifn = 0;
+        for(size_t i = 0; i < indices.size(); i += 3) {
+            U32 ia = indices[i].p;
+            U32 ib = indices[i+1].p;
+            U32 ic = indices[i+2].p;
 
             glm::vec3 normal = glm::normalize(glm::cross(
                     positions[ib] - positions[ia],
@@ -127,39 +123,307 @@ namespace dma {
 
 
     //----------------------------------------------------------------------------------------------
+    /**
+     * The distinct normals around a position, normals within about a degree
+     * of each other being the same, as those of the faces of a same plane.
+     * Open addressing by normal cell.
+     */
+    class DistinctNormals {
+
+    public:
+        explicit DistinctNormals(const std::vector<glm::vec3>& normals) :
+                mUnits(normals.size()),
+                mCells(normals.size()),
+                mMask(0)
+        {
+            for (size_t i = 0; i < normals.size(); ++i) {
+                mUnits[i] = glm::normalize(normals[i]);
+                if (mUnits[i] != mUnits[i]) {
+                    continue; // degenerate face
+                }
+                // normals this close, less than half a cell apart, are in the same
+                // cell or the adjacent ones on the nearer sides
+                const glm::vec3 f = mUnits[i] * 32.0f;
+                const glm::ivec3 cell = glm::ivec3(glm::floor(f)) + 64;
+                const glm::ivec3 side = glm::ivec3(glm::step(glm::vec3(0.5f), f - glm::floor(f))) * 2 - 1;
+                Cell& c = mCells[i];
+                c.keys[0] = (U64) (U16) cell.x << 32 | (U64) (U16) cell.y << 16 | (U64) (U16) cell.z;
+                c.keys[1] = c.keys[0] + (U64) ((I64) side.x << 32);
+                c.keys[2] = c.keys[0] + (U64) ((I64) side.y << 16);
+                c.keys[3] = c.keys[1] + (U64) ((I64) side.y << 16);
+                for (U32 k = 0; k < 4; ++k) {
+                    c.keys[k + 4] = c.keys[k] + (U64) (I64) side.z;
+                }
+            }
+        }
+
+        /**
+         * Starts over, for the count normals around another position.
+         */
+        void reset(U32 count) {
+            size_t capacity = 8;
+            while (capacity < count * 2) {
+                capacity <<= 1;
+            }
+            if (mFirsts.size() < capacity) {
+                mKeys.resize(capacity);
+                mFirsts.resize(capacity);
+            }
+            mMask = capacity - 1;
+            std::fill(mFirsts.begin(), mFirsts.begin() + capacity, VertexIndices::NONE);
+        }
+
+        /**
+         * @return the first normal added equal to normal fn, else fn, then added.
+         */
+        U32 add(U32 fn) {
+            const glm::vec3& n = mUnits[fn];
+            if (n != n) {
+                return fn; // degenerate face
+            }
+            const U64* keys = mCells[fn].keys;
+            for (U32 k = 0; k < 8; ++k) {
+                for (size_t slot = slotOf(keys[k]); mFirsts[slot] != VertexIndices::NONE; slot = (slot + 1) & mMask) {
+                    if (mKeys[slot] == keys[k] && glm::dot(n, mUnits[mFirsts[slot]]) >= 1.0f - 0.0001f) {
+                        return mFirsts[slot];
+                    }
+                }
+            }
+            size_t slot = slotOf(keys[0]);
+            while (mFirsts[slot] != VertexIndices::NONE) {
+                slot = (slot + 1) & mMask;
+            }
+            mKeys[slot] = keys[0];
+            mFirsts[slot] = fn;
+            return fn;
+        }
+
+    private:
+        /** the keys of the cell of a normal, then of the cells adjacent on its nearer sides */
+        struct Cell {
+            U64 keys[8];
+        };
+
+        inline size_t slotOf(U64 key) const {
+            return (size_t) ((key * 0x9E3779B97F4A7C15ull) >> 32) & mMask;
+        }
+
+        std::vector<glm::vec3> mUnits;
+        std::vector<Cell> mCells;
+        std::vector<U64> mKeys;
+        std::vector<U32> mFirsts;
+        size_t mMask;
+    };
+
+
+    //----------------------------------------------------------------------------------------------
+    inline U32 findGroup(std::vector<U32>& groups, U32 c) {
+        while (groups[c] != c) {
+            groups[c] = groups[groups[c]];
+            c = groups[c];
+        }
+        return c;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * The smooth normal of a position is the average of the distinct flat normals around
+     * it. Below a smoothingAngle of 180 degrees, the faces around a position are
+     * grouped across their shared edges, if their flat normals are within that angle,
+     * and each group gets its own smooth normal.
+     */
     void generateSmoothNormals(std::vector<glm::vec3>& smoothNormals,
                                const std::vector<glm::vec3>& flatNormals,
                                const std::vector<glm::vec3>& positions,
                                std::vector<VertexIndices>& indices,
-                               bool keepFlats = false) {
-
-        std::vector<std::vector<glm::vec3>> smoothBuckets(positions.size());
-        for (U16 i = 0; i < indices.size(); ++i) {
-            glm::vec3 normal = flatNormals[indices[i].fn];
-            U16 isn = indices[i].p;
-            if (!containsNormal(smoothBuckets[isn], normal)) {
-                smoothBuckets[isn].push_back(normal);
+                               bool keepFlats,
+                               F32 smoothingAngle) {
+
+        // the corners of position p are corners[first[p]] to corners[first[p + 1] - 1]
+        std::vector<U32> first(positions.size() + 1, 0);
+        for (const VertexIndices& vi : indices) {
+            ++first[vi.p + 1];
+        }
+        for (size_t p = 0; p < positions.size(); ++p) {
+            first[p + 1] += first[p];
+        }
+        std::vector<U32> corners(indices.size());
+        std::vector<U32> next(first.begin(), first.end() - 1);
+        for (U32 i = 0; i < indices.size(); ++i) {
+            corners[next[indices[i].p]++] = i;
+        }
+
+        // the distinct normal of each corner slot around its position
+        DistinctNormals distinct(flatNormals);
+        std::vector<U32> normalOf(corners.size());
+        for (U32 p = 0; p < positions.size(); ++p) {
+            distinct.reset(first[p + 1] - first[p]);
+            for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                normalOf[c] = distinct.add(indices[corners[c]].fn);
             }
-            indices[i].sn = isn;
         }
 
-        for (std::vector<glm::vec3> sb : smoothBuckets) {
-            glm::vec3 sn = glm::vec3(0.0f);
-            for(glm::vec3 n : sb) {
-                sn += n;
+        smoothNormals.clear();
+        smoothNormals.reserve(positions.size());
+
+        if (smoothingAngle >= 180.0f) {
+            // one smooth normal per position
+            std::vector<U32> seenAt(flatNormals.size(), VertexIndices::NONE);
+            for (U32 p = 0; p < positions.size(); ++p) {
+                glm::vec3 sn = glm::vec3(0.0f);
+                U32 count = 0;
+                for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                    const U32 fn = normalOf[c];
+                    if (seenAt[fn] != p) {
+                        seenAt[fn] = p;
+                        sn += flatNormals[fn];
+                        ++count;
+                    }
+                    indices[corners[c]].sn = p;
+                }
+                smoothNormals.push_back(count == 0 ? sn : glm::normalize(sn / (float) count));
+            }
+        } else {
+            const F32 minCos = cos(glm::radians(smoothingAngle));
+            // group of each corner slot, and the last slot of p having an edge to each position
+            std::vector<U32> groups(corners.size());
+            std::vector<U32> edgeAt(positions.size(), VertexIndices::NONE);
+            std::vector<U32> edgeSlot(positions.size());
+            std::vector<U32> groupNormal(corners.size());
+            std::vector<U64> members;
+            for (U32 p = 0; p < positions.size(); ++p) {
+                for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                    groups[c] = c;
+                }
+                for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                    const U32 face = corners[c] - corners[c] % 3;
+                    const glm::vec3& normal = flatNormals[indices[corners[c]].fn];
+                    for (U32 k = face; k < face + 3; ++k) {
+                        const U32 q = indices[k].p;
+                        if (q == p) {
+                            continue;
+                        }
+                        if (edgeAt[q] == p
+                            && glm::dot(normal, flatNormals[indices[corners[edgeSlot[q]]].fn]) >= minCos) {
+                            groups[findGroup(groups, c)] = findGroup(groups, edgeSlot[q]);
+                        }
+                        edgeAt[q] = p;
+                        edgeSlot[q] = c;
+                    }
+                }
+
+                // each plane counted once per group
+                members.clear();
+                for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                    members.push_back((U64) findGroup(groups, c) << 32 | normalOf[c]);
+                }
+                std::sort(members.begin(), members.end());
+                members.erase(std::unique(members.begin(), members.end()), members.end());
+                for (size_t m = 0; m < members.size();) {
+                    const U32 group = (U32) (members[m] >> 32);
+                    glm::vec3 sn = glm::vec3(0.0f);
+                    U32 count = 0;
+                    for (; m < members.size() && (U32) (members[m] >> 32) == group; ++m, ++count) {
+                        sn += flatNormals[(U32) members[m]];
+                    }
+                    groupNormal[group] = (U32) smoothNormals.size();
+                    smoothNormals.push_back(glm::normalize(sn / (float) count));
+                }
+                for (U32 c = first[p]; c < first[p + 1]; ++c) {
+                    indices[corners[c]].sn = groupNormal[findGroup(groups, c)];
+                }
             }
-            sn = glm::normalize(sn / (float)sb.size());
-            smoothNormals.push_back(sn);
         }
 
         if (!keepFlats) {
             for(VertexIndices& vi : indices) {
-                vi.fn = 0xFFFF;
+                vi.fn = VertexIndices::NONE;
             }
         }
     }
 
 
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Splits the triangles into ranges of at most 65536 vertices, each range
+     * getting its own copy of its vertices after the previous ones, and
+     * 16-bit indices relative to its first vertex.
+     */
+    void splitRanges(const Mesh& mesh, const U32* indices, U32 indexCount,
+                     std::vector<BYTE>& splitVertices,
+                     std::vector<U16>& splitIndices,
+                     std::vector<IndexBuffer::Range>& ranges) {
+        const BYTE* vertexData = mesh.getVertexData().data();
+        const U32 vertexSize = mesh.getVertexSize();
+
+        // range a vertex was last copied to, and its index there
+        std::vector<U32> rangeOf(mesh.getVertexCount(), VertexIndices::NONE);
+        std::vector<U16> local(mesh.getVertexCount());
+        splitIndices.reserve(indexCount);
+        ranges.push_back({0, 0, 0});
+        U32 rangeVertexCount = 0;
+        for (U32 i = 0; i + 2 < indexCount; i += 3) {
+            U32 r = (U32) ranges.size() - 1;
+            U32 added = 0;
+            for (U32 c = i; c < i + 3; ++c) {
+                added += rangeOf[indices[c]] != r;
+            }
+            if (rangeVertexCount + added > 0x10000) {
+                ranges.push_back({i, 0, ranges.back().baseVertex + rangeVertexCount});
+                rangeVertexCount = 0;
+                ++r;
+            }
+            for (U32 c = i; c < i + 3; ++c) {
+                U32 v = indices[c];
+                if (rangeOf[v] != r) {
+                    rangeOf[v] = r;
+                    local[v] = (U16) rangeVertexCount++;
+                    splitVertices.insert(splitVertices.end(), vertexData + v * vertexSize,
+                                         vertexData + (v + 1) * vertexSize);
+                }
+                splitIndices.push_back(local[v]);
+            }
+            ranges.back().count += 3;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Writes the values in the type of the element. Integer types are normalized:
+     * values are clamped to [-1, 1], or to [0, 1] if unsigned.
+     */
+    void writeElement(BYTE* dst, const VertexElement& element, const F32* values) {
+        const U32 count = element.getCount();
+        switch (element.getType()) {
+            case GL_FLOAT:
+                memcpy(dst, values, count * sizeof(F32));
+                break;
+            case GL_SHORT:
+                for (U32 i = 0; i < count; ++i) {
+                    reinterpret_cast<GLshort*>(dst)[i] =
+                            (GLshort) glm::round(glm::clamp(values[i], -1.0f, 1.0f) * 32767.0f);
+                }
+                break;
+            case GL_UNSIGNED_SHORT:
+                for (U32 i = 0; i < count; ++i) {
+                    reinterpret_cast<GLushort*>(dst)[i] =
+                            (GLushort) glm::round(glm::clamp(values[i], 0.0f, 1.0f) * 65535.0f);
+                }
+                break;
+            case GL_BYTE:
+                for (U32 i = 0; i < count; ++i) {
+                    reinterpret_cast<GLbyte*>(dst)[i] =
+                            (GLbyte) glm::round(glm::clamp(values[i], -1.0f, 1.0f) * 127.0f);
+                }
+                break;
+            default:
+                assert(!"Unsupported vertex element type");
+        }
+    }
+
+
     //----------------------------------------------------------------------------------------------
     BoundingSphere generateBoundingSphere(const std::vector<glm::vec3>& positions) {
         glm::vec3 center(0.0f, 0.0f, 0.0f);
@@ -311,32 +575,13 @@ namespace dma {
         //filename, deduced from SID
         const std::string& path = mLocalDir + sid;
         Log::trace(TAG, "checking if mesh %s exists...", sid.c_str());
-        return Utils::fileExists(path + ".obj") || Utils::fileExists(path + ".OBJ");
-    }
-
-    /* ================= PRIVATE ========================*/
-
-
-    //----------------------------------------------------------------------------------------------
-    MeshManager::MeshManager(const std::string& localDir) :
-            mMeshes() {
-        mLocalDir = localDir;
+        return Utils::fileExists(path + ".mesh")
+               || Utils::fileExists(path + ".obj") || Utils::fileExists(path + ".OBJ");
     }
 
 
     //--------------------------------------------------------------------
-    Status MeshManager::mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid) const {
-        //try to load from the cache
-        if (mesh->hasCache()) {
-            return mLoad(mesh, sid,
-                         mesh->positions,
-                         mesh->uvs,
-                         mesh->flatNormals,
-                         mesh->vertexIndices);
-        }
-
-        //otherwise load from the file
-
+    Status MeshManager::buildFromObj(const std::string& filename, Mesh& mesh, F32 smoothingAngle, bool packed) {
         // stores elements as they comes from .obj
         std::vector<glm::vec3> positions;
         std::vector<glm::vec2> uvs;
@@ -344,41 +589,63 @@ namespace dma {
         // map one UV & one p per vertex object
         std::vector<VertexIndices> vertexIndices;
 
-        //filename, deduced from SID
-        std::string path = mLocalDir + sid + ".obj";
-
         //load positions uvs and their indices from the obj file
-        if (loadObj(path, positions, uvs, flatNormals, vertexIndices) != STATUS_OK) {
-            Log::error(TAG, "Unable to load obj %s", path.c_str());
+        if (loadObj(filename, positions, uvs, flatNormals, vertexIndices) != STATUS_OK) {
+            Log::error(TAG, "Unable to load obj %s", filename.c_str());
             return STATUS_KO;
         }
+        return mBuild(mesh, positions, uvs, flatNormals, vertexIndices, smoothingAngle, packed);
+    }
 
-        //update the cache if any
-        mesh->positions = positions;
-        mesh->uvs = uvs;
-        mesh->flatNormals = flatNormals;
-        mesh->vertexIndices = vertexIndices;
+    /* ================= PRIVATE ========================*/
 
-        return mLoad(mesh, sid, positions, uvs, flatNormals, vertexIndices);
+
+    //----------------------------------------------------------------------------------------------
+    MeshManager::MeshManager(const std::string& localDir) :
+            mMeshes(),
+            mSmoothingAngle(DEFAULT_SMOOTHING_ANGLE),
+            mPackedVertices(false) {
+        mLocalDir = localDir;
     }
 
 
     //--------------------------------------------------------------------
-    Status MeshManager::mLoad(std::shared_ptr<Mesh> mesh, const std::string &sid,
-                              std::vector<glm::vec3> &positions,
-                              std::vector<glm::vec2> &uvs,
-                              std::vector<glm::vec3> &flatNormals,
-                              std::vector<VertexIndices> &vertexIndices) const {
+    Status MeshManager::mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid) const {
+        //otherwise load from the file, the binary one first
+        if (!mesh->hasCache()) {
+            std::string path = mLocalDir + sid;
+            if (!MeshFile::isUpToDate(path + ".mesh", path + ".obj")
+                || MeshFile::read(path + ".mesh", *mesh) != STATUS_OK) {
+                if (buildFromObj(path + ".obj", *mesh, mSmoothingAngle, mPackedVertices) != STATUS_OK) {
+                    return STATUS_KO;
+                }
+            }
+        }
+
+        mUpload(*mesh);
+        Log::trace(TAG, "Mesh %s loaded", sid.c_str());
+        return STATUS_OK;
+    }
+
+
+    //--------------------------------------------------------------------
+    Status MeshManager::mBuild(Mesh& mesh,
+                               std::vector<glm::vec3> &positions,
+                               std::vector<glm::vec2> &uvs,
+                               std::vector<glm::vec3> &flatNormals,
+                               std::vector<VertexIndices> &vertexIndices,
+                               F32 smoothingAngle,
+                               bool packed) {
 
         bool hasUv, hasFlat, hasSmooth;
         hasUv = !uvs.empty();
         if (!hasUv) {
-            Log::trace(TAG, "no UV mapping found for mesh \"%s\"", sid.c_str());
+            Log::trace(TAG, "no UV mapping found");
         }
 
         hasFlat = !flatNormals.empty();
         if (!hasFlat) {
-            Log::trace(TAG, "no Flat normal mapping found for mesh \"%s\"", sid.c_str());
+            Log::trace(TAG, "no Flat normal mapping found");
         }
 
         // generates normals
@@ -386,27 +653,29 @@ namespace dma {
         if (!hasFlat) {
             generateFlatNormals(flatNormals, positions, vertexIndices);
         }
-        generateSmoothNormals(smoothNormals, flatNormals, positions, vertexIndices, hasFlat);
+        generateSmoothNormals(smoothNormals, flatNormals, positions, vertexIndices, hasFlat, smoothingAngle);
         hasSmooth = true; //TODO metadata
 
         if(!hasFlat) { //TODO handle it with metadata
             flatNormals.clear(); //no need from there
         }
 
-        std::vector<U16> indices;
+        std::vector<U32> indices;
         std::vector<Vertex> vertices;
+        indices.reserve(vertexIndices.size());
         // map one Vertex object to one or many VertexIndices
-        std::map<VertexIndices, U16> indexMap;
+        VertexIndexTable indexTable(vertexIndices.size());
 
-        U16 currentVertexIndex = 0;
+        U32 currentVertexIndex = 0;
         //create Vertex objects out of VertexIndices.
         for (const VertexIndices& vi : vertexIndices) {
 
             // if Vertex object of this indices doesn't exist already
-            if (indexMap.find(vi) == indexMap.end()) {
+            bool inserted;
+            U32 index = indexTable.insert(vi, currentVertexIndex, inserted);
+            indices.push_back(index);
+            if (inserted) {
                 //create it & refer to it.
-                indexMap[vi] = currentVertexIndex;
-                indices.push_back(currentVertexIndex);
                 currentVertexIndex++;
 
                 Vertex v;
@@ -421,92 +690,127 @@ namespace dma {
                     v.setSmoothNormal(smoothNormals[vi.sn]);
                 }
                 vertices.push_back(v);
-            } else {
-                indices.push_back(indexMap[vi]);
             }
         }
 
         U32 vertexSize = 0;
         U32 vertexCount = (U32) vertices.size();
 
+        // packed UVs must lie within [0, 1]
+        bool packedUv = packed;
+        for (const glm::vec2& uv : uvs) {
+            packedUv = packedUv && uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f;
+        }
+        const GLenum positionType = packed ? GL_SHORT : GL_FLOAT;
+        const GLenum normalType = packed ? GL_BYTE : GL_FLOAT;
+        const GLenum uvType = packedUv ? GL_UNSIGNED_SHORT : GL_FLOAT;
+
         //Positions
-        VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, vertexSize);
+        VertexElement positionElement(VertexElement::Semantic::POSITION, 3, positionType, vertexSize);
         vertexSize += positionElement.getSizeInByte();
-        mesh->addVertexElement(positionElement);
+        mesh.addVertexElement(positionElement);
 
 
         //Normals
         if (hasFlat) {
-            VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, vertexSize);
+            VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, normalType, vertexSize);
             vertexSize += flatNormalElement.getSizeInByte();
-            mesh->addVertexElement(flatNormalElement);
+            mesh.addVertexElement(flatNormalElement);
         }
         if (hasSmooth) {
-            VertexElement smoothNormalElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_FLOAT, vertexSize);
+            VertexElement smoothNormalElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, normalType, vertexSize);
             vertexSize += smoothNormalElement.getSizeInByte();
-            mesh->addVertexElement(smoothNormalElement);
+            mesh.addVertexElement(smoothNormalElement);
         }
 
         // UVs
         if (hasUv) {
-            VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, vertexSize);
+            VertexElement uvElement(VertexElement::Semantic::UV, 2, uvType, vertexSize);
             vertexSize += uvElement.getSizeInByte();
-            mesh->addVertexElement(uvElement);
+            mesh.addVertexElement(uvElement);
         }
 
-        mesh->mVertexSize = vertexSize;
-        mesh->mVertexCount = vertexCount;
+        mesh.mVertexSize = vertexSize;
+        mesh.mVertexCount = vertexCount;
         //Log::debug(TAG, "vertexSize=%d vertexCount=%d", vertexSize, vertexCount);
         //Log::debug(TAG, "indices=%d", indices.size());
 
-        BYTE* data = new BYTE[vertexSize * vertexCount];
-
-        /////////////////////////////////////////////////////////////////////////
-        // Generate vertex buffer
-        //delete mesh->mVertexBuffer;
-        if (mesh->mVertexBuffer != nullptr) {
-            mesh->mVertexBuffer->wipe();
-        }
-        mesh->mVertexBuffer = std::make_shared<VertexBuffer>(vertexSize, (U32) (vertexSize * vertexCount));
+        // packed positions are quantized to the bounding sphere
+        mesh.mBoundingSphere = generateBoundingSphere(positions);
+        mesh.updateDecodeMatrix();
+        const glm::vec3 center = mesh.mBoundingSphere.getCenter();
+        const F32 radius = mesh.mBoundingSphere.getRadius();
+        const F32 invRadius = radius > 0.0f ? 1.0f / radius : 0.0f;
 
         /////////////////////////////////////////////////////////////////////////
         // Fills data
+        mesh.vertexData.assign(vertexSize * vertexCount, 0);
+        BYTE* data = mesh.vertexData.data();
         for (U32 v = 0; v < vertexCount; ++v) {
-            if (mesh->hasVertexElement(VertexElement::Semantic::POSITION)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::POSITION);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getPosition()), ve.getSizeInByte());
+            if (mesh.hasVertexElement(VertexElement::Semantic::POSITION)) {
+                const VertexElement& ve = mesh.getVertexElement(VertexElement::Semantic::POSITION);
+                glm::vec3 position = vertices[v].getPosition();
+                if (ve.isNormalized()) {
+                    position = (position - center) * invRadius;
+                }
+                writeElement(&data[v * vertexSize + ve.getOffset()], ve, &position.x);
             }
-            if (mesh->hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::FLAT_NORMAL);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getFlatNormal()), ve.getSizeInByte());
+            if (mesh.hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)) {
+                const VertexElement& ve = mesh.getVertexElement(VertexElement::Semantic::FLAT_NORMAL);
+                writeElement(&data[v * vertexSize + ve.getOffset()], ve, &vertices[v].getFlatNormal().x);
             }
-            if (mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getSmoothNormal()), ve.getSizeInByte());
+            if (mesh.hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL)) {
+                const VertexElement& ve = mesh.getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
+                writeElement(&data[v * vertexSize + ve.getOffset()], ve, &vertices[v].getSmoothNormal().x);
             }
-            if (mesh->hasVertexElement(VertexElement::Semantic::UV)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::UV);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getUv()), ve.getSizeInByte());
+            if (mesh.hasVertexElement(VertexElement::Semantic::UV)) {
+                const VertexElement& ve = mesh.getVertexElement(VertexElement::Semantic::UV);
+                writeElement(&data[v * vertexSize + ve.getOffset()], ve, &vertices[v].getUv().x);
             }
         }
+        mesh.setIndexData(indices);
+        return STATUS_OK;
+    }
 
-        /////////////////////////////////////////////////////////////////////////
-        // Uploads data to GPU
-        mesh->mVertexBuffer->writeData(0, vertexSize * vertexCount, data);
-        delete[] data;
 
+    //--------------------------------------------------------------------
+    void MeshManager::mUpload(Mesh& mesh) {
+        // without 32-bit indices, large meshes are drawn in several ranges
+        std::vector<BYTE> splitVertices;
+        std::vector<U16> splitIndices;
+        std::vector<IndexBuffer::Range> ranges;
+        if (mesh.mIndexType == GL_UNSIGNED_INT && !GLExtensions::hasElementIndexUint()) {
+            splitRanges(mesh, reinterpret_cast<const U32*>(mesh.indexData.data()), mesh.getIndexCount(),
+                        splitVertices, splitIndices, ranges);
+            Log::trace(TAG, "Mesh %s split into %u ranges", mesh.getSID().c_str(), (U32) ranges.size());
+        }
+        const std::vector<BYTE>& vertices = ranges.empty() ? mesh.vertexData : splitVertices;
+        U32 vertexBytes = (U32) vertices.size();
 
-        //delete mesh->mIndexBuffer;
-        if (mesh->mIndexBuffer != nullptr) {
-            mesh->mIndexBuffer->wipe();
+        /////////////////////////////////////////////////////////////////////////
+        // Generate vertex buffer
+        //delete mesh.mVertexBuffer;
+        if (mesh.mVertexBuffer != nullptr) {
+            mesh.mVertexBuffer->wipe();
         }
-        mesh->mIndexBuffer = std::make_shared<IndexBuffer>((U32) indices.size());
-        mesh->mIndexBuffer->writeData(indices.data());
+        mesh.mVertexBuffer = std::make_shared<VertexBuffer>(mesh.mVertexSize, vertexBytes);
 
-        mesh->mBoundingSphere = generateBoundingSphere(positions);
+        /////////////////////////////////////////////////////////////////////////
+        // Uploads data to GPU
+        mesh.mVertexBuffer->writeData(0, vertexBytes, vertices.data());
 
-        Log::trace(TAG, "Mesh %s loaded", sid.c_str());
-        return STATUS_OK;
+        //delete mesh.mIndexBuffer;
+        if (mesh.mIndexBuffer != nullptr) {
+            mesh.mIndexBuffer->wipe();
+        }
+        if (ranges.empty()) {
+            mesh.mIndexBuffer = std::make_shared<IndexBuffer>(mesh.getIndexCount(), mesh.mIndexType);
+            mesh.mIndexBuffer->writeData(mesh.indexData.data());
+        } else {
+            mesh.mIndexBuffer = std::make_shared<IndexBuffer>((U32) splitIndices.size(), GL_UNSIGNED_SHORT);
+            mesh.mIndexBuffer->writeData(splitIndices.data());
+            mesh.mIndexBuffer->setRanges(ranges);
+        }
     }
 
 
@@ -515,6 +819,9 @@ namespace dma {
         auto it = mMeshes.begin();
         while (it != mMeshes.end()) {
             if (it->second.unique()) {
+                if (mDropListener) {
+                    mDropListener(*it->second);
+                }
                 it->second->wipe();
                 it = mMeshes.erase(it);
             } else {
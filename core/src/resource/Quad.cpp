@@ -47,11 +47,12 @@ namespace dma {
         offset += positionElement.getSizeInByte();
         addVertexElement(positionElement);
 
-        VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, offset);
+        // same layout as the QuadFactory's
+        VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_UNSIGNED_SHORT, offset);
         offset += uvElement.getSizeInByte();
         addVertexElement(uvElement);
 
-        VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, offset);
+        VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_BYTE, offset);
         offset += flatNormalElement.getSizeInByte();
         addVertexElement(flatNormalElement);
 
@@ -24,12 +24,17 @@ constexpr auto TAG = "QuadFactory";
 
 namespace dma {
 
+    constexpr F32 QuadFactory::SKIRT_DEPTH;
+
     //--------------------------------------------------
     QuadFactory::QuadFactory() :
             mVertexSize(0),
             mVertexCount(0),
+            mSkirtVertexCount(0),
             mVertexBuffer(std::make_shared<VertexBuffer>()),
-            mIndexBuffer(std::make_shared<IndexBuffer>())
+            mIndexBuffer(std::make_shared<IndexBuffer>()),
+            mSkirtVertexBuffer(std::make_shared<VertexBuffer>()),
+            mSkirtIndexBuffer(std::make_shared<IndexBuffer>())
     {}
 
 
@@ -45,66 +50,97 @@ namespace dma {
         GLfloat positions[] = {-1.0f, -1.0f, 0.0f,  // bottom left corner
                                -1.0f,  1.0f, 0.0f,  // top left corner
                                1.0f,  1.0f, 0.0f,  // top right corner
-                               1.0f, -1.0f, 0.0f}; // bottom right corner
-
-        GLfloat uvs[] = {0.0f, 0.0f,
-                         0.0f, 1.0f,
-                         1.0f, 1.0f,
-                         1.0f, 0.0f,};
-
-
-        GLfloat flatNormals[] = {0.0f, 0.0f, 1.0f,
-                                 0.0f, 0.0f, 1.0f,
-                                 0.0f, 0.0f, 1.0f,
-                                 0.0f, 0.0f, 1.0f};
-
+                               1.0f, -1.0f, 0.0f,  // bottom right corner
+                               // the same, lowered, for the skirt
+                               -1.0f, -1.0f, -SKIRT_DEPTH,
+                               -1.0f,  1.0f, -SKIRT_DEPTH,
+                               1.0f,  1.0f, -SKIRT_DEPTH,
+                               1.0f, -1.0f, -SKIRT_DEPTH};
+
+        // packed: normalized unsigned shorts
+        constexpr GLushort o = 65535;
+        GLushort uvs[] = {0, 0,
+                          0, o,
+                          o, o,
+                          o, 0,
+                          0, 0,
+                          0, o,
+                          o, o,
+                          o, 0};
+
+
+        // packed: normalized bytes, padded to 4
+        GLbyte flatNormals[] = {0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0,
+                                0, 0, 127, 0};
+
+        // kept as floats: their length of 2, which sets the silhouette width, exceeds a normalized byte
         float s = (float) (1.0f / M_SQRT1_2);
 
         GLfloat smoothNormals[] = {-s, -s, 0.0f,
+                                   -s, s, 0.0f,
+                                   s, s, 0.0f,
+                                   s, -s, 0.0f,
+                                   -s, -s, 0.0f,
                                    -s, s, 0.0f,
                                    s, s, 0.0f,
                                    s, -s, 0.0f};
 
         GLushort indices[] = {0, 2, 1,  // first triangle (bottom left - top left - top right)
-                              0, 3, 2}; // second triangle (bottom left - top right - bottom right)
+                              0, 3, 2,  // second triangle (bottom left - top right - bottom right)
+                              // skirt, one strip per edge
+                              0, 1, 5,  0, 5, 4,
+                              1, 2, 6,  1, 6, 5,
+                              2, 3, 7,  2, 7, 6,
+                              3, 0, 4,  3, 4, 7};
 
-        U32 vertexCount = 4;
         U32 vertexSize = 0;
         VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, vertexSize);
         vertexSize += positionElement.getSizeInByte();
-        VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, vertexSize);
+        VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_UNSIGNED_SHORT, vertexSize);
         vertexSize += uvElement.getSizeInByte();
-        VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, vertexSize);
+        VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_BYTE, vertexSize);
         vertexSize += flatNormalElement.getSizeInByte();
         VertexElement smoothNormalElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_FLOAT, vertexSize);
         vertexSize += smoothNormalElement.getSizeInByte();
 
-        mVertexCount = vertexCount;
+        mVertexCount = 4;
+        mSkirtVertexCount = 8;
         mVertexSize = vertexSize;
 
-        BYTE* data = new BYTE[vertexSize * vertexCount];
-        Log::debug(TAG, "vertexSize=%d, vertexCount=%d", vertexSize, vertexCount);
+        BYTE* data = new BYTE[vertexSize * mSkirtVertexCount];
+        Log::debug(TAG, "vertexSize=%d, vertexCount=%d", vertexSize, mVertexCount);
 
         /////////////////////////////////////////////////////////////////////////
         // Fills data
         Log::debug(TAG, "%d, %d", positionElement.getSizeInByte(), positionElement.getOffset());
-        for (U32 v = 0; v < vertexCount; ++v) {
+        for (U32 v = 0; v < mSkirtVertexCount; ++v) {
             memcpy(&data[v * vertexSize + positionElement.getOffset()], &(positions[3*v]), positionElement.getSizeInByte());
             memcpy(&data[v * vertexSize + uvElement.getOffset()], &(uvs[2*v]), uvElement.getSizeInByte());
-            memcpy(&data[v * vertexSize + flatNormalElement.getOffset()], &(flatNormals[3*v]), flatNormalElement.getSizeInByte());
+            memcpy(&data[v * vertexSize + flatNormalElement.getOffset()], &(flatNormals[4*v]), flatNormalElement.getSizeInByte());
             memcpy(&data[v * vertexSize + smoothNormalElement.getOffset()], &(smoothNormals[3*v]), smoothNormalElement.getSizeInByte());
         }
 
         /////////////////////////////////////////////////////////////////////////
-        // Generate vertex buffer and upload data to GPU
-        mVertexBuffer->generateBuffer(vertexSize, vertexSize * vertexCount);
-        mVertexBuffer->writeData(0, vertexSize * vertexCount, data);
+        // Generate vertex buffers and upload data to GPU,
+        // the plain quad using the first four vertices
+        mVertexBuffer->generateBuffer(vertexSize, vertexSize * mVertexCount);
+        mVertexBuffer->writeData(0, vertexSize * mVertexCount, data);
+        mSkirtVertexBuffer->generateBuffer(vertexSize, vertexSize * mSkirtVertexCount);
+        mSkirtVertexBuffer->writeData(0, vertexSize * mSkirtVertexCount, data);
         delete[] data;
 
         /////////////////////////////////////////////////////////////////////////
-        // Generate and fill index buffer
+        // Generate and fill index buffers
         mIndexBuffer->generateBuffer(6);
         mIndexBuffer->writeData(indices);
+        mSkirtIndexBuffer->generateBuffer(sizeof(indices) / sizeof(indices[0]));
+        mSkirtIndexBuffer->writeData(indices);
 
         Log::trace(TAG, "QuadFactory loaded");
     }
@@ -116,6 +152,8 @@ namespace dma {
 
         mVertexBuffer->wipe();
         mIndexBuffer->wipe();
+        mSkirtVertexBuffer->wipe();
+        mSkirtIndexBuffer->wipe();
 
         Log::trace(TAG, "QuadFactory unloaded");
     }
@@ -127,6 +165,8 @@ namespace dma {
 
         mVertexBuffer->wipe();
         mIndexBuffer->wipe();
+        mSkirtVertexBuffer->wipe();
+        mSkirtIndexBuffer->wipe();
 
         Log::trace(TAG, "QuadFactory wiped");
     }
@@ -146,6 +186,12 @@ namespace dma {
     }
 
 
+    //--------------------------------------------------
+    std::shared_ptr<Quad> QuadFactory::createSkirtedQuad(F32 width, F32 height) {
+        return std::make_shared<Quad>(width, height, mVertexSize, mSkirtVertexCount, mSkirtVertexBuffer, mSkirtIndexBuffer);
+    }
+
+
     //--------------------------------------------------
     void QuadFactory::deleteQuad(const Quad &quad) {
         delete &quad;
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/RawImage.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+
+constexpr auto TAG = "RawImage";
+
+namespace dma {
+
+    constexpr U32 RawImage::VERSION;
+
+    static const char MAGIC[4] = {'D', 'M', 'A', 'R'};
+    static constexpr U32 HEADER_WORDS = 6;
+    // larger than any GL texture, small enough for the level sizes not to overflow
+    static constexpr U32 MAX_SIDE = 1 << 16;
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    static U32 bytesPerPixel(GLint format) {
+        switch (format) {
+            case GL_LUMINANCE:          return 1;
+            case GL_LUMINANCE_ALPHA:    return 2;
+            case GL_RGB:                return 3;
+            case GL_RGBA:               return 4;
+            default:                    return 0;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    /**
+     * @return the number of levels of the full mipmap chain, down to 1x1.
+     */
+    static U32 fullLevelCount(U32 width, U32 height) {
+        U32 count = 1;
+        while ((width >> count) > 0 || (height >> count) > 0) {
+            ++count;
+        }
+        return count;
+    }
+
+
+    //------------------------------------------------------------------------
+    /**
+     * Halves the level, averaging 2x2 pixels (or less on the odd edges).
+     */
+    static void downsample(const std::vector<BYTE>& src, U32 width, U32 height, U32 bpp,
+                           std::vector<BYTE>& dst, U32 dstWidth, U32 dstHeight) {
+        dst.resize(dstWidth * dstHeight * bpp);
+        for (U32 y = 0; y < dstHeight; ++y) {
+            U32 y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+            for (U32 x = 0; x < dstWidth; ++x) {
+                U32 x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+                for (U32 c = 0; c < bpp; ++c) {
+                    U32 sum = src[(y0 * width + x0) * bpp + c] + src[(y0 * width + x1) * bpp + c]
+                              + src[(y1 * width + x0) * bpp + c] + src[(y1 * width + x1) * bpp + c];
+                    dst[(y * dstWidth + x) * bpp + c] = (BYTE) ((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    RawImage::RawImage() :
+            mData(nullptr),
+            mMappedSize(0),
+            mWidth(0),
+            mHeight(0),
+            mFormat(0),
+            mLevelCount(0),
+            mLevels(nullptr)
+    {}
+
+
+    //------------------------------------------------------------------------
+    RawImage::~RawImage() {
+        unmap();
+    }
+
+
+    //------------------------------------------------------------------------
+    Status RawImage::write(const std::string& filename, Image& image) {
+        U32 bpp = bytesPerPixel(image.getFormat());
+        if (bpp == 0 || image.getPixels() == nullptr) {
+            Log::error(TAG, "Unsupported image for %s", filename.c_str());
+            return STATUS_KO;
+        }
+
+        // the whole mipmap chain, down to 1x1
+        std::vector<std::vector<BYTE>> levels(1);
+        std::vector<U32> widths(1, image.getWidth()), heights(1, image.getHeight());
+        levels[0].assign(image.getPixels(), image.getPixels() + image.getSize());
+        while (widths.back() > 1 || heights.back() > 1) {
+            U32 w = std::max(widths.back() / 2, 1u), h = std::max(heights.back() / 2, 1u);
+            levels.emplace_back();
+            downsample(levels[levels.size() - 2], widths.back(), heights.back(), bpp, levels.back(), w, h);
+            widths.push_back(w);
+            heights.push_back(h);
+        }
+
+        U32 levelCount = (U32) levels.size();
+        std::vector<U32> header(HEADER_WORDS + 2 * levelCount);
+        memcpy(&header[0], MAGIC, 4);
+        header[1] = VERSION;
+        header[2] = image.getWidth();
+        header[3] = image.getHeight();
+        header[4] = (U32) image.getFormat();
+        header[5] = levelCount;
+        U32 offset = (U32) (header.size() * sizeof(U32));
+        for (U32 i = 0; i < levelCount; ++i) {
+            header[HEADER_WORDS + 2 * i] = offset;
+            header[HEADER_WORDS + 2 * i + 1] = (U32) levels[i].size();
+            offset += ((U32) levels[i].size() + 3) & ~3u;
+        }
+
+        size_t slash = filename.find_last_of('/');
+        if (slash != std::string::npos && !Utils::makeDirs(filename.substr(0, slash))) {
+            Log::error(TAG, "Unable to create the directory of %s", filename.c_str());
+            return STATUS_KO;
+        }
+        std::string tmp = filename + ".tmp";
+        FILE* file = fopen(tmp.c_str(), "wb");
+        if (file == nullptr) {
+            Log::error(TAG, "Unable to write %s", tmp.c_str());
+            return STATUS_KO;
+        }
+        static const BYTE padding[3] = {0, 0, 0};
+        bool ok = fwrite(header.data(), sizeof(U32), header.size(), file) == header.size();
+        for (U32 i = 0; ok && i < levelCount; ++i) {
+            size_t size = levels[i].size();
+            ok = fwrite(levels[i].data(), 1, size, file) == size
+                 && fwrite(padding, 1, (4 - size % 4) % 4, file) == (4 - size % 4) % 4;
+        }
+        ok = fclose(file) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), filename.c_str()) != 0) {
+            Log::error(TAG, "Unable to write %s", filename.c_str());
+            remove(tmp.c_str());
+            return STATUS_KO;
+        }
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool RawImage::isUpToDate(const std::string& filename, const std::string& source) {
+        I64 time = Utils::getModificationTime(filename);
+        return time >= 0 && time >= Utils::getModificationTime(source);
+    }
+
+
+    //------------------------------------------------------------------------
+    Status RawImage::map(const std::string& filename) {
+        unmap();
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return STATUS_KO;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t) info.st_size < HEADER_WORDS * sizeof(U32)) {
+            close(fd);
+            Log::error(TAG, "Invalid raw image %s", filename.c_str());
+            return STATUS_KO;
+        }
+        void* data = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            Log::error(TAG, "Unable to map %s", filename.c_str());
+            return STATUS_KO;
+        }
+        mData = (BYTE*) data;
+        mMappedSize = (size_t) info.st_size;
+
+        // a truncated or corrupted file must not be read past its end
+        // and the level chain must be complete, the Map sampling it with mipmaps
+        const U32* header = (const U32*) mData;
+        const U32 width = header[2], height = header[3], bpp = bytesPerPixel((GLint) header[4]);
+        bool valid = memcmp(header, MAGIC, 4) == 0 && header[1] == VERSION && bpp != 0
+                     && width > 0 && width <= MAX_SIDE && height > 0 && height <= MAX_SIDE
+                     && header[5] == fullLevelCount(width, height)
+                     && (HEADER_WORDS + 2 * (size_t) header[5]) * sizeof(U32) <= mMappedSize;
+        for (U32 i = 0; valid && i < header[5]; ++i) {
+            U64 offset = header[HEADER_WORDS + 2 * i];
+            U64 size = header[HEADER_WORDS + 2 * i + 1];
+            valid = size == (U64) std::max(width >> i, 1u) * std::max(height >> i, 1u) * bpp
+                    && offset + size <= mMappedSize;
+        }
+        if (!valid) {
+            Log::error(TAG, "Invalid raw image %s", filename.c_str());
+            unmap();
+            return STATUS_KO;
+        }
+        mWidth = header[2];
+        mHeight = header[3];
+        mFormat = (GLint) header[4];
+        mLevelCount = header[5];
+        mLevels = header + HEADER_WORDS;
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RawImage::unmap() {
+        if (mData != nullptr) {
+            munmap(mData, mMappedSize);
+            mData = nullptr;
+            mMappedSize = 0;
+            mLevelCount = 0;
+            mLevels = nullptr;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    const BYTE* RawImage::getLevel(U32 level, U32& width, U32& height) const {
+        width = std::max(mWidth >> level, 1u);
+        height = std::max(mHeight >> level, 1u);
+        return mData + mLevels[2 * level];
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 RawImage::getSize() const {
+        U32 size = 0;
+        for (U32 i = 0; i < mLevelCount; ++i) {
+            size += mLevels[2 * i + 1];
+        }
+        return size;
+    }
+
+
+    //------------------------------------------------------------------------
+    Image* RawImage::toImage() const {
+        U32 width, height;
+        const BYTE* pixels = getLevel(0, width, height);
+        return new Image(width, height, mFormat, const_cast<BYTE*>(pixels));
+    }
+}
@@ -20,6 +20,9 @@
 #include "resource/ShaderManager.hpp"
 #include "utils/ExceptionHandler.hpp"
 
+#include <algorithm>
+
+
 constexpr auto TAG = "ShaderManager";
 
 #define NAUTO_ADD_PRECISION
@@ -36,6 +39,13 @@ precision mediump float;\n\
 
 namespace dma {
     const std::string ShaderManager::FALLBACK_SHADER_SID = "fallback";
+    const std::string ShaderManager::INSTANCED_VARIANT = "instanced";
+    const std::string ShaderManager::INSTANCE_ARRAYS_VARIANT = "instance_arrays";
+    constexpr char ShaderManager::VARIANT_SEPARATOR;
+    constexpr U32 ShaderManager::MAX_UNIFORM_INSTANCES;
+
+    // marker the vertex source of a shader must contain to have instanced variants
+    static const std::string INSTANCING_MARKER = "DMA_INSTANCING";
 
     /* ================= ROUTINES ========================*/
 
@@ -100,6 +110,27 @@ namespace dma {
     }
 
 
+    //----------------------------------------------------------------------------
+    std::shared_ptr<ShaderProgram> ShaderManager::acquireVariant(const std::string& sid, const std::string& variant) {
+        const std::string key = sid + VARIANT_SEPARATOR + variant;
+        auto it = mShaderPrograms.find(key);
+        if (it != mShaderPrograms.end()) {
+            return it->second;
+        }
+        if (mMissingVariants.find(key) != mMissingVariants.end()) {
+            return nullptr;
+        }
+        std::shared_ptr<ShaderProgram> shaderProgram = std::make_shared<ShaderProgram>();
+        if (mLoad(shaderProgram, key) != STATUS_OK) {
+            Log::trace(TAG, "no %s variant for shader %s", variant.c_str(), sid.c_str());
+            mMissingVariants.insert(key);
+            return nullptr;
+        }
+        mShaderPrograms[key] = shaderProgram;
+        return shaderProgram;
+    }
+
+
     //----------------------------------------------------------------------------
     bool ShaderManager::hasResource(const std::string& sid) const {
 
@@ -167,6 +198,7 @@ namespace dma {
 
         mFallbackShaderProgram = nullptr; //release reference count
         mShaderPrograms.clear();
+        mMissingVariants.clear();
 
         Log::trace(TAG, "ShaderManager unloaded");
     }
@@ -201,6 +233,7 @@ namespace dma {
     //----------------------------------------------------------------------------
     Status ShaderManager::mLoad(std::shared_ptr<ShaderProgram> shaderProgram, const std::string &sid) const {
         Log::trace(TAG, "Loading shader %s ...", sid.c_str());
+        shaderProgram->mSID = sid;
 
         //try to load from the cache
         if (shaderProgram->hasCache()) {
@@ -209,18 +242,35 @@ namespace dma {
 
         //otherwise load from the file
 
+        // variants share the files of their base shader
+        size_t separator = sid.find(VARIANT_SEPARATOR);
+        const std::string fileSid = sid.substr(0, separator);
+
         std::string vertexSource;
         std::string fragmentSource;
         Status status;
-        status = Utils::bufferize(mLocalDir + sid + ".v.glsl", vertexSource);
+        status = Utils::bufferize(mLocalDir + fileSid + ".v.glsl", vertexSource);
         if(status == STATUS_OK) {
-            status = Utils::bufferize(mLocalDir + sid + ".f.glsl", fragmentSource);
+            status = Utils::bufferize(mLocalDir + fileSid + ".f.glsl", fragmentSource);
         }
 
         if(status != STATUS_OK) {
             return status;
         }
 
+        if (separator != std::string::npos) {
+            if (vertexSource.find(INSTANCING_MARKER) == std::string::npos) {
+                return STATUS_KO;
+            }
+            std::string header = mVariantHeader(sid.substr(separator + 1), &shaderProgram->mMaxInstances);
+            if (header.empty()) {
+                Log::error(TAG, "Unknown shader variant %s", sid.c_str());
+                return STATUS_KO;
+            }
+            vertexSource.insert(0, header);
+            fragmentSource.insert(0, header);
+        }
+
         //update the cache
         shaderProgram->mVertexSource = vertexSource;
         shaderProgram->mFragmentSource = fragmentSource;
@@ -284,6 +334,29 @@ namespace dma {
     }
 
 
+    //----------------------------------------------------------------------------
+    std::string ShaderManager::mVariantHeader(const std::string& variant, U32* maxInstances) const {
+        *maxInstances = 0;
+        if (variant == INSTANCED_VARIANT) {
+            return "#define DMA_INSTANCING\n";
+        }
+        if (variant == INSTANCE_ARRAYS_VARIANT) {
+            // one mat4 & one vec3 per instance, leaving room for the other uniforms
+            GLint maxVectors = 0;
+            glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, &maxVectors);
+            I32 count = (maxVectors - 16) / 5;
+            if (count < 2) {
+                return "";
+            }
+            *maxInstances = std::min((U32) count, MAX_UNIFORM_INSTANCES);
+            return "#define DMA_INSTANCING\n"
+                   "#define DMA_INSTANCE_ARRAYS\n"
+                   "#define DMA_MAX_INSTANCES " + std::to_string(*maxInstances) + "\n";
+        }
+        return "";
+    }
+
+
     //----------------------------------------------------------------------------
     GLuint ShaderManager::mCompile(const std::string& source, GLenum type) const {
         GLuint handle = glCreateShader(type);
@@ -19,13 +19,23 @@
 #include "resource/ShaderProgram.hpp"
 #include "utils/ExceptionHandler.hpp"
 
+#include <atomic>
+
 
 namespace dma {
 
     /* ================= STATIC VARIABLES ========================*/
     constexpr char ShaderProgram::TAG[];
-
-    const std::string ShaderProgram::attributeNames[] = { "a_position", "a_normal", "a_uv" };
+    static std::atomic<U32> sNextId(1);
+
+    const std::string ShaderProgram::attributeNames[] = {
+            "a_position",
+            "a_normal",
+            "a_uv",
+            "a_instance_M",
+            "a_instance_color",
+            "a_instance_index"
+    };
     const std::string ShaderProgram::uniformNames[] = {
             "u_MV",
             "u_MVP",
@@ -38,7 +48,12 @@ namespace dma {
             "u_light0.position",
             "u_light0.La",
             "u_light0.Ld",
-            "u_light0.Ls"
+            "u_light0.Ls",
+            "u_V",
+            "u_P",
+            "u_instance_M",
+            "u_instance_color",
+            "u_decode_scale"
     };
 
 
@@ -46,7 +61,7 @@ namespace dma {
 
     //------------------------------------------------------------------------------
     ShaderProgram::ShaderProgram() :
-            mHandle(0), mAttributeFlags(0L), mUniformFlags(0L){
+            mId(sNextId++), mMaxInstances(0), mHandle(0), mAttributeFlags(0L), mUniformFlags(0L){
     }
 
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/TextureAtlas.hpp"
+#include "utils/Log.hpp"
+
+#include <cassert>
+
+
+constexpr auto TAG = "TextureAtlas";
+
+namespace dma {
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    TextureAtlas::TextureAtlas(U32 slotSize, U32 slotsPerRow) :
+            Map(),
+            mSlotSize(slotSize),
+            mSlotsPerRow(slotsPerRow)
+    {}
+
+
+    //------------------------------------------------------------------------
+    TextureAtlas::~TextureAtlas() {}
+
+
+    //------------------------------------------------------------------------
+    Status TextureAtlas::create() {
+        GLint maxTextureSize;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        if (getSize() > (U32) maxTextureSize) {
+            Log::warn(TAG, "Atlas of %u pixels larger than the max texture size %d", getSize(), maxTextureSize);
+            return STATUS_KO;
+        }
+
+        glGenTextures(1, &mHandle);
+        assert(mHandle);
+        glBindTexture(GL_TEXTURE_2D, mHandle);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, getSize(), getSize(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        Log::trace(TAG, "Atlas of %u slots created (GL texture handle : %d)", getSlotCount(), mHandle);
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    Status TextureAtlas::upload(U32 slot, Image& image) {
+        assert(slot < getSlotCount());
+        if (mHandle == 0 || image.getPixels() == nullptr) {
+            return STATUS_KO;
+        }
+
+        U32 width = image.getWidth();
+        U32 height = image.getHeight();
+        GLint format = image.getFormat();
+        const BYTE* pixels = image.getPixels();
+        if (width != mSlotSize || height != mSlotSize || format != GL_RGBA) {
+            U32 bpp;
+            switch (format) {
+                case GL_LUMINANCE:          bpp = 1; break;
+                case GL_LUMINANCE_ALPHA:    bpp = 2; break;
+                case GL_RGB:                bpp = 3; break;
+                case GL_RGBA:               bpp = 4; break;
+                default:
+                    Log::error(TAG, "Unsupported image format %d", format);
+                    return STATUS_KO;
+            }
+            mScratch.resize(mSlotSize * mSlotSize * 4);
+            BYTE* dst = mScratch.data();
+            for (U32 y = 0; y < mSlotSize; ++y) {
+                const BYTE* row = pixels + (y * height / mSlotSize) * width * bpp;
+                for (U32 x = 0; x < mSlotSize; ++x, dst += 4) {
+                    const BYTE* src = row + (x * width / mSlotSize) * bpp;
+                    switch (bpp) {
+                        case 1:  dst[0] = dst[1] = dst[2] = src[0]; dst[3] = 255;    break;
+                        case 2:  dst[0] = dst[1] = dst[2] = src[0]; dst[3] = src[1]; break;
+                        case 3:  dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255; break;
+                        default: dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = src[3]; break;
+                    }
+                }
+            }
+            pixels = mScratch.data();
+        }
+
+        glBindTexture(GL_TEXTURE_2D, mHandle);
+        glTexSubImage2D(GL_TEXTURE_2D, 0,
+                        (slot % mSlotsPerRow) * mSlotSize,
+                        (slot / mSlotsPerRow) * mSlotSize,
+                        mSlotSize, mSlotSize,
+                        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    glm::vec4 TextureAtlas::getSlotRect(U32 slot) const {
+        F32 size = (F32) getSize();
+        F32 x = (F32) ((slot % mSlotsPerRow) * mSlotSize);
+        F32 y = (F32) ((slot / mSlotsPerRow) * mSlotSize);
+        return glm::vec4((x + 0.5f) / size,
+                         (y + 0.5f) / size,
+                         (x + mSlotSize - 0.5f) / size,
+                         (y + mSlotSize - 0.5f) / size);
+    }
+}
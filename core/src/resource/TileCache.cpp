@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "resource/TileCache.hpp"
+#include "utils/Log.hpp"
+
+
+constexpr auto TAG = "TileCache";
+
+namespace dma {
+
+    constexpr U64 TileCache::DEFAULT_BUDGET;
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    bool TileCache::isTileSid(const std::string& sid) {
+        return sid.compare(0, 6, "tiles/") == 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    TileCache::TileCache() :
+            mBudget(DEFAULT_BUDGET),
+            mStats({0, 0, 0, 0})
+    {}
+
+
+    //------------------------------------------------------------------------
+    TileCache::~TileCache() {}
+
+
+    //------------------------------------------------------------------------
+    void TileCache::add(const std::string& sid, U64 bytes, bool requested) {
+        remove(sid);
+        mLru.push_front(sid);
+        mEntries[sid] = {mLru.begin(), bytes, requested};
+        mStats.bytes += bytes;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool TileCache::touch(const std::string& sid) {
+        auto it = mEntries.find(sid);
+        if (it == mEntries.end()) {
+            return false;
+        }
+        mLru.splice(mLru.begin(), mLru, it->second.position);
+        if (it->second.requested) {
+            it->second.requested = false;
+        } else {
+            ++mStats.hits;
+        }
+        return true;
+    }
+
+
+    //------------------------------------------------------------------------
+    void TileCache::remove(const std::string& sid) {
+        auto it = mEntries.find(sid);
+        if (it != mEntries.end()) {
+            mStats.bytes -= it->second.bytes;
+            mLru.erase(it->second.position);
+            mEntries.erase(it);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void TileCache::clear() {
+        mLru.clear();
+        mEntries.clear();
+        mStats.bytes = 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    void TileCache::shrink(const std::function<bool(const std::string& sid)>& evict) {
+        auto it = mLru.end();
+        while (mStats.bytes > mBudget && it != mLru.begin()) {
+            --it;
+            if (evict(*it)) {
+                auto entry = mEntries.find(*it);
+                mStats.bytes -= entry->second.bytes;
+                ++mStats.evictions;
+                mEntries.erase(entry);
+                it = mLru.erase(it);
+            }
+        }
+        if (mStats.bytes > mBudget) {
+            Log::debug(TAG, "%llu bytes displayed, over the budget of %llu",
+                       (unsigned long long) mStats.bytes, (unsigned long long) mBudget);
+        }
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/TilePack.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+
+constexpr auto TAG = "TilePack";
+
+namespace dma {
+
+    constexpr U32 TilePack::VERSION;
+
+    static const char MAGIC[4] = {'D', 'M', 'A', 'T'};
+    static constexpr U32 HEADER_SIZE = 4 * sizeof(U32);
+
+    struct PackedFile {
+        U64 key;
+        std::string path;
+        U32 size;
+    };
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    /**
+     * @return the numeric entries of the directory, e.g. the z, x or y of the tiles.
+     */
+    static std::vector<std::pair<int, std::string>> listNumbered(const std::string& dir, const char* suffix) {
+        std::vector<std::pair<int, std::string>> entries;
+        DIR* handle = opendir(dir.c_str());
+        if (handle == nullptr) {
+            return entries;
+        }
+        size_t suffixLength = strlen(suffix);
+        struct dirent* entry;
+        while ((entry = readdir(handle)) != nullptr) {
+            std::string name = entry->d_name;
+            char* end;
+            long n = strtol(name.c_str(), &end, 10);
+            if (end != name.c_str() && n >= 0 && strcmp(end, suffix) == 0 && name.size() > suffixLength) {
+                entries.emplace_back((int) n, dir + name);
+            }
+        }
+        closedir(handle);
+        return entries;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    Status TilePack::write(const std::string& dir, const std::string& filename) {
+        std::string root = dir;
+        Utils::addTrailingSlash(root);
+
+        std::vector<PackedFile> files;
+        for (auto& z : listNumbered(root, "")) {
+            for (auto& x : listNumbered(z.second + "/", "")) {
+                for (auto& y : listNumbered(x.second + "/", ".png")) {
+                    struct stat info;
+                    if (stat(y.second.c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+                        files.push_back({key(x.first, y.first, z.first), y.second, (U32) info.st_size});
+                    }
+                }
+            }
+        }
+        std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+            return a.key < b.key;
+        });
+
+        U32 header[4];
+        memcpy(&header[0], MAGIC, 4);
+        header[1] = VERSION;
+        header[2] = (U32) files.size();
+        header[3] = 0;
+        std::vector<Entry> entries(files.size());
+        U64 offset = HEADER_SIZE + files.size() * sizeof(Entry);
+        for (size_t i = 0; i < files.size(); ++i) {
+            entries[i] = {files[i].key, offset, files[i].size, 0};
+            offset += files[i].size;
+        }
+
+        std::string tmp = filename + ".tmp";
+        FILE* file = fopen(tmp.c_str(), "wb");
+        if (file == nullptr) {
+            Log::error(TAG, "Unable to write %s", tmp.c_str());
+            return STATUS_KO;
+        }
+        bool ok = fwrite(header, sizeof(header), 1, file) == 1
+                  && (entries.empty() || fwrite(entries.data(), sizeof(Entry), entries.size(), file) == entries.size());
+        std::vector<BYTE> buffer;
+        for (size_t i = 0; ok && i < files.size(); ++i) {
+            buffer.resize(files[i].size);
+            FILE* tile = fopen(files[i].path.c_str(), "rb");
+            ok = tile != nullptr && fread(buffer.data(), 1, buffer.size(), tile) == buffer.size()
+                 && fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+            if (tile != nullptr) {
+                fclose(tile);
+            }
+            if (!ok) {
+                Log::error(TAG, "Unable to pack %s", files[i].path.c_str());
+            }
+        }
+        ok = fclose(file) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), filename.c_str()) != 0) {
+            Log::error(TAG, "Unable to write %s", filename.c_str());
+            remove(tmp.c_str());
+            return STATUS_KO;
+        }
+        Log::debug(TAG, "%u tiles packed into %s", (U32) files.size(), filename.c_str());
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    TilePack::TilePack() :
+            mData(nullptr),
+            mMappedSize(0),
+            mEntries(nullptr),
+            mCount(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    TilePack::~TilePack() {
+        close();
+    }
+
+
+    //------------------------------------------------------------------------
+    Status TilePack::open(const std::string& filename) {
+        close();
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Log::error(TAG, "Unable to open %s", filename.c_str());
+            return STATUS_KO;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t) info.st_size < HEADER_SIZE) {
+            ::close(fd);
+            Log::error(TAG, "Invalid tile pack %s", filename.c_str());
+            return STATUS_KO;
+        }
+        void* data = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            Log::error(TAG, "Unable to map %s", filename.c_str());
+            return STATUS_KO;
+        }
+        mData = (BYTE*) data;
+        mMappedSize = (size_t) info.st_size;
+
+        const U32* header = (const U32*) mData;
+        bool valid = memcmp(header, MAGIC, 4) == 0 && header[1] == VERSION
+                     && HEADER_SIZE + (size_t) header[2] * sizeof(Entry) <= mMappedSize;
+        const Entry* entries = (const Entry*) (mData + HEADER_SIZE);
+        for (U32 i = 0; valid && i < header[2]; ++i) {
+            valid = entries[i].offset + entries[i].size <= mMappedSize
+                    && (i == 0 || entries[i - 1].key < entries[i].key);
+        }
+        if (!valid) {
+            Log::error(TAG, "Invalid tile pack %s", filename.c_str());
+            close();
+            return STATUS_KO;
+        }
+        mEntries = entries;
+        mCount = header[2];
+        mFilename = filename;
+        return STATUS_OK;
+    }
+
+
+    //------------------------------------------------------------------------
+    void TilePack::close() {
+        if (mData != nullptr) {
+            munmap(mData, mMappedSize);
+            mData = nullptr;
+            mMappedSize = 0;
+            mEntries = nullptr;
+            mCount = 0;
+            mFilename.clear();
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    const BYTE* TilePack::find(int x, int y, int z, U32& size) const {
+        const Entry* entry = mFind(key(x, y, z));
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        size = entry->size;
+        return mData + entry->offset;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    const TilePack::Entry* TilePack::mFind(U64 key) const {
+        const Entry* end = mEntries + mCount;
+        const Entry* entry = std::lower_bound(mEntries, end, key, [](const Entry& e, U64 k) {
+            return e.key < k;
+        });
+        return entry != end && entry->key == key ? entry : nullptr;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "utils/GLExtensions.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+#include <cstring>
+
+
+constexpr auto TAG = "GLExtensions";
+
+namespace dma {
+
+    /* ================= STATIC VARIABLES ========================*/
+    PFNGLGENVERTEXARRAYSOESPROC GLExtensions::genVertexArrays = nullptr;
+    PFNGLBINDVERTEXARRAYOESPROC GLExtensions::bindVertexArray = nullptr;
+    PFNGLDELETEVERTEXARRAYSOESPROC GLExtensions::deleteVertexArrays = nullptr;
+    PFNGLDRAWELEMENTSINSTANCEDEXTPROC GLExtensions::drawElementsInstanced = nullptr;
+    PFNGLVERTEXATTRIBDIVISOREXTPROC GLExtensions::vertexAttribDivisor = nullptr;
+    bool GLExtensions::elementIndexUint = false;
+
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    template <typename T>
+    static inline T resolve(const char* name) {
+        return reinterpret_cast<T>(GLExtensions::getProcAddress(name));
+    }
+
+    //------------------------------------------------------------------------
+    static bool isCoreVersion(char esMajor, char desktopMajor) {
+        const char* version = (const char*) glGetString(GL_VERSION);
+        if (version == nullptr) {
+            return false;
+        }
+        if (std::strncmp(version, "OpenGL ES ", 10) == 0) {
+            return version[10] >= esMajor;
+        }
+        // desktop GL
+        return version[0] >= desktopMajor;
+    }
+
+    //------------------------------------------------------------------------
+    static bool isCoreVertexArrayObject() {
+        return isCoreVersion('3', '3') || GLUtils::isExtSupported("GL_ARB_vertex_array_object");
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    void GLExtensions::load() {
+        genVertexArrays = nullptr;
+        bindVertexArray = nullptr;
+        deleteVertexArrays = nullptr;
+
+        if (GLUtils::isExtSupported("GL_OES_vertex_array_object")) {
+            genVertexArrays = resolve<PFNGLGENVERTEXARRAYSOESPROC>("glGenVertexArraysOES");
+            bindVertexArray = resolve<PFNGLBINDVERTEXARRAYOESPROC>("glBindVertexArrayOES");
+            deleteVertexArrays = resolve<PFNGLDELETEVERTEXARRAYSOESPROC>("glDeleteVertexArraysOES");
+        } else if (isCoreVertexArrayObject()) {
+            genVertexArrays = resolve<PFNGLGENVERTEXARRAYSOESPROC>("glGenVertexArrays");
+            bindVertexArray = resolve<PFNGLBINDVERTEXARRAYOESPROC>("glBindVertexArray");
+            deleteVertexArrays = resolve<PFNGLDELETEVERTEXARRAYSOESPROC>("glDeleteVertexArrays");
+        }
+        Log::trace(TAG, "vertex array objects: %s", hasVertexArrayObject() ? "yes" : "no");
+
+        drawElementsInstanced = nullptr;
+        vertexAttribDivisor = nullptr;
+
+        if (GLUtils::isExtSupported("GL_EXT_instanced_arrays")) {
+            drawElementsInstanced = resolve<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>("glDrawElementsInstancedEXT");
+            vertexAttribDivisor = resolve<PFNGLVERTEXATTRIBDIVISOREXTPROC>("glVertexAttribDivisorEXT");
+        } else if (GLUtils::isExtSupported("GL_ANGLE_instanced_arrays")) {
+            drawElementsInstanced = resolve<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>("glDrawElementsInstancedANGLE");
+            vertexAttribDivisor = resolve<PFNGLVERTEXATTRIBDIVISOREXTPROC>("glVertexAttribDivisorANGLE");
+        } else if (isCoreVersion('3', '4') || GLUtils::isExtSupported("GL_ARB_instanced_arrays")) {
+            drawElementsInstanced = resolve<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>("glDrawElementsInstanced");
+            vertexAttribDivisor = resolve<PFNGLVERTEXATTRIBDIVISOREXTPROC>("glVertexAttribDivisor");
+        }
+        Log::trace(TAG, "instanced arrays: %s", hasInstancedArrays() ? "yes" : "no");
+
+        elementIndexUint = GLUtils::isExtSupported("GL_OES_element_index_uint") || isCoreVersion('3', '1');
+        Log::trace(TAG, "32-bit indices: %s", hasElementIndexUint() ? "yes" : "no");
+    }
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "utils/ObjParser.hpp"
+#include "utils/Log.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+constexpr auto TAG = "ObjParser";
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    static const F64 POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /**
+     * Cursor over the file content, never reading past end.
+     */
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        inline bool atEnd() const {
+            return p >= end;
+        }
+
+        inline void skipBlanks() {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                ++p;
+            }
+        }
+
+        inline void skipLine() {
+            const char* eol = (const char*) memchr(p, '\n', end - p);
+            p = eol != nullptr ? eol + 1 : end;
+        }
+
+        inline bool isDigit() const {
+            return p < end && *p >= '0' && *p <= '9';
+        }
+
+        /**
+         * [+-]digits[.digits][(e|E)[+-]digits], the first 19 significant digits kept.
+         */
+        bool parseFloat(F32& value) {
+            skipBlanks();
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                negative = *p++ == '-';
+            }
+            U64 mantissa = 0;
+            int digits = 0, exponent = 0;
+            bool any = false;
+            for (; isDigit(); ++p, any = true) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    digits += mantissa != 0;
+                } else {
+                    ++exponent;
+                }
+            }
+            if (p < end && *p == '.') {
+                for (++p; isDigit(); ++p, any = true) {
+                    if (digits < 19) {
+                        mantissa = mantissa * 10 + (*p - '0');
+                        digits += mantissa != 0;
+                        --exponent;
+                    }
+                }
+            }
+            if (!any) {
+                return false;
+            }
+            if (p < end && (*p == 'e' || *p == 'E')) {
+                ++p;
+                bool negativeExponent = false;
+                if (p < end && (*p == '-' || *p == '+')) {
+                    negativeExponent = *p++ == '-';
+                }
+                int e = 0;
+                for (; isDigit(); ++p) {
+                    e = e < 10000 ? e * 10 + (*p - '0') : e;
+                }
+                exponent += negativeExponent ? -e : e;
+            }
+            F64 v = (F64) mantissa;
+            while (exponent > 22) {
+                v *= 1e22;
+                exponent -= 22;
+            }
+            while (exponent < -22) {
+                v /= 1e22;
+                exponent += 22;
+            }
+            v = exponent >= 0 ? v * POW10[exponent] : v / POW10[-exponent];
+            value = (F32) (negative ? -v : v);
+            return true;
+        }
+
+        bool parseInt(I32& value) {
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                negative = *p++ == '-';
+            }
+            if (!isDigit()) {
+                return false;
+            }
+            I64 v = 0;
+            for (; isDigit(); ++p) {
+                v = v < 0x7FFFFFFF ? v * 10 + (*p - '0') : v;
+            }
+            value = (I32) (negative ? -v : v);
+            return true;
+        }
+    };
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Resolves a 1-based or negative OBJ index against the count of elements read so far.
+     * @return false if out of range
+     */
+    static inline bool resolve(I32 index, size_t count, U32& resolved) {
+        I64 i = index > 0 ? (I64) index - 1 : (I64) count + index;
+        if (index == 0 || i < 0 || i >= (I64) count || i >= VertexIndices::NONE) {
+            return false;
+        }
+        resolved = (U32) i;
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * p, p/uv, p//n or p/uv/n
+     */
+    static bool parseFaceVertex(Cursor& c, size_t positionCount, size_t uvCount, size_t normalCount,
+                                VertexIndices& vi) {
+        I32 index;
+        if (!c.parseInt(index) || !resolve(index, positionCount, vi.p)) {
+            return false;
+        }
+        vi.uv = vi.fn = VertexIndices::NONE;
+        if (c.p < c.end && *c.p == '/') {
+            ++c.p;
+            if (c.p < c.end && *c.p != '/') {
+                if (!c.parseInt(index) || !resolve(index, uvCount, vi.uv)) {
+                    return false;
+                }
+            }
+            if (c.p < c.end && *c.p == '/') {
+                ++c.p;
+                if (!c.parseInt(index) || !resolve(index, normalCount, vi.fn)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static inline bool startsWith(const Cursor& c, const char* keyword, size_t length) {
+        // the keyword, then a blank
+        return (size_t) (c.end - c.p) > length && memcmp(c.p, keyword, length) == 0
+               && (c.p[length] == ' ' || c.p[length] == '\t');
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    Status ObjParser::parseFile(const std::string& filename,
+                                std::vector<glm::vec3>& positions,
+                                std::vector<glm::vec2>& uvs,
+                                std::vector<glm::vec3>& normals,
+                                std::vector<VertexIndices>& vertexIndices) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Log::error(TAG, "Cannot open file %s", filename.c_str());
+            return STATUS_KO;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            Log::error(TAG, "Empty file %s", filename.c_str());
+            close(fd);
+            return STATUS_KO;
+        }
+        size_t size = (size_t) info.st_size;
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            Log::error(TAG, "Unable to map %s", filename.c_str());
+            return STATUS_KO;
+        }
+        Status status = parse((const char*) data, size, positions, uvs, normals, vertexIndices);
+        munmap(data, size);
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Invalid obj file %s", filename.c_str());
+        }
+        return status;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status ObjParser::parse(const char* data, size_t size,
+                            std::vector<glm::vec3>& positions,
+                            std::vector<glm::vec2>& uvs,
+                            std::vector<glm::vec3>& normals,
+                            std::vector<VertexIndices>& vertexIndices) {
+        // a few bytes per line: reserved from the size, trimmed by the caller if need be
+        positions.reserve(positions.size() + size / 64);
+        vertexIndices.reserve(vertexIndices.size() + size / 16);
+
+        Cursor c = {data, data + size};
+        while (!c.atEnd()) {
+            c.skipBlanks();
+            if (startsWith(c, "v", 1)) {
+                c.p += 1;
+                glm::vec3 v;
+                if (!c.parseFloat(v.x) || !c.parseFloat(v.y) || !c.parseFloat(v.z)) {
+                    return STATUS_KO;
+                }
+                positions.push_back(v);
+            } else if (startsWith(c, "vt", 2)) {
+                c.p += 2;
+                glm::vec2 uv;
+                if (!c.parseFloat(uv.x)) {
+                    return STATUS_KO;
+                }
+                uv.y = c.parseFloat(uv.y) ? uv.y : 0.0f;
+                uvs.push_back(uv);
+            } else if (startsWith(c, "vn", 2)) {
+                c.p += 2;
+                glm::vec3 n;
+                if (!c.parseFloat(n.x) || !c.parseFloat(n.y) || !c.parseFloat(n.z)) {
+                    return STATUS_KO;
+                }
+                normals.push_back(n);
+            } else if (startsWith(c, "f", 1)) {
+                c.p += 1;
+                // triangulated as a fan around the first vertex
+                VertexIndices first, previous, current;
+                int count = 0;
+                for (c.skipBlanks(); c.p < c.end && *c.p != '\n' && *c.p != '\r' && *c.p != '#'; c.skipBlanks()) {
+                    if (!parseFaceVertex(c, positions.size(), uvs.size(), normals.size(), current)) {
+                        return STATUS_KO;
+                    }
+                    if (count >= 2) {
+                        vertexIndices.push_back(first);
+                        vertexIndices.push_back(previous);
+                        vertexIndices.push_back(current);
+                    }
+                    if (count == 0) {
+                        first = current;
+                    }
+                    previous = current;
+                    ++count;
+                }
+                if (count < 3) {
+                    return STATUS_KO;
+                }
+            }
+            // comments, groups, materials...
+            c.skipLine();
+        }
+        return STATUS_OK;
+    }
+}
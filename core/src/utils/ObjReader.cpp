@@ -18,6 +18,7 @@
 
 #include "utils/ObjReader.hpp"
 #include "utils/Log.hpp"
+#include "utils/VertexIndices.hpp"
 
 #include <sstream>
 #include <cassert>
@@ -116,33 +117,33 @@ namespace dma {
      * f 2 2 1
      */
 
-    bool ObjReader::nextFace(U16 face[3][3]) {
+    bool ObjReader::nextFace(U32 face[3][3]) {
         std::string line;
         if(!getline(mInputStream, line)) return false;
         if(line.substr(0,2) != "f ") return false;
         std::istringstream s(line.substr(2));
         for(U32 i = 0; i < 3; ++i) {
-            U16 index;
+            U32 index;
             s >> index;
-            face[i][FACE_P] = (U16) (index - 1);
+            face[i][FACE_P] = index - 1;
             if(s.get() == '/') {
                 if(s.get() != '/') { // case uv, ie 1/2/2 or 1/2
                     s.unget();
                     s >> index;
-                    face[i][FACE_UV] = (U16) (index - 1);
+                    face[i][FACE_UV] = index - 1;
                 } else { //there is no uv.
                     s.unget();
-                    face[i][FACE_UV] = 0xFFFF; // means no uv since indices are one based.
+                    face[i][FACE_UV] = VertexIndices::NONE; // means no uv since indices are one based.
                 }
                 if(s.get() == '/') { //there are normals
                     s >> index;
-                    face[i][FACE_N] = (U16) (index - 1);
+                    face[i][FACE_N] = index - 1;
                 } else {
-                    face[i][FACE_N] = 0xFFFF; // no normal
+                    face[i][FACE_N] = VertexIndices::NONE; // no normal
                 }
             } else {
-                face[i][FACE_UV] = 0xFFFF; // means no uv since indices are one based.
-                face[i][FACE_N] = 0xFFFF; // no normal
+                face[i][FACE_UV] = VertexIndices::NONE; // means no uv since indices are one based.
+                face[i][FACE_N] = VertexIndices::NONE; // no normal
             }
         }
         return true;
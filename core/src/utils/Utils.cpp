@@ -47,6 +47,30 @@ namespace dma {
         else return (info.st_mode & S_IFDIR) != 0;
     }
 
+    //--------------------------------------------------------------------------------------
+    bool Utils::makeDirs(const std::string& path) {
+        for (size_t i = 1; i <= path.size(); ++i) {
+            if (i == path.size() || path[i] == '/') {
+                std::string dir = path.substr(0, i);
+                if (!dirExists(dir.c_str()) && mkdir(dir.c_str(), 0755) != 0 && !dirExists(dir.c_str())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    I64 Utils::getModificationTime(const std::string& path) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            return -1;
+        }
+        return (I64) info.st_mtime;
+    }
+
+
     //--------------------------------------------------------------------------------------
     bool Utils::fileExists(const std::string& path) {
         std::ifstream is;
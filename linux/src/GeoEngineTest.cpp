@@ -54,9 +54,9 @@ void testObjReader() {
 
 
     objReader.gotoFaces();
-    U16 face[3][3];
+    U32 face[3][3];
     while(objReader.nextFace(face)) {
-        Log::debug(LOG_TAG, "FACE: %d/%d/%d %d/%d/%d %d/%d/%d",
+        Log::debug(LOG_TAG, "FACE: %u/%u/%u %u/%u/%u %u/%u/%u",
                 face[0][0], face[0][1], face[0][2],
                 face[1][0], face[1][1], face[1][2],
                 face[2][0], face[2][1], face[2][2]);
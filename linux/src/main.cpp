@@ -20,6 +20,9 @@ without the express written permission of eBusiness Information.
 // dma
 #include "utils/ObjReader.hpp"
 #include "engine/geo/GeoEngine.hpp"
+#include "engine/geo/BackgroundTileProvider.hpp"
+#include "engine/geo/DirectoryTileSource.hpp"
+#include "engine/geo/PackTileSource.hpp"
 
 
 using namespace dma;
@@ -201,6 +204,18 @@ int main(int argc, char** argv) {
 
     mGeoEngine.getGeoSceneManager().setTileNamespace("test-ns");
 
+    // tiles of a z/x/y.png directory or of a pack, fetched natively
+    if (argc > 1) {
+        std::string source(argv[1]);
+        std::shared_ptr<ITileSource> tiles;
+        if (source.size() > 5 && source.compare(source.size() - 5, 5, ".pack") == 0) {
+            tiles = std::make_shared<PackTileSource>(source);
+        } else {
+            tiles = std::make_shared<DirectoryTileSource>(source);
+        }
+        mGeoEngine.setTileProvider(std::make_shared<BackgroundTileProvider>(mGeoEngine, "test-ns", tiles));
+    }
+
     // Replace the default camera with a FlyThrough camera
     mGeoEngine.getGeoSceneManager().getScene().setCamera(mFlyThroughCamera);
     mGeoEngine.getGeoSceneManager().placeCamera(LatLngAlt(45.784448, 4.854678, 5.0));
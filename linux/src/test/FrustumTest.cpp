@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <random>
+#include <vector>
+
+#include "cute.h"
+
+#include "rendering/Frustum.hpp"
+#include "UnitTests.hpp"
+
+using namespace dma;
+
+namespace {
+
+    struct Spheres {
+        std::vector<F32> x, y, z, r;
+
+        void push(F32 cx, F32 cy, F32 cz, F32 radius) {
+            x.push_back(cx);
+            y.push_back(cy);
+            z.push_back(cz);
+            r.push_back(radius);
+        }
+
+        U32 size() const { return (U32) x.size(); }
+    };
+
+    //------------------------------------------------------------------------
+    Frustum makeFrustum(const glm::vec3& p, const glm::vec3& d, const glm::vec3& up) {
+        Frustum frustum;
+        frustum.setPerspective(60.0f, 4.0f / 3.0f, 1.0f, 100.0f);
+        frustum.update(p, d, up);
+        return frustum;
+    }
+
+    //------------------------------------------------------------------------
+    /**
+     * Compares the batch results with the scalar ones, for all the counts
+     * up to the size of the arrays and from an unaligned start.
+     */
+    void assertSameAsScalar(const Frustum& frustum, const Spheres& spheres) {
+        const U32 count = spheres.size();
+        std::vector<U8> batch(count), scalar(count);
+        for (U32 first = 0; first < 2 && first < count; ++first) {
+            for (U32 n = 0; first + n <= count; n = n < 16 ? n + 1 : n * 2 + 3) {
+                std::fill(batch.begin(), batch.end(), 0xAA);
+                std::fill(scalar.begin(), scalar.end(), 0xAA);
+                frustum.containsSpheres(&spheres.x[first], &spheres.y[first], &spheres.z[first],
+                                        &spheres.r[first], n, &batch[first]);
+                frustum.containsSpheresScalar(&spheres.x[first], &spheres.y[first], &spheres.z[first],
+                                              &spheres.r[first], n, &scalar[first]);
+                ASSERT_EQUAL(scalar, batch);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testRandomSpheres() {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<F32> coord(-120.0f, 120.0f);
+    std::uniform_real_distribution<F32> radius(0.0f, 20.0f);
+    std::uniform_real_distribution<F32> direction(-1.0f, 1.0f);
+
+    for (int f = 0; f < 16; ++f) {
+        glm::vec3 d = glm::normalize(glm::vec3(direction(random), direction(random), direction(random)));
+        glm::vec3 up = glm::normalize(glm::cross(glm::cross(d, glm::vec3(0.0f, 1.0f, 0.0f)), d));
+        glm::vec3 p(coord(random), coord(random), coord(random));
+        Frustum frustum = makeFrustum(p * 0.1f, d, up);
+
+        Spheres spheres;
+        for (int i = 0; i < 1001; ++i) {
+            spheres.push(coord(random), coord(random), coord(random), radius(random));
+        }
+        assertSameAsScalar(frustum, spheres);
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testSpheresOnPlanes() {
+    // looking down -z from the origin: the near plane is z = -1, the far one z = -100
+    Frustum frustum = makeFrustum(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Spheres spheres;
+    spheres.push(0.0f, 0.0f, -1.0f, 0.0f);      // points on the planes
+    spheres.push(0.0f, 0.0f, -100.0f, 0.0f);
+    spheres.push(0.0f, 0.0f, -0.5f, 0.5f);      // touching them from outside
+    spheres.push(0.0f, 0.0f, -100.5f, 0.5f);
+    spheres.push(0.0f, 0.0f, -0.5f, 0.25f);     // just outside
+    spheres.push(0.0f, 0.0f, -100.5f, 0.25f);
+    spheres.push(0.0f, 0.0f, -50.0f, 0.0f);     // inside
+
+    std::vector<U8> expected = {1, 1, 1, 1, 0, 0, 1};
+    std::vector<U8> scalar(spheres.size()), batch(spheres.size());
+    frustum.containsSpheresScalar(spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.r.data(),
+                                  spheres.size(), scalar.data());
+    frustum.containsSpheres(spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.r.data(),
+                            spheres.size(), batch.data());
+    ASSERT_EQUAL(expected, scalar);
+    ASSERT_EQUAL(expected, batch);
+    assertSameAsScalar(frustum, spheres);
+}
+
+
+//------------------------------------------------------------------------
+cute::suite make_suite_FrustumTest() {
+    cute::suite s;
+    s.push_back(CUTE(testRandomSpheres));
+    s.push_back(CUTE(testSpheresOnPlanes));
+    return s;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "cute.h"
+
+#include "resource/Mesh.hpp"
+#include "resource/MeshFile.hpp"
+#include "resource/MeshManager.hpp"
+#include "UnitTests.hpp"
+
+using namespace dma;
+
+namespace {
+
+    // run from the repository root
+    const std::string OBJ_FILE = "assets-test/arpigl/mesh/cube.obj";
+    const std::string MESH_FILE = std::string(P_tmpdir) + "/arpigl-meshfile-test.mesh";
+
+    // word offsets in the file, see MeshFile
+    const U32 VERTEX_COUNT_WORD = 3;
+    const U32 ELEMENT_COUNT_WORD = 6;
+    const U32 FIRST_ELEMENT_WORD = 7;
+
+    //------------------------------------------------------------------------
+    /**
+     * The words of a mesh file converted from the test cube.
+     */
+    std::vector<U32> cubeWords() {
+        Mesh mesh;
+        ASSERT_EQUAL(STATUS_OK, MeshManager::buildFromObj(OBJ_FILE, mesh));
+        ASSERT_EQUAL(STATUS_OK, MeshFile::write(MESH_FILE, mesh));
+        std::vector<U32> words(64 * 1024);
+        FILE* file = fopen(MESH_FILE.c_str(), "rb");
+        ASSERT(file != nullptr);
+        words.resize(fread(words.data(), sizeof(U32), words.size(), file));
+        fclose(file);
+        return words;
+    }
+
+    //------------------------------------------------------------------------
+    Status readWords(const std::vector<U32>& words) {
+        FILE* file = fopen(MESH_FILE.c_str(), "wb");
+        ASSERT(file != nullptr);
+        fwrite(words.data(), sizeof(U32), words.size(), file);
+        fclose(file);
+        Mesh mesh;
+        Status status = MeshFile::read(MESH_FILE, mesh);
+        remove(MESH_FILE.c_str());
+        return status;
+    }
+
+    //------------------------------------------------------------------------
+    /**
+     * @return the word offset of the first index, 16-bit indices being 2 per word.
+     */
+    U32 firstIndexWord(const std::vector<U32>& words) {
+        U32 vertexWords = (words[2] * words[VERTEX_COUNT_WORD] + 3) / 4;
+        return FIRST_ELEMENT_WORD + words[ELEMENT_COUNT_WORD] * 4 + 4 + vertexWords;
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testReadConverted() {
+    ASSERT_EQUAL(STATUS_OK, readWords(cubeWords()));
+}
+
+
+//------------------------------------------------------------------------
+void testReadSizeOverflow() {
+    std::vector<U32> words = cubeWords();
+    // vertex size * vertex count wraps to a small 32-bit value
+    words[VERTEX_COUNT_WORD] = (U32) ((0x100000000ull + words[2]) / words[2]);
+    ASSERT_EQUAL(STATUS_KO, readWords(words));
+}
+
+
+//------------------------------------------------------------------------
+void testReadElementOutOfVertex() {
+    std::vector<U32> words = cubeWords();
+    words[FIRST_ELEMENT_WORD + 3] = words[2];   // offset
+    ASSERT_EQUAL(STATUS_KO, readWords(words));
+
+    words = cubeWords();
+    words[FIRST_ELEMENT_WORD + 1] = 5;          // count
+    ASSERT_EQUAL(STATUS_KO, readWords(words));
+
+    words = cubeWords();
+    words[FIRST_ELEMENT_WORD + 1] = 0;
+    ASSERT_EQUAL(STATUS_KO, readWords(words));
+}
+
+
+//------------------------------------------------------------------------
+void testReadIndexOutOfRange() {
+    std::vector<U32> words = cubeWords();
+    ASSERT_EQUAL(2u, words[5]);
+    U32 index = firstIndexWord(words);
+    words[index] = (words[index] & 0xFFFF0000u) | words[VERTEX_COUNT_WORD];
+    ASSERT_EQUAL(STATUS_KO, readWords(words));
+}
+
+
+//------------------------------------------------------------------------
+cute::suite make_suite_MeshFileTest() {
+    cute::suite s;
+    s.push_back(CUTE(testReadConverted));
+    s.push_back(CUTE(testReadSizeOverflow));
+    s.push_back(CUTE(testReadElementOutOfVertex));
+    s.push_back(CUTE(testReadIndexOutOfRange));
+    return s;
+}
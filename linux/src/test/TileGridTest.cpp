@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <random>
+#include <vector>
+
+#include "cute.h"
+
+#include "engine/geo/TileGrid.hpp"
+#include "UnitTests.hpp"
+
+using namespace dma::geo;
+
+namespace {
+
+    const int SIZE = 7;         // as in TileMap
+    const int OFFSET = SIZE / 2;
+    const int LOD_SIZE = 8;
+
+    //------------------------------------------------------------------------
+    /**
+     * The bounds of each level around tile (x0, y0), computed as TileMap::update() does.
+     */
+    std::vector<std::pair<TileGrid::Bounds, TileGrid::Bounds>> levelBounds(int x0, int y0, int levels) {
+        std::vector<std::pair<TileGrid::Bounds, TileGrid::Bounds>> bounds;
+        TileGrid::Bounds outer = {x0 - OFFSET, y0 - OFFSET, x0 + OFFSET, y0 + OFFSET};
+        TileGrid::Bounds hole = {0, 0, -1, -1};
+        for (int level = 0; level < levels; ++level) {
+            if (level > 0) {
+                hole = {outer.x0 >> 1, outer.y0 >> 1, outer.x1 >> 1, outer.y1 >> 1};
+                outer.x0 = (hole.x0 - LOD_SIZE / 4) & ~1;
+                outer.y0 = (hole.y0 - LOD_SIZE / 4) & ~1;
+                outer.x1 = outer.x0 + LOD_SIZE - 1;
+                outer.y1 = outer.y0 + LOD_SIZE - 1;
+            }
+            if (level + 1 < levels) {
+                outer.x0 &= ~1;
+                outer.y0 &= ~1;
+                outer.x1 |= 1;
+                outer.y1 |= 1;
+            }
+            bounds.push_back({outer, hole});
+        }
+        return bounds;
+    }
+
+    //------------------------------------------------------------------------
+    /**
+     * A level as TileMap keeps it: the tile on each cell, here its coordinates.
+     */
+    struct Model {
+        TileGrid grid;
+        std::vector<std::pair<int, int>> cells;
+        int releases, assigns;
+
+        explicit Model(int width) : cells(width * width, {0, 0}), releases(0), assigns(0) {
+            grid.reset(width);
+        }
+
+        void move(const TileGrid::Bounds& outer, const TileGrid::Bounds& hole) {
+            const int width = grid.getWidth();
+            std::vector<bool> used(cells.size());
+            for (size_t i = 0; i < cells.size(); ++i) {
+                used[i] = grid.contains(cells[i].first, cells[i].second)
+                          && grid.cellIndex(cells[i].first, cells[i].second) == (int) i;
+            }
+            bool assigning = false;
+            releases = assigns = 0;
+            grid.move(outer, hole, [&](int x, int y) {
+                ASSERTM("released after an assignment", !assigning);
+                std::pair<int, int>& cell = cells[grid.cellIndex(x, y)];
+                ASSERTM("released a tile not on its cell", used[grid.cellIndex(x, y)] && cell == std::make_pair(x, y));
+                used[grid.cellIndex(x, y)] = false;
+                ++releases;
+            }, [&](int x, int y) {
+                assigning = true;
+                ASSERTM("assigned a tile outside of the level", grid.contains(x, y));
+                ASSERTM("assigned an occupied cell", !used[grid.cellIndex(x, y)]);
+                cells[grid.cellIndex(x, y)] = {x, y};
+                used[grid.cellIndex(x, y)] = true;
+                ++assigns;
+            });
+
+            // every tile of the level is on its cell, and no other
+            int count = 0;
+            for (int x = outer.x0; x <= outer.x1; ++x) {
+                for (int y = outer.y0; y <= outer.y1; ++y) {
+                    if (!hole.contains(x, y)) {
+                        ASSERTM("tile missing from its cell", cells[grid.cellIndex(x, y)] == std::make_pair(x, y));
+                        ++count;
+                    }
+                }
+            }
+            int usedCount = 0;
+            for (size_t i = 0; i < used.size(); ++i) {
+                usedCount += used[i] ? 1 : 0;
+            }
+            ASSERT_EQUAL(count, usedCount);
+            ASSERT(count <= width * width);
+        }
+    };
+
+    //------------------------------------------------------------------------
+    /**
+     * Moves the levels along a random walk with jumps, checking them after each move.
+     */
+    void walk(int levels, int steps, unsigned seed) {
+        std::vector<Model> models;
+        for (int level = 0; level < levels; ++level) {
+            models.emplace_back(level > 0 ? LOD_SIZE : (levels == 1 ? SIZE : SIZE + 1));
+        }
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> step(-1, 1);
+        std::uniform_int_distribution<int> jump(-40, 40);
+        int x = 270000, y = 180000;
+        for (int i = 0; i < steps; ++i) {
+            bool jumped = i % 97 == 0;
+            int dx = jumped ? jump(random) : step(random);
+            int dy = jumped ? jump(random) : step(random);
+            x += dx;
+            y += dy;
+            auto bounds = levelBounds(x, y, levels);
+            for (int level = 0; level < levels; ++level) {
+                Model& model = models[level];
+                TileGrid::Bounds oldOuter = model.grid.getOuter();
+                TileGrid::Bounds oldHole = model.grid.getHole();
+                model.move(bounds[level].first, bounds[level].second);
+                if (bounds[level].first.overlaps(oldOuter)) {
+                    // only the tiles leaving the level are released
+                    int leaving = 0;
+                    for (int tx = oldOuter.x0; tx <= oldOuter.x1; ++tx) {
+                        for (int ty = oldOuter.y0; ty <= oldOuter.y1; ++ty) {
+                            leaving += !oldHole.contains(tx, ty) && !model.grid.contains(tx, ty) ? 1 : 0;
+                        }
+                    }
+                    ASSERT_EQUALM("tiles released", leaving, model.releases);
+                }
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testGridSingleLevel() {
+    walk(1, 2000, 1);
+}
+
+
+//------------------------------------------------------------------------
+void testGridLodLevels() {
+    for (int levels = 2; levels <= 4; ++levels) {
+        walk(levels, 2000, (unsigned) levels);
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testGridStill() {
+    Model model(SIZE);
+    auto bounds = levelBounds(1000, 1000, 1);
+    model.move(bounds[0].first, bounds[0].second);
+    ASSERT_EQUAL(SIZE * SIZE, model.assigns);
+    model.move(bounds[0].first, bounds[0].second);
+    ASSERT_EQUAL(0, model.releases);
+    ASSERT_EQUAL(0, model.assigns);
+}
+
+
+//------------------------------------------------------------------------
+cute::suite make_suite_TileGridTest() {
+    cute::suite s;
+    s.push_back(CUTE(testGridSingleLevel));
+    s.push_back(CUTE(testGridLodLevels));
+    s.push_back(CUTE(testGridStill));
+    return s;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cute.h"
+
+#include "engine/Engine.hpp"
+#include "engine/geo/GeoSceneManager.hpp"
+#include "resource/MapManager.hpp"
+#include "UnitTests.hpp"
+
+using namespace dma;
+
+namespace {
+
+    // run from the repository root
+    const std::string MAP_DIR = "android/app/src/main/assets/arpigl/texture";
+    const U32 TILE_COUNT = 8;
+    const U32 TILE_BYTES = 256 * 256 * 4;   // decoded size of the RGBA tiles
+    const U32 DECODE_MILLIS = 1000;         // generous, for all the tiles to be decoded
+    const std::string ROOT_DIR = "android/app/src/main/assets/arpigl";
+    const F64 MAP_MILLIS = 1.5;             // upload time of a map, on the fake clock
+
+    //------------------------------------------------------------------------
+    std::string tileSid(U32 i) {
+        return "tiles/offline-demo/19/" + std::to_string(265485 + i / 5) + "/" + std::to_string(180359 + i % 5);
+    }
+
+    //------------------------------------------------------------------------
+    /**
+     * Requests all the tiles, waits for them to be decoded, then uploads
+     * them within the budget.
+     * @return the number of maps uploaded by each call of uploadDecoded()
+     */
+    std::vector<U32> uploadAll(U32 maxBytes, F32 maxMillis) {
+        // image only: nothing goes through GL
+        MapManager mapManager(MAP_DIR);
+        mapManager.setTileTexturesEnabled(false);
+        mapManager.setUploadBudget(maxBytes, maxMillis);
+        for (U32 i = 0; i < TILE_COUNT; ++i) {
+            mapManager.requestAsync(tileSid(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(DECODE_MILLIS));
+
+        std::vector<U32> counts;
+        std::vector<std::string> uploaded;
+        U32 total = 0;
+        while (total < TILE_COUNT && counts.size() <= TILE_COUNT) {
+            uploaded.clear();
+            mapManager.uploadDecoded(uploaded);
+            counts.push_back((U32) uploaded.size());
+            total += (U32) uploaded.size();
+        }
+        for (U32 i = 0; i < TILE_COUNT; ++i) {
+            ASSERTM(tileSid(i) + " not loaded", mapManager.isLoaded(tileSid(i)));
+        }
+        return counts;
+    }
+}
+
+
+//------------------------------------------------------------------------
+void testUploadByteBudget() {
+    // stops once the budget is reached, the last map possibly exceeding it
+    std::vector<U32> expected = {3, 3, 2};
+    ASSERT_EQUAL(expected, uploadAll(3 * TILE_BYTES, 1000.0f));
+    expected = {2, 2, 2, 2};
+    ASSERT_EQUAL(expected, uploadAll(TILE_BYTES + 1, 1000.0f));
+}
+
+
+//------------------------------------------------------------------------
+void testUploadAtLeastOne() {
+    // a budget smaller than a map still lets one through per call
+    std::vector<U32> expected(TILE_COUNT, 1);
+    ASSERT_EQUAL(expected, uploadAll(1, 1000.0f));
+    ASSERT_EQUAL(expected, uploadAll(64 * TILE_BYTES, 0.0f));
+}
+
+
+//------------------------------------------------------------------------
+void testUploadNothingReady() {
+    MapManager mapManager(MAP_DIR);
+    std::vector<std::string> uploaded;
+    mapManager.uploadDecoded(uploaded);
+    ASSERT(uploaded.empty());
+}
+
+
+//------------------------------------------------------------------------
+void testStepTimeBudget() {
+    // on the steady clock, the bound would depend on the machine load:
+    // the clock is faked instead, read once per map uploaded
+    const F32 budget = 4.0f;
+    Engine engine(ROOT_DIR);
+    ResourceManager& resourceManager = engine.getResourceManager();
+    resourceManager.setTileTexturesEnabled(false);
+    resourceManager.setMapUploadBudget(64 * TILE_BYTES, budget);
+    std::vector<F64> reads;
+    resourceManager.setMapUploadClock([&reads]() {
+        reads.push_back(reads.empty() ? 0.0 : reads.back() + MAP_MILLIS);
+        return reads.back();
+    });
+    geo::GeoSceneManager geoSceneManager(engine.getScene(), resourceManager);
+    for (U32 i = 0; i < TILE_COUNT; ++i) {
+        resourceManager.requestMap(tileSid(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(DECODE_MILLIS));
+
+    std::vector<U32> counts;
+    U32 total = 0;
+    while (total < TILE_COUNT && counts.size() <= TILE_COUNT) {
+        reads.clear();
+        geoSceneManager.step();
+        ASSERTM("step exceeded its time budget by more than a map",
+                reads.back() - reads.front() <= budget + MAP_MILLIS);
+        U32 count = 0;
+        for (U32 i = 0; i < TILE_COUNT; ++i) {
+            count += resourceManager.isMapLoaded(tileSid(i)) ? 1 : 0;
+        }
+        counts.push_back(count - total);
+        total = count;
+    }
+    // the third map starts at 3 ms, the fourth would start at 4.5 ms
+    std::vector<U32> expected = {3, 3, 2};
+    ASSERT_EQUAL(expected, counts);
+}
+
+
+//------------------------------------------------------------------------
+cute::suite make_suite_TileUploadTest() {
+    cute::suite s;
+    s.push_back(CUTE(testUploadByteBudget));
+    s.push_back(CUTE(testUploadAtLeastOne));
+    s.push_back(CUTE(testUploadNothingReady));
+    s.push_back(CUTE(testStepTimeBudget));
+    return s;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Runs the unit test suites.
+ *
+ * usage: arpigl-unit-test [test or suite name...]
+ */
+
+#include "cute.h"
+#include "ide_listener.h"
+#include "cute_runner.h"
+
+#include "UnitTests.hpp"
+
+
+int main(int argc, const char** argv) {
+    cute::ide_listener<> listener;
+    auto runner = cute::makeRunner(listener, argc, argv);
+
+    bool success = runner(make_suite_FrustumTest(), "FrustumTest");
+    success = runner(make_suite_MeshFileTest(), "MeshFileTest") && success;
+    success = runner(make_suite_TileGridTest(), "TileGridTest") && success;
+    success = runner(make_suite_TileUploadTest(), "TileUploadTest") && success;
+    return success ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_UNITTESTS_HPP_
+#define _DMA_UNITTESTS_HPP_
+
+#include "cute_suite.h"
+
+/*
+ * Suites of the unit tests, which need no GL context.
+ * Each one lives in its own file, and is run from the repository root.
+ */
+
+cute::suite make_suite_FrustumTest();
+cute::suite make_suite_MeshFileTest();
+cute::suite make_suite_TileGridTest();
+cute::suite make_suite_TileUploadTest();
+
+#endif //_DMA_UNITTESTS_HPP_
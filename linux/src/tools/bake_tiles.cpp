@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Pre-bakes a tile directory (tiles/<ns>/z/x/y.png) into the raw images
+ * mapped at runtime, see GeoEngine::setDecodedTileDir.
+ *
+ * usage: arpigl-bake-tiles <map dir> <decoded tile dir>
+ * e.g.   arpigl-bake-tiles assets/textures /sdcard/arpigl/decoded
+ */
+
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+
+#include "resource/Image.hpp"
+#include "resource/RawImage.hpp"
+#include "utils/Utils.hpp"
+
+using namespace dma;
+
+#define TAG "BakeTiles"
+
+struct Counts {
+    U32 baked;
+    U32 upToDate;
+    U32 failed;
+};
+
+
+//------------------------------------------------------------------------
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+
+//------------------------------------------------------------------------
+static void bake(const std::string& mapDir, const std::string& outDir, const std::string& path, Counts& counts) {
+    DIR* dir = opendir((mapDir + path).c_str());
+    if (dir == nullptr) {
+        fprintf(stderr, "Unable to open %s\n", (mapDir + path).c_str());
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        std::string child = path + name;
+        if (Utils::dirExists((mapDir + child).c_str())) {
+            bake(mapDir, outDir, child + "/", counts);
+            continue;
+        }
+        if (!endsWith(name, ".png") && !endsWith(name, ".PNG")) {
+            continue;
+        }
+        std::string source = mapDir + child;
+        std::string raw = outDir + child.substr(0, child.size() - 4) + ".raw";
+        if (RawImage::isUpToDate(raw, source)) {
+            ++counts.upToDate;
+            continue;
+        }
+        Image image;
+        if (image.loadAsPNG(source) != STATUS_OK || RawImage::write(raw, image) != STATUS_OK) {
+            fprintf(stderr, "Unable to bake %s\n", source.c_str());
+            ++counts.failed;
+            continue;
+        }
+        ++counts.baked;
+    }
+    closedir(dir);
+}
+
+
+//------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <map dir> <decoded tile dir>\n", argv[0]);
+        return 1;
+    }
+    std::string mapDir = argv[1];
+    std::string outDir = argv[2];
+    Utils::addTrailingSlash(mapDir);
+    Utils::addTrailingSlash(outDir);
+    if (!Utils::dirExists((mapDir + "tiles").c_str())) {
+        fprintf(stderr, "No tiles directory in %s\n", mapDir.c_str());
+        return 1;
+    }
+
+    // same layout as the sids, tiles/<ns>/z/x/y
+    Counts counts = {0, 0, 0};
+    bake(mapDir, outDir, "tiles/", counts);
+    printf("%u baked, %u up to date, %u failed\n", counts.baked, counts.upToDate, counts.failed);
+    return counts.failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Converts the OBJ files of a mesh directory into the binary mesh files
+ * read instead of them at runtime, see MeshFile.
+ *
+ * usage: arpigl-convert-meshes [--packed] <mesh dir>
+ * e.g.   arpigl-convert-meshes assets/arpigl/mesh
+ *
+ * --packed stores the vertices with integer types, see MeshManager::setPackedVertices.
+ */
+
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+
+#include "resource/MeshFile.hpp"
+#include "resource/MeshManager.hpp"
+#include "utils/Utils.hpp"
+
+using namespace dma;
+
+#define TAG "ConvertMeshes"
+
+
+//------------------------------------------------------------------------
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+
+//------------------------------------------------------------------------
+static bool isPacked(const Mesh& mesh) {
+    return mesh.hasVertexElement(VertexElement::Semantic::POSITION)
+           && mesh.getVertexElement(VertexElement::Semantic::POSITION).isNormalized();
+}
+
+
+//------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    bool packed = argc == 3 && std::string(argv[1]) == "--packed";
+    if (argc != 2 && !packed) {
+        fprintf(stderr, "usage: %s [--packed] <mesh dir>\n", argv[0]);
+        return 1;
+    }
+    std::string meshDir = argv[argc - 1];
+    Utils::addTrailingSlash(meshDir);
+    DIR* dir = opendir(meshDir.c_str());
+    if (dir == nullptr) {
+        fprintf(stderr, "Unable to open %s\n", meshDir.c_str());
+        return 1;
+    }
+
+    U32 converted = 0, upToDate = 0, failed = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (!endsWith(name, ".obj")) {
+            continue;
+        }
+        std::string source = meshDir + name;
+        std::string target = meshDir + name.substr(0, name.size() - 4) + ".mesh";
+        if (MeshFile::isUpToDate(target, source)) {
+            // converted with the other layout otherwise
+            Mesh current;
+            if (MeshFile::read(target, current) == STATUS_OK && isPacked(current) == packed) {
+                ++upToDate;
+                continue;
+            }
+        }
+        Mesh mesh;
+        if (MeshManager::buildFromObj(source, mesh, MeshManager::DEFAULT_SMOOTHING_ANGLE, packed) != STATUS_OK || MeshFile::write(target, mesh) != STATUS_OK) {
+            fprintf(stderr, "Unable to convert %s\n", source.c_str());
+            ++failed;
+            continue;
+        }
+        printf("%s: %u vertices of %u bytes, %u indices\n", name.c_str(), mesh.getVertexCount(),
+               mesh.getVertexSize(), mesh.getIndexCount());
+        ++converted;
+    }
+    closedir(dir);
+    printf("%u converted, %u up to date, %u failed\n", converted, upToDate, failed);
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Times the loading of the OBJ files of a mesh directory: their parsing by
+ * ObjReader and by ObjParser, then their loading into vertex & index data,
+ * built from the OBJ file then read from its binary mesh file.
+ * Uploads are not timed, no GL context being needed.
+ *
+ * usage: arpigl-mesh-bench <mesh dir> [runs]
+ * e.g.   arpigl-mesh-bench assets-test/arpigl/mesh 20
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <functional>
+#include <string>
+
+#include "resource/MeshFile.hpp"
+#include "resource/MeshManager.hpp"
+#include "utils/ObjParser.hpp"
+#include "utils/ObjReader.hpp"
+#include "utils/Utils.hpp"
+
+using namespace dma;
+
+#define TAG "MeshBench"
+
+
+//------------------------------------------------------------------------
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+
+//------------------------------------------------------------------------
+static Status readObj(const std::string& filename) {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<VertexIndices> vertexIndices;
+    ObjReader objReader(filename);
+    glm::vec3 v;
+    glm::vec2 uv;
+    U32 f[3][3];
+    objReader.gotoPositions();
+    while (objReader.nextPosition(v)) {
+        positions.push_back(v);
+    }
+    objReader.gotoUV();
+    while (objReader.nextUV(uv)) {
+        uvs.push_back(uv);
+    }
+    objReader.gotoNormals();
+    while (objReader.nextNormal(v)) {
+        normals.push_back(v);
+    }
+    objReader.gotoFaces();
+    while (objReader.nextFace(f)) {
+        for (int i = 0; i < 3; ++i) {
+            vertexIndices.push_back(VertexIndices(f[i][ObjReader::FACE_P], f[i][ObjReader::FACE_UV],
+                                                  f[i][ObjReader::FACE_N]));
+        }
+    }
+    return positions.empty() ? STATUS_KO : STATUS_OK;
+}
+
+
+//------------------------------------------------------------------------
+static Status parseObj(const std::string& filename) {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<VertexIndices> vertexIndices;
+    return ObjParser::parseFile(filename, positions, uvs, normals, vertexIndices);
+}
+
+
+//------------------------------------------------------------------------
+static double bench(int runs, const std::function<Status()>& parse) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        if (parse() != STATUS_OK) {
+            return -1.0;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runs;
+}
+
+
+//------------------------------------------------------------------------
+static double bench(int runs, const std::function<Status(Mesh&)>& load) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        Mesh mesh;
+        if (load(mesh) != STATUS_OK) {
+            return -1.0;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runs;
+}
+
+
+//------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <mesh dir> [runs]\n", argv[0]);
+        return 1;
+    }
+    std::string meshDir = argv[1];
+    Utils::addTrailingSlash(meshDir);
+    int runs = argc > 2 ? atoi(argv[2]) : 10;
+    DIR* dir = opendir(meshDir.c_str());
+    if (dir == nullptr) {
+        fprintf(stderr, "Unable to open %s\n", meshDir.c_str());
+        return 1;
+    }
+
+    // in ms per load
+    const std::string binary = "/tmp/arpigl-mesh-bench.mesh";
+    printf("%-24s %10s %12s %12s %12s %12s\n", "mesh", "vertices", "ObjReader", "ObjParser", "from obj", "from mesh");
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (!endsWith(name, ".obj")) {
+            continue;
+        }
+        std::string source = meshDir + name;
+        Mesh mesh;
+        if (MeshManager::buildFromObj(source, mesh) != STATUS_OK || MeshFile::write(binary, mesh) != STATUS_OK) {
+            fprintf(stderr, "Unable to convert %s\n", source.c_str());
+            continue;
+        }
+        double reader = bench(runs, [&source]() { return readObj(source); });
+        double parser = bench(runs, [&source]() { return parseObj(source); });
+        double obj = bench(runs, [&source](Mesh& m) { return MeshManager::buildFromObj(source, m); });
+        double bin = bench(runs, [&binary](Mesh& m) { return MeshFile::read(binary, m); });
+        printf("%-24s %10u %12.3f %12.3f %12.3f %12.3f\n", name.c_str(), mesh.getVertexCount(),
+               reader, parser, obj, bin);
+    }
+    closedir(dir);
+    remove(binary.c_str());
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Packs a tile namespace directory (z/x/y.png) into a single tile pack,
+ * served by a TilePackProvider.
+ *
+ * usage: arpigl-pack-tiles <tile namespace dir> <pack file>
+ * e.g.   arpigl-pack-tiles assets/textures/tiles/osm osm.pack
+ */
+
+#include <cstdio>
+
+#include "resource/TilePack.hpp"
+
+using namespace dma;
+
+
+//------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <tile namespace dir> <pack file>\n", argv[0]);
+        return 1;
+    }
+    if (TilePack::write(argv[1], argv[2]) != STATUS_OK) {
+        return 2;
+    }
+
+    // checks the written pack
+    TilePack pack;
+    if (pack.open(argv[2]) != STATUS_OK) {
+        return 2;
+    }
+    printf("%u tiles packed\n", pack.getTileCount());
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Times TileMap::update() for a camera moving one tile per update,
+ * straight then diagonally. Tile maps are looked up in the resource
+ * directory as for a real run, so that its content matters.
+ *
+ * usage: arpigl-tilemap-bench [resource dir] [lod levels] [updates]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#define GLFW_INCLUDE_ES2
+#include <GLFW/glfw3.h>
+
+#include "engine/geo/GeoEngine.hpp"
+#include "utils/Log.hpp"
+
+using namespace dma;
+using namespace dma::geo;
+
+#define TAG "TileMapBench"
+
+
+//------------------------------------------------------------------------
+static double bench(TileMap& tileMap, int dx, int dy, int updates) {
+    // far from the previous run, for the first update to rebuild the map
+    static int x = 270000, y = 180000;
+    x += 1000;
+    y += 1000;
+    tileMap.update(x, y);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i) {
+        x += dx;
+        y += dy;
+        tileMap.update(x, y);
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / updates;
+}
+
+
+//------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    const char* dir = argc > 1 ? argv[1] : "assets-test/arpigl";
+    int lodLevels = argc > 2 ? atoi(argv[2]) : 1;
+    int updates = argc > 3 ? atoi(argv[3]) : 10000;
+
+    if (!glfwInit()) {
+        Log::error(TAG, "Failed to initialize GLFW");
+        return 1;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "arpigl-tilemap-bench", NULL, NULL);
+    if (!window) {
+        Log::error(TAG, "Failed to create window");
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+
+    {
+        GeoEngine engine(dir);
+        engine.setTileLodLevels(lodLevels);
+        if (!engine.init()) {
+            Log::error(TAG, "error while initializing engine...");
+            return 1;
+        }
+        TileMap& tileMap = engine.getGeoSceneManager().getTileMap();
+
+        printf("%d lod levels, %d updates\n", tileMap.getLodLevels(), updates);
+        printf("straight: %8.2f us/update\n", bench(tileMap, 1, 0, updates));
+        printf("diagonal: %8.2f us/update\n", bench(tileMap, 1, 1, updates));
+        engine.unload();
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
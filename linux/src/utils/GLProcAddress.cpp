@@ -0,0 +1,22 @@
+/*
+Copyright © 2015 by eBusiness Information
+All rights reserved. This source code or any portion thereof
+may not be reproduced or used in any manner whatsoever
+without the express written permission of eBusiness Information.
+*/
+
+#include "utils/GLExtensions.hpp"
+
+#define GLFW_INCLUDE_ES2
+#include <GLFW/glfw3.h>
+
+/*
+ * The linux implementation of GLExtensions::getProcAddress
+ */
+
+namespace dma {
+
+    void* GLExtensions::getProcAddress(const char* name) {
+        return (void*) glfwGetProcAddress(name);
+    }
+}